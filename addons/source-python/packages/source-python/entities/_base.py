@@ -10,8 +10,6 @@
 from collections import defaultdict
 #   Inspect
 from inspect import signature
-#   WeakRef
-from weakref import WeakSet
 
 # Source.Python Imports
 #   Core
@@ -68,6 +66,7 @@ from studio.constants import INVALID_ATTACHMENT_INDEX
 # Source.Python Imports
 #   Entities
 from _entities._entity import BaseEntity
+from _entities._entity import EntityCache
 
 
 # =============================================================================
@@ -82,9 +81,6 @@ _entity_delays = defaultdict(set)
 # Get a dictionary to store the repeats
 _entity_repeats = defaultdict(set)
 
-# Get a set to store the registered entity classes
-_entity_classes = WeakSet()
-
 
 # =============================================================================
 # >> CLASSES
@@ -94,8 +90,10 @@ class _EntityCaching(BoostPythonClass):
 
     def __init__(cls, classname, bases, attributes):
         """Initializes the class."""
-        # New instances of this class will be cached in that dictionary
-        cls._cache = {}
+        # New instances of this class will be cached in that mapping. It is
+        # shared with the native code and invalidated when entities are
+        # deleted.
+        cls._cache = EntityCache()
 
         # Set whether or not this class is caching its instances by default
         try:
@@ -107,9 +105,6 @@ class _EntityCaching(BoostPythonClass):
         except KeyError:
             cls._caching = bool(vars(cls).get('caching', False))
 
-        # Add the class to the registered classes
-        _entity_classes.add(cls)
-
     def __call__(cls, index, caching=None):
         """Called when a new instance of this class is requested.
 
@@ -186,7 +181,7 @@ class _EntityCaching(BoostPythonClass):
     def cache(cls):
         """Returns the cached instances of this class.
 
-        :rtype: dict
+        :rtype: EntityCache
         """
         return cls._cache
 
@@ -205,7 +200,7 @@ class Entity(BaseEntity, Pointer, metaclass=_EntityCaching):
     4. :attr:`keyvalues`
 
     :var cache:
-        A read-only attribute that returns a dictionary containing the cached
+        A read-only attribute that returns a mapping containing the cached
         instances of this class.
 
         .. note::
@@ -596,6 +591,34 @@ class Entity(BaseEntity, Pointer, metaclass=_EntityCaching):
         """
         self.get_input(name)(*args, **kwargs)
 
+    def set_network_properties(self, values):
+        """Set the values of multiple properties at once.
+
+        All networked properties are notified in a single change info entry,
+        so the engine only compares these properties for the next snapshot.
+
+        :param dict values:
+            A dictionary of property names and the values to set.
+        :raise ValueError:
+            Raised if one of the properties wasn't found.
+        """
+        offsets = []
+        properties = self.properties
+        for name, value in values.items():
+            try:
+                prop = properties[name]
+            except KeyError:
+                raise ValueError(
+                    'Unable to find property "{}".'.format(name)) from None
+
+            prop.instance.__set__(self, value)
+
+            if prop.networked:
+                offsets.append(prop.offset)
+
+        if offsets:
+            self.network_state_changed(offsets)
+
     def emit_sound(
             self, sample, recipients=(), volume=VOL_NORM,
             attenuation=Attenuation.NONE, channel=Channel.AUTO,
@@ -869,7 +892,3 @@ def _on_networked_entity_deleted(index):
         # Stop the repeat if running
         if repeat.status is RepeatStatus.RUNNING:
             repeat.stop()
-
-    # Invalidate the internal entity caches for this entity
-    for cls in _entity_classes:
-        cls.cache.pop(index, None)
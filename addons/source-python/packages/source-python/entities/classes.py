@@ -28,7 +28,6 @@ from entities.datamaps import EntityProperty
 from entities.datamaps import FieldType
 from entities.datamaps import InputFunction
 from entities.datamaps import TypeDescriptionFlags
-from entities.helpers import edict_from_pointer
 from entities.helpers import baseentity_from_pointer
 from entities.props import SendPropFlags
 from entities.props import SendPropType
@@ -542,15 +541,17 @@ class _ServerClasses(TypeManager):
     @staticmethod
     def keyvalue(name, type_name):
         """Entity keyvalue."""
+        # Resolve the accessors once, instead of on every access
+        getter = getattr(BaseEntity, 'get_key_value_' + type_name)
+        setter = getattr(BaseEntity, 'set_key_value_' + type_name)
+
         def fget(pointer):
             """Retrieve the keyvalue for the entity."""
-            return getattr(baseentity_from_pointer(
-                pointer), 'get_key_value_' + type_name)(name)
+            return getter(baseentity_from_pointer(pointer), name)
 
         def fset(pointer, value):
             """Set the keyvalue for the entity to the given value."""
-            getattr(baseentity_from_pointer(
-                pointer), 'set_key_value_' + type_name)(name, value)
+            setter(baseentity_from_pointer(pointer), name, value)
 
         return property(fget, fset)
 
@@ -622,7 +623,7 @@ class _ServerClasses(TypeManager):
             if networked:
 
                 # Notify the change of state
-                edict_from_pointer(ptr).state_changed()
+                baseentity_from_pointer(ptr).network_state_changed(offset)
 
         return property(fget, fset)
 
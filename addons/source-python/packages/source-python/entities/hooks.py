@@ -21,10 +21,21 @@ from entities.entity import Entity
 from players.entity import Player
 
 
+# =============================================================================
+# >> FORWARD IMPORTS
+# =============================================================================
+# Source.Python Imports
+#   Entities
+from _entities._hooks import EntityHookFilter
+from _entities._hooks import EntityHookFlags
+
+
 # =============================================================================
 # >> ALL DECLARATION
 # =============================================================================
 __all__ = ('EntityCondition',
+           'EntityHookFilter',
+           'EntityHookFlags',
            'EntityPostHook',
            'EntityPreHook',
            )
@@ -92,7 +103,7 @@ class EntityCondition(object):
 class _EntityHook(AutoUnload):
     """Create entity pre and post hooks that auto unload."""
 
-    def __init__(self, test_function, function):
+    def __init__(self, test_function, function, filter=None):
         """Initialize the hook object.
 
         :param callable test_function:
@@ -103,9 +114,14 @@ class _EntityHook(AutoUnload):
             This is the function to hook. It can be either a string that
             defines the name of a function of the entity or a callable object
             that returns a :class:`memory.Function` instance.
+        :param EntityHookFilter filter:
+            An optional filter that is tested against the entity the hooked
+            function is called on. The callback is skipped without entering
+            Python for entities that don't match.
         """
         self.test_function = test_function
         self.function = function
+        self.filter = filter
         self.hooked_function = None
         self.callback = None
 
@@ -161,7 +177,8 @@ class _EntityHook(AutoUnload):
         else:
             self.hooked_function = getattr(entity, self.function)
 
-        self.hooked_function.add_hook(self.hook_type, self.callback)
+        self.hooked_function.add_hook(
+            self.hook_type, self.callback, self.filter)
         return True
 
     def _unload_instance(self):
@@ -30,6 +30,7 @@ from _entities._transmit import transmit_manager
 # >> ALL DECLARATION
 # =============================================================================
 __all__ = ('BaseTransmitRules',
+           'TransmitBufferHook',
            'TransmitHash',
            'TransmitHook',
            'TransmitManager',
@@ -88,3 +89,39 @@ class TransmitHook(AutoUnload):
             Function to unregister as a transmit hook callback.
         """
         transmit_manager.unregister_hook(self.callback)
+
+
+class TransmitBufferHook(AutoUnload):
+    """Decorator used to create transmit buffer hooks that auto unload.
+
+    Unlike :class:`TransmitHook`, the callback receives the player's index
+    and memoryviews of the edict indexes and the transmit states. The views
+    are backed by copies, so they are safe to keep, but changes to the states
+    only take effect during the call.
+
+    Example:
+
+    .. code:: python
+
+        from entities.transmit import TransmitBufferHook
+
+        @TransmitBufferHook
+        def transmit_buffer_hook(player_index, indexes, states):
+            # Hide all other players from this player
+            for index in range(1, 65):
+                if index != player_index:
+                    states[index // 32] &= ~(1 << index % 32)
+    """
+
+    def __init__(self, callback):
+        """Registers the transmit buffer hook.
+
+        :param function callback:
+            Function to register as a transmit buffer hook callback.
+        """
+        self.callback = callback
+        transmit_manager.register_buffer_hook(callback)
+
+    def _unload_instance(self):
+        """Unregisters the transmit buffer hook."""
+        transmit_manager.unregister_buffer_hook(self.callback)
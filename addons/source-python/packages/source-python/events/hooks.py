@@ -12,15 +12,15 @@ from enum import IntEnum
 # Source.Python Imports
 #   Core
 from core import AutoUnload
+
+
+# =============================================================================
+# >> FORWARD IMPORTS
+# =============================================================================
+# Source.Python Imports
 #   Events
-from events import GameEvent
-from events.manager import game_event_manager
-#   Hooks
-from hooks.exceptions import except_hooks
-#   Memory
-from memory import get_virtual_function
-from memory import make_object
-from memory.hooks import PreHook
+from _events._hooks import PreEventRouter
+from _events._hooks import pre_event_router
 
 
 # =============================================================================
@@ -28,8 +28,10 @@ from memory.hooks import PreHook
 # =============================================================================
 __all__ = ('EventAction',
            'PreEvent',
+           'PreEventRouter',
            '_PreEventManager',
            'pre_event_manager',
+           'pre_event_router',
            )
 
 
@@ -86,6 +88,51 @@ class _PreEventManager(dict):
         # Return the instance
         return value
 
+    def __setitem__(self, event_name, value):
+        """Store the callbacks and route the event to them."""
+        # Subscribe first, so invalid values are never stored
+        pre_event_router.subscribe(event_name, value)
+        super().__setitem__(event_name, value)
+
+    def __delitem__(self, event_name):
+        """Remove the event and stop routing it."""
+        super().__delitem__(event_name)
+        pre_event_router.unsubscribe(event_name)
+
+    def pop(self, event_name, *default):
+        """Remove the event, stop routing it and return its callbacks."""
+        if event_name not in self:
+            return super().pop(event_name, *default)
+
+        value = super().pop(event_name)
+        pre_event_router.unsubscribe(event_name)
+        return value
+
+    def popitem(self):
+        """Remove an event, stop routing it and return it."""
+        event_name, value = super().popitem()
+        pre_event_router.unsubscribe(event_name)
+        return event_name, value
+
+    def clear(self):
+        """Remove all events and stop routing them."""
+        for event_name in tuple(self):
+            pre_event_router.unsubscribe(event_name)
+
+        super().clear()
+
+    def setdefault(self, event_name, default=None):
+        """Store and route the default if the event is not stored yet."""
+        if event_name not in self:
+            self[event_name] = default
+
+        return self[event_name]
+
+    def update(self, *args, **kwargs):
+        """Store and route all given events."""
+        for event_name, value in dict(*args, **kwargs).items():
+            self[event_name] = value
+
     def register_for_event(self, event_name, callback):
         """Register the callback for the given event.
 
@@ -185,77 +232,3 @@ class _PreEventList(list):
 
         # Remove the callback from the list
         super().remove(callback)
-
-
-# =============================================================================
-# >> PRE-HOOK FUNCTIONS
-# =============================================================================
-@PreHook(get_virtual_function(game_event_manager, 'FireEvent'))
-def _pre_game_event(args):
-    """Call pre-event functions if the event is registered."""
-    # Crashfix for CS:GO:
-    # https://github.com/Source-Python-Dev-Team/Source.Python/issues/230
-    game_event_ptr = args[1]
-    if not game_event_ptr:
-        return False
-
-    # Get the GameEvent object
-    game_event = make_object(GameEvent, game_event_ptr)
-
-    # Get the name of the event
-    event_name = game_event.name
-
-    # If the current event is not in the dictionary, return
-    if event_name not in pre_event_manager:
-        return
-
-    # Create a variable to know what to do after all pre-events are called
-    event_action = EventAction.CONTINUE
-
-    # Loop through all callbacks in the pre-event's list
-    for callback in pre_event_manager[event_name]:
-
-        # Use try/except in case an error occurs during in the callback
-        try:
-
-            # Call the callback and get its return value
-            current_action = callback(game_event)
-
-            # Is the return value invalid?
-            if (current_action is not None and
-                    not isinstance(current_action, EventAction)):
-
-                # Raise an error to exit the try
-                raise ValueError(
-                    'Invalid return value for pre-event "{0}".'.format(
-                        current_action))
-
-        # Was an error encountered?
-        except:
-
-            # Print the exception to the console
-            except_hooks.print_exception()
-
-        # Was no error encountered?
-        else:
-
-            # Does the current action have a higher priority?
-            if current_action is not None and current_action > event_action:
-
-                # Change the event action
-                event_action = current_action
-
-    # Does the return value want to set the dontbroadcast value?
-    if event_action is EventAction.STOP_BROADCAST:
-
-        # Set the dontbroadcast value
-        args[2] = True
-
-    # Does the return value want to block the event?
-    elif event_action is EventAction.BLOCK:
-
-        # Free the event
-        game_event_manager.free_event(game_event)
-
-        # Block the event
-        return False
@@ -27,7 +27,14 @@ __all__ = ('BaseEntityIter',
 # >> ENTITY ITERATION CLASSES
 # =============================================================================
 class BaseEntityIter(_IterObject):
-    """BaseEntity iterate class."""
+    """BaseEntity iterate class.
+
+    When exact class names are given, the entities are grouped by class
+    name, in the order the class names were given. Within each group they
+    keep the entity list order. Without class names, or when
+    ``exact_match`` is ``False``, every entity is visited in entity list
+    order.
+    """
 
     def __init__(self, class_names=None, exact_match=True):
         """Store the base attributes for the generator."""
@@ -41,11 +48,28 @@ class BaseEntityIter(_IterObject):
         self.class_names = list() if class_names is None else class_names
         self.exact_match = exact_match
 
+    def __iter__(self):
+        """Iterate through the entities matching the given class names."""
+        # Substring matches can only be resolved by visiting every entity
+        if not self.class_names or not self.exact_match:
+            yield from super().__iter__()
+            return
+
+        # Let the native classname index only visit matching entities
+        for class_name in dict.fromkeys(self.class_names):
+            yield from self.class_iterator(class_name)
+
     @staticmethod
     def iterator():
         """Iterate over all :class:`entities.entity.BaseEntity` objects."""
         return BaseEntityGenerator()
 
+    @staticmethod
+    def class_iterator(class_name):
+        """Iterate over all :class:`entities.entity.BaseEntity` objects
+        with the given class name."""
+        return BaseEntityGenerator(class_name, True)
+
     def _is_valid(self, entity):
         """Verify that the edict needs yielded."""
         # Are there any class names to be checked?
@@ -77,3 +101,10 @@ class EntityIter(BaseEntityIter):
         """Iterate over all :class:`entities.entity.Entity` objects."""
         for edict in EntityGenerator():
             yield Entity(index_from_edict(edict))
+
+    @staticmethod
+    def class_iterator(class_name):
+        """Iterate over all :class:`entities.entity.Entity` objects
+        with the given class name."""
+        for edict in EntityGenerator(class_name, True):
+            yield Entity(index_from_edict(edict))
@@ -22,6 +22,8 @@ from filters.iterator import _IterObject
 #   Paths
 from paths import SP_DATA_PATH
 #   Players
+from players import PlayerFilter
+from players import PlayerFilterFlags
 from players import PlayerGenerator
 from players.entity import Player
 from players.helpers import index_from_userid
@@ -42,6 +44,10 @@ __all__ = ('get_default_filters',
 # Get the team's file for the current game
 _game_teams = ConfigObj(SP_DATA_PATH / 'teams' / GAME_NAME + '.ini')
 
+# Built-in filters that can be tested natively, stored as
+# name: (function, flags, teams)
+_native_filters = dict()
+
 
 # =============================================================================
 # >> PLAYER ITERATION CLASSES
@@ -49,6 +55,27 @@ _game_teams = ConfigObj(SP_DATA_PATH / 'teams' / GAME_NAME + '.ini')
 class PlayerIter(_IterObject):
     """Player iterate class."""
 
+    def __iter__(self):
+        """Iterate through the players passing the instance's filters."""
+        player_filter = self._get_native_filter()
+
+        # Is any of the filters a custom one?
+        if player_filter is None:
+            yield from super().__iter__()
+            return
+
+        # Only the matching players ever reach Python
+        for edict in PlayerGenerator(player_filter):
+            yield Player(index_from_edict(edict))
+
+    def __len__(self):
+        """Return the number of players passing the instance's filters."""
+        player_filter = self._get_native_filter()
+        if player_filter is None:
+            return super().__len__()
+
+        return len(player_filter)
+
     @staticmethod
     def iterator():
         """Iterate over all :class:`players.entity.Player` objects."""
@@ -58,6 +85,32 @@ class PlayerIter(_IterObject):
             # Yield the Player instance for the current edict
             yield Player(index_from_edict(edict))
 
+    def _get_native_filter(self):
+        """Return a :class:`players.PlayerFilter` for the instance's filters.
+
+        Return None if any of the filters is not a built-in filter, or has
+        been replaced since.
+        """
+        masks = [0, 0, 0, 0]
+        for offset, filter_names in ((0, self.is_filters),
+                                     (1, self.not_filters)):
+            for filter_name in filter_names:
+                native = _native_filters.get(filter_name)
+                if (native is None or
+                        self._filters.get(filter_name) is not native[0]):
+                    return None
+
+                masks[offset] |= native[1]
+                masks[offset + 2] |= native[2]
+
+        return PlayerFilter(*masks)
+
+    @classmethod
+    def _register_native_filter(cls, filter_name, function, flags=0, teams=0):
+        """Register a built-in filter that can be tested natively."""
+        cls.register_filter(filter_name, function)
+        _native_filters[filter_name] = (function, flags, teams)
+
 
 # =============================================================================
 # PLAYER TEAM CLASSES
@@ -88,16 +141,33 @@ class _Team(object):
         """Return whether the player is on the team."""
         return player.team == self.team
 
+    def _register(self, filter_name):
+        """Register the filter for the team."""
+        function = self._player_is_on_team
+
+        # Is the team number too large to be tested natively?
+        if not 0 <= self.team < 32:
+            PlayerIter.register_filter(filter_name, function)
+            return
+
+        PlayerIter._register_native_filter(
+            filter_name, function, teams=1 << self.team)
+
 
 # =============================================================================
 # >> FILTER REGISTRATION
 # =============================================================================
 # Register the filter functions
-PlayerIter.register_filter('all', lambda player: True)
-PlayerIter.register_filter('bot', lambda player: player.is_bot())
-PlayerIter.register_filter('human', lambda player: not player.is_bot())
-PlayerIter.register_filter('alive', lambda player: not player.dead)
-PlayerIter.register_filter('dead', lambda player: player.dead)
+PlayerIter._register_native_filter(
+    'all', lambda player: True, PlayerFilterFlags.ALL)
+PlayerIter._register_native_filter(
+    'bot', lambda player: player.is_bot(), PlayerFilterFlags.BOT)
+PlayerIter._register_native_filter(
+    'human', lambda player: not player.is_bot(), PlayerFilterFlags.HUMAN)
+PlayerIter._register_native_filter(
+    'alive', lambda player: not player.dead, PlayerFilterFlags.ALIVE)
+PlayerIter._register_native_filter(
+    'dead', lambda player: player.dead, PlayerFilterFlags.DEAD)
 
 # Loop through all teams in the game's team file
 for _team in _game_teams.get('names', {}):
@@ -106,8 +176,7 @@ for _team in _game_teams.get('names', {}):
     _player_teams[_team] = int(_game_teams['names'][_team])
 
     # Register the filter
-    PlayerIter.register_filter(
-        _team, _player_teams[_team]._player_is_on_team)
+    _player_teams[_team]._register(_team)
 
 # Loop through all base team names
 for _number, _team in enumerate(('un', 'spec', 't', 'ct')):
@@ -122,8 +191,7 @@ for _number, _team in enumerate(('un', 'spec', 't', 'ct')):
     _player_teams[_team] = _number
 
     # Register the filter
-    PlayerIter.register_filter(
-        _team, _player_teams[_team]._player_is_on_team)
+    _player_teams[_team]._register(_team)
 
 
 # =============================================================================
@@ -74,11 +74,14 @@ from _listeners import on_query_cvar_value_finished_listener_manager
 from _listeners import on_server_activate_listener_manager
 from _listeners import on_tick_listener_manager
 from _listeners import on_server_output_listener_manager
+from _listeners import on_server_output_batch_listener_manager
 from _listeners import on_player_collision_listener_manager
 from _listeners import on_player_transmit_listener_manager
 from _listeners import on_player_run_command_listener_manager
 from _listeners import on_player_post_run_command_listener_manager
 from _listeners import on_button_state_changed_listener_manager
+from _listeners._output import ServerOutputCapture
+from _listeners._output import server_output_capture
 
 
 # =============================================================================
@@ -129,6 +132,8 @@ __all__ = ('ButtonStatus',
            'OnTick',
            'OnVersionUpdate',
            'OnServerOutput',
+           'OnServerOutputBatch',
+           'ServerOutputCapture',
            'get_button_combination_status',
            'on_client_active_listener_manager',
            'on_client_connect_listener_manager',
@@ -166,6 +171,8 @@ __all__ = ('ButtonStatus',
            'on_tick_listener_manager',
            'on_version_update_listener_manager',
            'on_server_output_listener_manager',
+           'on_server_output_batch_listener_manager',
+           'server_output_capture',
            'on_player_collision_listener_manager',
            'on_player_transmit_listener_manager',
            'on_player_run_command_listener_manager',
@@ -549,6 +556,18 @@ class OnServerOutput(ListenerManagerDecorator):
     manager = on_server_output_listener_manager
 
 
+class OnServerOutputBatch(ListenerManagerDecorator):
+    """Register/unregister a batched server output listener.
+
+    Server output is captured without calling into Python and delivered
+    once per frame as a list of ``(severity, message, color, timestamp)``
+    tuples. Unlike :class:`OnServerOutput`, these listeners can't block
+    the output.
+    """
+
+    manager = on_server_output_batch_listener_manager
+
+
 # =============================================================================
 # >> FUNCTIONS
 # =============================================================================
@@ -6,7 +6,6 @@
 # >> IMPORTS
 # =============================================================================
 # Python
-import bisect
 import math
 import time
 
@@ -17,10 +16,16 @@ from warnings import warn
 # Source.Python
 from core import AutoUnload
 from core import WeakAutoUnload
-from hooks.exceptions import except_hooks
-from listeners import (
-    listeners_logger, on_tick_listener_manager, OnLevelEnd,
-)
+from listeners import listeners_logger, OnLevelEnd
+
+
+# =============================================================================
+# >> FORWARD IMPORTS
+# =============================================================================
+# Source.Python Imports
+#   Listeners
+from _listeners._tick import TickScheduler
+from _listeners._tick import tick_scheduler
 
 
 # =============================================================================
@@ -31,6 +36,8 @@ __all__ = (
     'GameThread',
     'Repeat',
     'RepeatStatus',
+    'TickScheduler',
+    'tick_scheduler',
 )
 
 
@@ -64,29 +71,36 @@ class GameThread(WeakAutoUnload, Thread):
 # =============================================================================
 # >> DELAY CLASSES
 # =============================================================================
-class _DelayManager(list):
-    """A class that is responsible for executing delays."""
-
-    def __init__(self):
-        super().__init__()
-        on_tick_listener_manager.register_listener(self._tick)
-
-    def _tick(self):
-        """Internal tick listener."""
-        current_time = time.time()
-        while self and self[0].exec_time <= current_time:
-            try:
-                self.pop(0).execute()
-            except:
-                except_hooks.print_exception()
+class _DelayManager(set):
+    """A class that keeps track of all running delays.
+
+    The delays are executed by :data:`tick_scheduler`.
+    """
 
     def add(self, delay):
-        """Add a delay to the list.
+        """Schedule the given delay.
 
         :param Delay delay:
             The delay to add.
         """
-        bisect.insort_right(self, delay)
+        super().add(delay)
+        delay._handle = tick_scheduler.schedule(
+            delay.exec_time, delay._scheduled_execute, delay._interval)
+
+    def remove(self, delay):
+        """Cancel the given delay.
+
+        :param Delay delay:
+            The delay to remove.
+        :raise ValueError:
+            Raised if the delay is not running.
+        """
+        try:
+            super().remove(delay)
+        except KeyError:
+            raise ValueError('Delay is not running.') from None
+
+        tick_scheduler.cancel(delay._handle)
 
 _delay_manager = _DelayManager()
 
@@ -133,6 +147,9 @@ class Delay(WeakAutoUnload):
 
         #: Whether or not to cancel the delay at the end of the map.
         self.cancel_on_level_end = cancel_on_level_end
+
+        # Handle of the scheduled callback
+        self._handle = None
         _delay_manager.add(self)
 
     def __lt__(self, other):
@@ -159,6 +176,15 @@ class Delay(WeakAutoUnload):
         """
         return self.callback(*self.args, **self.kwargs)
 
+    # Re-arm interval of the scheduled callback. Negative values create a
+    # one-shot callback.
+    _interval = -1
+
+    def _scheduled_execute(self):
+        """Called by the scheduler when the delay expired."""
+        _delay_manager.discard(self)
+        self.execute()
+
     def cancel(self):
         """Cancel the delay.
 
@@ -201,6 +227,33 @@ class Delay(WeakAutoUnload):
             pass
 
 
+class _RepeatDelay(Delay):
+    """A delay that is re-armed by the scheduler after each execution."""
+
+    def __init__(self, delay, callback, interval, cancel_on_level_end=False):
+        """Initialize the delay.
+
+        :param float delay:
+            The delay in seconds until the first execution.
+        :param callback:
+            A callable object that should be called after each interval.
+        :param float interval:
+            The delay in seconds between the executions.
+        :param bool cancel_on_level_end:
+            Whether or not to cancel the delay at the end of the map.
+        """
+        self._interval = interval
+        super().__init__(
+            delay, callback, cancel_on_level_end=cancel_on_level_end)
+
+    def _scheduled_execute(self):
+        """Called by the scheduler when the current interval expired."""
+        self.delay = self._interval
+        self._start_time = time.time()
+        self.exec_time = self._start_time + self._interval
+        self.execute()
+
+
 # =============================================================================
 # >> REPEAT CLASSES
 # =============================================================================
@@ -404,8 +457,8 @@ class Repeat(AutoUnload):
         self._original_start_time = time.time()
 
         # Start the delay
-        self._delay = Delay(
-            self.interval, self._execute,
+        self._delay = _RepeatDelay(
+            self.interval, self._execute, self.interval,
             cancel_on_level_end=self.cancel_on_level_end
         )
 
@@ -512,8 +565,8 @@ class Repeat(AutoUnload):
         self._status = RepeatStatus.RUNNING
 
         # Start the delay
-        self._delay = Delay(
-            self._loop_time_for_pause, self._execute,
+        self._delay = _RepeatDelay(
+            self._loop_time_for_pause, self._execute, self.interval,
             cancel_on_level_end=self.cancel_on_level_end
         )
 
@@ -579,7 +632,8 @@ class Repeat(AutoUnload):
         listeners_tick_logger.log_debug('Repeat._execute')
         self._loops_elapsed += 1
 
-        # Are any more loops to be made?
+        # Are any more loops to be made? The scheduler calls the delay
+        # again after the interval.
         if self.loops_remaining > 0:
             listeners_tick_logger.log_debug(
                 'Repeat._execute - Remaining - {remaining}'.format(
@@ -587,12 +641,6 @@ class Repeat(AutoUnload):
                 )
             )
 
-            # Call the delay again
-            self._delay = Delay(
-                self.interval, self._execute,
-                cancel_on_level_end=self.cancel_on_level_end
-            )
-
         else:
             listeners_tick_logger.log_debug(
                 'Repeat._execute - Stopping the loop'
@@ -601,6 +649,9 @@ class Repeat(AutoUnload):
             # Set the status to stopped
             self._status = RepeatStatus.STOPPED
 
+            # Cancel the delay
+            self._delay.cancel()
+
         # Call the repeat's callback for this loop
         self.callback(*self.args, **self.kwargs)
 
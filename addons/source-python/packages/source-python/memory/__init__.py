@@ -26,6 +26,7 @@ from _memory import CLASS_INFO
 from _memory import Convention
 from _memory import DataType
 from _memory import EXPOSED_CLASSES
+from _memory import FieldDescriptor
 from _memory import Function
 from _memory import FunctionInfo
 from _memory import NULL
@@ -53,6 +54,7 @@ __all__ = ('BinaryFile',
            'Convention',
            'DataType',
            'EXPOSED_CLASSES',
+           'FieldDescriptor',
            'Function',
            'FunctionInfo',
            'NULL',
@@ -12,6 +12,7 @@ from contextlib import contextmanager
 #   Core
 from core import AutoUnload
 #   Memory
+from _memory import HookFilter
 from _memory import HookType
 from _memory import set_hooks_disabled
 from _memory import get_hooks_disabled
@@ -21,7 +22,8 @@ from memory import Function
 # =============================================================================
 # >> ALL DECLARATION
 # =============================================================================
-__all__ = ('HookType',
+__all__ = ('HookFilter',
+           'HookType',
            'PostHook',
            'PreHook',
            'set_hooks_disabled',
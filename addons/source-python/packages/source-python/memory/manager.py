@@ -12,6 +12,7 @@ from core import GameConfigObj
 from memory import Convention
 from memory import DataType
 from memory import EXPOSED_CLASSES
+from memory import FieldDescriptor
 from memory import TYPE_SIZES
 from memory import alloc
 from memory import find_binary
@@ -41,6 +42,36 @@ __all__ = ('CustomType',
 # =============================================================================
 manager_logger = memory_logger.manager
 
+# Native types that can be loaded and stored by a FieldDescriptor
+_field_data_types = {
+    Type.BOOL: DataType.BOOL,
+    Type.CHAR: DataType.CHAR,
+    Type.UCHAR: DataType.UCHAR,
+    Type.SHORT: DataType.SHORT,
+    Type.USHORT: DataType.USHORT,
+    Type.INT: DataType.INT,
+    Type.UINT: DataType.UINT,
+    Type.LONG: DataType.LONG,
+    Type.ULONG: DataType.ULONG,
+    Type.LONG_LONG: DataType.LONG_LONG,
+    Type.ULONG_LONG: DataType.ULONG_LONG,
+    Type.FLOAT: DataType.FLOAT,
+    Type.DOUBLE: DataType.DOUBLE,
+    Type.POINTER: DataType.POINTER,
+    Type.STRING_POINTER: DataType.STRING,
+}
+
+
+# =============================================================================
+# >> FUNCTIONS
+# =============================================================================
+def _field(descriptor, doc):
+    """Attach the given docstring to a FieldDescriptor and return it."""
+    if doc is not None:
+        descriptor.__doc__ = doc
+
+    return descriptor
+
 
 # =============================================================================
 # >> CustomType
@@ -312,6 +343,20 @@ class TypeManager(dict):
             )
         )
 
+        funcs = tuple(funcs)
+
+        # Resolve all signatures of a binary in a single pass. The found
+        # addresses are cached, so pipe_function() doesn't search again.
+        signatures = {}
+        for name, data in funcs:
+            binary, identifier, srv_check = data[0], data[1], data[5]
+            if isinstance(identifier, bytes):
+                signatures.setdefault(
+                    (binary, srv_check), []).append(identifier)
+
+        for (binary, srv_check), identifiers in signatures.items():
+            find_binary(binary, srv_check).find_signatures(identifiers)
+
         # Create the functions
         cls_dict = {}
         for name, data in funcs:
@@ -441,16 +486,21 @@ class TypeManager(dict):
             Vector vecVal;
             bool bVal;
         """
+        # Load and store native values directly
+        data_type = _field_data_types.get(type_name)
+        if data_type is not None:
+            return _field(FieldDescriptor(offset, data_type), doc)
+
         native_type = Type.is_native(type_name)
 
-        def fget(ptr):
+        def converter(ptr):
             """Return the instance attribute value."""
             # Handle custom type
             if not native_type:
-                return self.convert(type_name, ptr + offset)
+                return self.convert(type_name, ptr)
 
             # Handle native type
-            return getattr(ptr, 'get_' + type_name)(offset)
+            return getattr(ptr, 'get_' + type_name)()
 
         def fset(ptr, value):
             """Set the instance attribute value."""
@@ -469,7 +519,7 @@ class TypeManager(dict):
             else:
                 getattr(ptr, 'set_' + type_name)(value, offset)
 
-        return property(fget, fset, None, doc)
+        return _field(FieldDescriptor(offset, None, converter, fset), doc)
 
     def pointer_attribute(self, type_name, offset, doc=None):
         """Create a wrapper for a pointer attribute.
@@ -480,12 +530,8 @@ class TypeManager(dict):
         """
         native_type = Type.is_native(type_name)
 
-        def fget(ptr):
+        def converter(ptr):
             """Get the pointer attribute value."""
-            # Get the base address of the pointer. We are now on
-            # "instance level"
-            ptr = ptr.get_pointer(offset)
-
             # Handle custom type
             if not native_type:
                 return self.convert(type_name, ptr)
@@ -524,7 +570,15 @@ class TypeManager(dict):
                 # Set the value
                 getattr(instance_ptr, 'set_' + type_name)(value)
 
-        return property(fget, fset, None, doc)
+        # Native values are loaded and stored directly, once the pointer has
+        # been allocated by fset()
+        data_type = _field_data_types.get(type_name)
+        if data_type is not None:
+            return _field(
+                FieldDescriptor(offset, data_type, None, fset, True), doc)
+
+        return _field(
+            FieldDescriptor(offset, None, converter, fset, True), doc)
 
     def static_instance_array(self, type_name, offset, length=None, doc=None):
         """Create a wrapper for a static instance array.
@@ -533,17 +587,17 @@ class TypeManager(dict):
             Vector vecArray[10];
             bool boolArray[10];
         """
-        def fget(ptr):
+        def converter(ptr):
             """Get the static instance array."""
-            return Array(self, False, type_name, ptr + offset, length)
+            return Array(self, False, type_name, ptr, length)
 
         def fset(ptr, value):
             """Set all values in the static instance array."""
-            array = fget(ptr)
+            array = converter(ptr + offset)
             for index, val in enumerate(value):
                 array[index] = val
 
-        return property(fget, fset, None, doc)
+        return _field(FieldDescriptor(offset, None, converter, fset), doc)
 
     def dynamic_instance_array(self, type_name, offset, length=None, doc=None):
         """Create a wrapper for a dynamic instance array.
@@ -554,18 +608,18 @@ class TypeManager(dict):
 
         Those arrrays are mostly created by the "new" statement.
         """
-        def fget(ptr):
+        def converter(ptr):
             """Get the dynamic instance array."""
-            return Array(
-                self, False, type_name, ptr.get_pointer(offset), length)
+            return Array(self, False, type_name, ptr, length)
 
         def fset(ptr, value):
             """Set all values for the dynamic instance array."""
-            array = fget(ptr)
+            array = converter(ptr.get_pointer(offset))
             for index, val in enumerate(value):
                 array[index] = val
 
-        return property(fget, fset, None, doc)
+        return _field(
+            FieldDescriptor(offset, None, converter, fset, True), doc)
 
     def static_pointer_array(self, type_name, offset, length=None, doc=None):
         """Create a wrapper for a static pointer array.
@@ -574,17 +628,17 @@ class TypeManager(dict):
             Vector* pVecArray[10];
             bool* pBoolArray[10];
         """
-        def fget(ptr):
+        def converter(ptr):
             """Get the static pointer array."""
-            return Array(self, True, type_name, ptr + offset, length)
+            return Array(self, True, type_name, ptr, length)
 
         def fset(ptr, value):
             """Set all values for the static pointer array."""
-            array = fget(ptr)
+            array = converter(ptr + offset)
             for index, val in enumerate(value):
                 array[index] = val
 
-        return property(fget, fset, None, doc)
+        return _field(FieldDescriptor(offset, None, converter, fset), doc)
 
     def dynamic_pointer_array(self, type_name, offset, length=None, doc=None):
         """Create a wrapper for a dynamic pointer array.
@@ -595,18 +649,18 @@ class TypeManager(dict):
 
         Those arrays are mostly created by the "new" statement.
         """
-        def fget(ptr):
+        def converter(ptr):
             """Get the dynamic pointer array."""
-            return Array(
-                self, True, type_name, ptr.get_pointer(offset), length)
+            return Array(self, True, type_name, ptr, length)
 
         def fset(ptr, value):
             """Set all values for the dynamic pointer array."""
-            array = fget(ptr)
+            array = converter(ptr.get_pointer(offset))
             for index, val in enumerate(value):
                 array[index] = val
 
-        return property(fget, fset, None, doc)
+        return _field(
+            FieldDescriptor(offset, None, converter, fset, True), doc)
 
     def virtual_function(
             self, index, args=(), return_type=DataType.VOID,
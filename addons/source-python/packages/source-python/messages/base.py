@@ -71,12 +71,36 @@ class UserMessageCreator(AttrDict):
     def send(self, *player_indexes, **tokens):
         """Send the user message."""
         player_indexes = RecipientFilter(*player_indexes)
+
+        # Languages that end up with the same payload share one message
+        payloads = {}
         for language, indexes in self._categorize_players_by_language(
                 player_indexes).items():
-            translated_kwargs = AttrDict(self)
-            translated_kwargs.update(
-                self._get_translated_kwargs(language, tokens))
-            self._send(indexes, translated_kwargs)
+            translated_kwargs = self._get_translated_kwargs(language, tokens)
+            key = self._get_payload_key(translated_kwargs, language)
+            if key in payloads:
+                payloads[key][0].update(indexes)
+            else:
+                payloads[key] = (indexes, translated_kwargs)
+
+        for indexes, translated_kwargs in payloads.values():
+            kwargs = AttrDict(self)
+            kwargs.update(translated_kwargs)
+            self._send(indexes, kwargs)
+
+    @staticmethod
+    def _get_payload_key(translated_kwargs, language):
+        """Return a key that is equal for identical translated arguments.
+
+        If the arguments are not hashable, the language is used instead.
+        """
+        key = tuple(translated_kwargs.items())
+        try:
+            hash(key)
+        except TypeError:
+            return language
+
+        return key
 
     def _send(self, player_indexes, translated_kwargs):
         """Send the user message to the given players.
@@ -283,13 +307,13 @@ class SayText2(UserMessageCreator):
 
     def protobuf(self, buffer, kwargs):
         """Send the SayText2 with protobuf."""
-        buffer.set_string('msg_name', self.color + kwargs.message)
-        buffer.set_bool('chat', kwargs.chat)
-        buffer.set_int32('ent_idx', kwargs.index)
-        buffer.add_string('params', kwargs.param1)
-        buffer.add_string('params', kwargs.param2)
-        buffer.add_string('params', kwargs.param3)
-        buffer.add_string('params', kwargs.param4)
+        buffer.update({
+            'msg_name': self.color + kwargs.message,
+            'chat': kwargs.chat,
+            'ent_idx': kwargs.index,
+            'params': (
+                kwargs.param1, kwargs.param2, kwargs.param3, kwargs.param4),
+        })
         # TODO: Handle textchatall
 
     def bitbuf(self, buffer, kwargs):
@@ -339,9 +363,11 @@ class SayText(UserMessageCreator):
 
     def protobuf(self, buffer, kwargs):
         """Send the SayText with protobuf."""
-        buffer.set_int32('ent_idx', kwargs.index)
-        buffer.set_bool('chat', kwargs.chat)
-        buffer.set_string('text', self.color + kwargs.message)
+        buffer.update({
+            'ent_idx': kwargs.index,
+            'chat': kwargs.chat,
+            'text': self.color + kwargs.message,
+        })
 
     def bitbuf(self, buffer, kwargs):
         """Send the SayText with bitbuf."""
@@ -415,12 +441,12 @@ class TextMsg(UserMessageCreator):
 
     def protobuf(self, buffer, kwargs):
         """Send the TextMsg with protobuf."""
-        buffer.set_int32('msg_dst', kwargs.destination)
-        buffer.add_string('params', kwargs.message)
-        buffer.add_string('params', kwargs.param1)
-        buffer.add_string('params', kwargs.param2)
-        buffer.add_string('params', kwargs.param3)
-        buffer.add_string('params', kwargs.param4)
+        buffer.update({
+            'msg_dst': kwargs.destination,
+            'params': (
+                kwargs.message, kwargs.param1, kwargs.param2,
+                kwargs.param3, kwargs.param4),
+        })
 
     def bitbuf(self, buffer, kwargs):
         """Send the TextMsg with bitbuf."""
@@ -443,8 +469,7 @@ class KeyHintText(UserMessageCreator):
 
     def protobuf(self, buffer, kwargs):
         """Send the KeyHintText with protobuf."""
-        for hint in kwargs.hints:
-            buffer.add_string('hints', hint)
+        buffer.update({'hints': kwargs.hints})
 
     def bitbuf(self, buffer, kwargs):
         """Send the KeyHintText with bitbuf."""
@@ -454,9 +479,8 @@ class KeyHintText(UserMessageCreator):
 
     def _get_translated_kwargs(self, language, tokens):
         """Return translated and tokenized arguments."""
-        hints = []
-        for hint in self.hints:
-            hints.append(self._translate(hint, language, tokens))
+        hints = tuple(
+            self._translate(hint, language, tokens) for hint in self.hints)
 
         return dict(hints=hints)
 
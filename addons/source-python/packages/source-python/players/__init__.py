@@ -16,6 +16,8 @@ from loggers import _sp_logger
 # Source.Python Imports
 #   Players
 from _players import Client
+from _players import PlayerFilter
+from _players import PlayerFilterFlags
 from _players import PlayerGenerator
 from _players import PlayerInfo
 from _players import UserCmd
@@ -26,6 +28,8 @@ from _players import UserCmd
 # =============================================================================
 __all__ = ('BaseClient',
            'Client',
+           'PlayerFilter',
+           'PlayerFilterFlags',
            'PlayerGenerator',
            'PlayerInfo',
            'UserCmd',
@@ -7,16 +7,17 @@
 # >> IMPORTS
 # =============================================================================
 # Python Imports
-from collections import defaultdict
+#   Collections
+from collections.abc import Mapping
 
 # Source.Python Imports
 #    Engines
 from engines.server import global_vars
-#    Listeners
-from listeners import on_client_disconnect_listener_manager
-#    Memory
-from memory import get_virtual_function
-from memory.hooks import HookType
+#    Entities
+from entities.helpers import index_from_edict
+#    Players
+from players import PlayerGenerator
+from players.helpers import playerinfo_from_edict
 
 
 # =============================================================================
@@ -24,56 +25,90 @@ from memory.hooks import HookType
 # =============================================================================
 # Source.Python Imports
 #  Voice
+from _players._voice import VoiceRouter
+from _players._voice import voice_router
 from _players._voice import voice_server
 
 
 # =============================================================================
 # >> ALL DECLARATION
 # =============================================================================
-__all__ = ('_MuteManager',
+__all__ = ('VoiceRouter',
+           '_MuteManager',
+           'get_team_indexes',
            'mute_manager',
+           'voice_router',
            'voice_server',
            )
 
 
+# =============================================================================
+# >> FUNCTIONS
+# =============================================================================
+def get_team_indexes(team):
+    """Return a tuple containing the indexes of all players on the given team.
+
+    The result can be passed as senders or receivers to :attr:`voice_router`
+    and :attr:`mute_manager`, but won't follow later team changes.
+    """
+    return tuple(
+        index_from_edict(edict) for edict in PlayerGenerator()
+        if playerinfo_from_edict(edict).team == team)
+
+
 # =============================================================================
 # >> CLASSES
 # =============================================================================
-class _MuteManager(defaultdict):
-    """A singleton that manages muting players."""
-    _set_client_listening = None
+def _is_player_index(index):
+    """Return True if the given value is a valid player index."""
+    return isinstance(index, int) and 0 < index <= global_vars.max_clients
+
+
+class _MuteManager(Mapping):
+    """A singleton that manages muting players.
+
+    The mutes are stored in :attr:`voice_router`, which applies them without
+    calling into Python.
+
+    For backwards compatibility, the manager is also a read-only mapping of
+    receiver indexes to the set of senders muted for them. Changing those
+    sets has no effect, use :meth:`mute_player` and :meth:`unmute_player`
+    instead.
+    """
 
-    @classmethod
-    def _hook_set_client_listening(cls):
-        if cls._set_client_listening is not None:
-            return
+    def __getitem__(self, receiver):
+        """Return a set of the senders muted for the given receiver."""
+        if not _is_player_index(receiver):
+            return set()
 
-        function = get_virtual_function(voice_server, 'SetClientListening')
-        function.add_hook(HookType.PRE, _pre_set_client_listening)
+        return set(
+            sender for sender in range(1, global_vars.max_clients + 1)
+            if voice_router.is_muted(sender, receiver))
 
-        cls._set_client_listening = function
+    def __iter__(self):
+        """Iterate over all receivers that have muted senders."""
+        for receiver in range(1, global_vars.max_clients + 1):
+            if self[receiver]:
+                yield receiver
 
-        on_client_disconnect_listener_manager.register_listener(_on_client_disconnect)
+    def __contains__(self, receiver):
+        """Return True if the given receiver has muted senders."""
+        return bool(self[receiver])
+
+    def __len__(self):
+        """Return the number of receivers that have muted senders."""
+        return sum(1 for receiver in self)
 
     @staticmethod
-    def _get_receivers(receivers):
-        """Return a tuple containing player indexes.
+    def _get_senders(sender):
+        """Return the valid player indexes of the given sender(s).
 
-        If <receivers> is None, a tuple is returned that contains all valid
-        player indexes. Otherwise the given argument is returned after it has
-        been validated.
+        Anything else can't talk, so it's ignored like it always was.
         """
-        if receivers is None:
-            return range(1, global_vars.max_clients + 1)
-
-        # Check if "receivers" contains valid player indexes
-        if not all(map(lambda index: (isinstance(
-                index, int) and 0 < index <= global_vars.max_clients),
-                receivers)):
-            raise ValueError(
-                '"receivers" doesn\'t contain valid player indexes.')
+        if isinstance(sender, int):
+            return (sender,) if _is_player_index(sender) else ()
 
-        return receivers
+        return tuple(filter(_is_player_index, sender))
 
     def mute_player(self, sender, receivers=None):
         """Mute a player, so other players can't hear him talking.
@@ -87,10 +122,7 @@ class _MuteManager(defaultdict):
         that contains the player indexes that shouldn't hear the sender
         anymore.
         """
-        self._hook_set_client_listening()
-
-        for receiver in self._get_receivers(receivers):
-            self[receiver].add(sender)
+        voice_router.mute(self._get_senders(sender), receivers)
 
     def unmute_player(self, sender, receivers=None):
         """Unmute a player, so other players can hear him again.
@@ -102,8 +134,7 @@ class _MuteManager(defaultdict):
         tuple that contains the player indexes that should hear the sender
         again.
         """
-        for receiver in self._get_receivers(receivers):
-            self[receiver].discard(sender)
+        voice_router.unmute(self._get_senders(sender), receivers)
 
     def is_muted(self, sender, receivers=None):
         """Return True if a player is muted.
@@ -114,28 +145,19 @@ class _MuteManager(defaultdict):
         If you want to check if the player is muted only for specific players,
         pass a tuple that contains the player indexes that should be checked.
         """
-        return all(map(
-            lambda receiver: sender in self[receiver],
-            self._get_receivers(receivers)))
+        senders = self._get_senders(sender)
+        if not senders:
+            return False
 
-# The singleton object of the :class:`_MuteManager` class
-mute_manager = _MuteManager(set)
+        return voice_router.is_muted(senders, receivers)
 
+    def mute_team(self, team, receivers=None):
+        """Mute all players that are currently on the given team."""
+        voice_router.mute(get_team_indexes(team), receivers)
 
-# =============================================================================
-# >> CALLBACKS
-# =============================================================================
-def _pre_set_client_listening(args):
-    """Called before IVoiceServer::SetClientListening is called."""
-    receiver = args[1]
-    sender = args[2]
-
-    # Check if the sender is muted for this receiver
-    if mute_manager.is_muted(sender, [receiver]):
-        args[3] = False
+    def unmute_team(self, team, receivers=None):
+        """Unmute all players that are currently on the given team."""
+        voice_router.unmute(get_team_indexes(team), receivers)
 
-
-def _on_client_disconnect(index):
-    """Called when a player left the server."""
-    # Unmute the player, so the next player who gets this index won't be muted
-    mute_manager.unmute_player(index)
+# The singleton object of the :class:`_MuteManager` class
+mute_manager = _MuteManager()
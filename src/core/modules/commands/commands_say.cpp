@@ -32,7 +32,6 @@
 #include "utilities/call_python.h"
 #include "boost/python/call.hpp"
 #include "boost/shared_array.hpp"
-#include "boost/unordered_map.hpp"
 #include "sp_main.h"
 #include "modules/listeners/listeners_manager.h"
 #include "utilities/convar.h"
@@ -45,9 +44,11 @@
 //-----------------------------------------------------------------------------
 // Global say command mapping.
 //-----------------------------------------------------------------------------
-typedef boost::unordered_map<std::string, CSayCommandManager*> SayCommandMap;
 SayCommandMap g_SayCommandMap;
 
+// Number of say commands per (case-folded) first character
+static unsigned int s_uiSayCommandPrefixes[256];
+
 //-----------------------------------------------------------------------------
 // Externs.
 //-----------------------------------------------------------------------------
@@ -68,6 +69,21 @@ int GetCommandIndex()
 	return g_SourcePythonPlugin.GetCommandIndex() + 1;
 }
 
+//-----------------------------------------------------------------------------
+// Returns whether the first token of the given message can be a say command.
+//-----------------------------------------------------------------------------
+static bool IsSayCommandPrefix(const char* szCommand)
+{
+	while (*szCommand && V_isspace((unsigned char) *szCommand))
+		++szCommand;
+
+	// Quoted tokens start after the quote
+	if (*szCommand == '"')
+		++szCommand;
+
+	return s_uiSayCommandPrefixes[StringMapFold(*szCommand)] != 0;
+}
+
 //-----------------------------------------------------------------------------
 // Registers the say and say_team commands.
 //-----------------------------------------------------------------------------
@@ -98,11 +114,12 @@ void BaseSayCommand::UnregisterCommands()
 CSayCommandManager* GetSayCommand(const char* szName)
 {
 	CSayCommandManager* manager = NULL;
-	SayCommandMap::iterator iter;
-	if (!find_manager<SayCommandMap, SayCommandMap::iterator>(g_SayCommandMap, szName, iter))
+	SayCommandMap::iterator iter = g_SayCommandMap.find(szName);
+	if (iter == g_SayCommandMap.end())
 	{
 		manager = new CSayCommandManager(szName);
-		g_SayCommandMap.insert(std::make_pair(manager->m_Name, manager));
+		g_SayCommandMap.insert(std::make_pair(std::string(manager->m_Name), manager));
+		s_uiSayCommandPrefixes[StringMapFold(szName[0])]++;
 	}
 	else
 	{
@@ -116,9 +133,10 @@ CSayCommandManager* GetSayCommand(const char* szName)
 //-----------------------------------------------------------------------------
 void RemoveCSayCommandManager(const char* szName)
 {
-	SayCommandMap::iterator iter;
-	if (find_manager<SayCommandMap, SayCommandMap::iterator>(g_SayCommandMap, szName, iter))
+	SayCommandMap::iterator iter = g_SayCommandMap.find(szName);
+	if (iter != g_SayCommandMap.end())
 	{
+		s_uiSayCommandPrefixes[StringMapFold(iter->first[0])]--;
 		delete iter->second;
 		g_SayCommandMap.erase(iter);
 	}
@@ -227,21 +245,30 @@ void SayConCommand::Dispatch( const CCommand& command )
 	// Get whether the command was say or say_team
 	bool bTeamOnly = strcmp(command.Arg(0), "say_team") == 0;
 
-	// Create a new CCommand object that does not contain the first argument
-	// (say or say_team) and is properly splitted
-	CCommand stripped_command = CCommand();
-	char szTempCommand[512];
-	strcpy(szTempCommand, command.ArgS());
-	char* szCommand = szTempCommand;
-
 	// Remove quotes (if existant), so the arguments are not recognized as a
-	// single argument.
-	int iLastCharPos = strlen(szCommand) - 1;
-	if (szCommand[0] == '"' && szCommand[iLastCharPos] == '"') {
-		szCommand[iLastCharPos] = '\0';
-		szCommand++;
+	// single argument. Only quoted messages have to be copied for that.
+	const char* szCommand = command.ArgS();
+	char szTempCommand[COMMAND_MAX_LENGTH];
+	size_t uiLength = strlen(szCommand);
+	if (uiLength && szCommand[0] == '"' && szCommand[uiLength - 1] == '"') {
+		size_t uiCopyLength = MIN(uiLength >= 2 ? uiLength - 2 : 0, sizeof(szTempCommand) - 1);
+		memcpy(szTempCommand, szCommand + 1, uiCopyLength);
+		szTempCommand[uiCopyLength] = '\0';
+		szCommand = szTempCommand;
 	}
 
+	// Without say filters, messages that can't start with a registered say
+	// command don't need to be tokenized or passed to Python.
+	if (!s_SayFilters.GetCount() && !IsSayCommandPrefix(szCommand)) {
+		if (m_pOldCommand)
+			m_pOldCommand->Dispatch(command);
+
+		return;
+	}
+
+	// Create a new CCommand object that does not contain the first argument
+	// (say or say_team) and is properly splitted
+	CCommand stripped_command = CCommand();
 	if (!stripped_command.Tokenize(szCommand)) {
 		PythonLog(0, "Failed to tokenize '%s'.", command.GetCommandString());
 		return;
@@ -265,8 +292,8 @@ void SayConCommand::Dispatch( const CCommand& command )
 		return;
 
 	block = false;
-	SayCommandMap::iterator iter;
-	if (find_manager<SayCommandMap, SayCommandMap::iterator>(g_SayCommandMap, stripped_command[0], iter))
+	SayCommandMap::iterator iter = g_SayCommandMap.find(stripped_command[0]);
+	if (iter != g_SayCommandMap.end())
 	{
 		if(iter->second->Dispatch(stripped_command, iIndex, bTeamOnly) == BLOCK)
 		{
@@ -30,6 +30,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include "utilities/sp_util.h"
+#include "utilities/string_map.h"
 #include "commands.h"
 #include "edict.h"
 #include "game/server/iplayerinfo.h"
@@ -91,4 +92,7 @@ public:
 	CListenerManager m_vecCallables;
 };
 
+// Say commands are matched case-insensitively
+typedef CaseStringMap_t<CSayCommandManager*> SayCommandMap;
+
 #endif // _COMMANDS_SAY_H
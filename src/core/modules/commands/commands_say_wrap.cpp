@@ -30,7 +30,6 @@
 #include "export_main.h"
 #include "utilities/wrap_macros.h"
 #include "modules/memory/memory_tools.h"
-#include "boost/unordered_map.hpp"
 #include "commands_say.h"
 
 
@@ -42,7 +41,7 @@ extern CSayCommandManager* GetSayCommand(const char* szName);
 extern void RegisterSayFilter(PyObject* pCallable);
 extern void UnregisterSayFilter(PyObject* pCallable);
 
-extern boost::unordered_map<std::string, CSayCommandManager*> g_SayCommandMap;
+extern SayCommandMap g_SayCommandMap;
 COMMAND_GENERATOR(SayCommandGenerator, g_SayCommandMap)
 
 
@@ -0,0 +1,333 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "modules/entities/entities_classnames.h"
+
+// C++
+#include <iterator>
+
+// SDK
+#include "edict.h"
+#include "toolframework/itoolentity.h"
+
+
+//-----------------------------------------------------------------------------
+// Externals.
+//-----------------------------------------------------------------------------
+extern IServerTools *servertools;
+extern CGlobalVars *gpGlobals;
+
+
+//-----------------------------------------------------------------------------
+// Helper functions.
+//-----------------------------------------------------------------------------
+// Returns the pooled classname of the given entity without raising.
+inline const char *GetPooledClassname(CBaseEntity *pEntity)
+{
+	IServerNetworkable *pNetworkable = pEntity->GetNetworkable();
+	if (!pNetworkable)
+		return NULL;
+
+	return pNetworkable->GetClassName();
+}
+
+
+//-----------------------------------------------------------------------------
+// CEntityClassIndex class.
+//-----------------------------------------------------------------------------
+CEntityClassIndex::CEntityClassIndex():
+	m_bPopulated(false),
+	m_nTickCount(-1)
+{
+	memset(m_Nodes, 0, sizeof(m_Nodes));
+	memset(&m_Pending, 0, sizeof(m_Pending));
+	memset(&m_Unnamed, 0, sizeof(m_Unnamed));
+}
+
+void CEntityClassIndex::OnEntityCreated(CBaseEntity *pEntity)
+{
+	// Nothing to keep up to date until someone queried us
+	if (!m_bPopulated)
+		return;
+
+	ClassIndexNode_t *pNode = GetNode(pEntity);
+	if (!pNode)
+		return;
+
+	if (pNode->m_pEntity)
+		Unlink(pNode);
+
+	pNode->m_pEntity = pEntity;
+	pNode->m_uiHandle = pEntity->GetRefEHandle().ToInt();
+	pNode->m_szClassname = NULL;
+
+	// The classname is only assigned once the constructor returned
+	Link(&m_Pending, pNode);
+}
+
+void CEntityClassIndex::OnEntitySpawned(CBaseEntity *pEntity)
+{
+	if (!m_bPopulated)
+		return;
+
+	ClassIndexNode_t *pNode = GetNode(pEntity);
+	if (pNode && pNode->m_pEntity == pEntity)
+		Refresh(pNode);
+}
+
+void CEntityClassIndex::OnEntityDeleted(CBaseEntity *pEntity)
+{
+	if (!m_bPopulated)
+		return;
+
+	ClassIndexNode_t *pNode = GetNode(pEntity);
+	if (!pNode || pNode->m_pEntity != pEntity)
+		return;
+
+	Unlink(pNode);
+	memset(pNode, 0, sizeof(ClassIndexNode_t));
+}
+
+void CEntityClassIndex::OnEntityRenamed(CBaseEntity *pEntity)
+{
+	if (!m_bPopulated)
+		return;
+
+	ClassIndexNode_t *pNode = GetNode(pEntity);
+	if (pNode && pNode->m_pEntity == pEntity)
+		Refresh(pNode);
+}
+
+CBaseEntity *CEntityClassIndex::Find(const char *szClassname)
+{
+	Revalidate();
+
+	ClassIndexLists_t::iterator it = m_mapLists.find(szClassname);
+	if (it == m_mapLists.end())
+		return NULL;
+
+	for (ClassIndexNode_t *pNode = it->second.m_pHead; pNode; pNode = pNode->m_pNext)
+	{
+		// Renamed during this frame, it will be moved on the next one
+		const char *szCurrent = GetPooledClassname(pNode->m_pEntity);
+		if (szCurrent && strcmp(szCurrent, szClassname) == 0)
+			return pNode->m_pEntity;
+	}
+
+	return NULL;
+}
+
+void CEntityClassIndex::Collect(const char *szClassname, bool bExactMatch, ClassIndexEntries_t &vecEntries)
+{
+	Revalidate();
+
+	ClassIndexLists_t::iterator it, end;
+	if (bExactMatch)
+	{
+		it = m_mapLists.find(szClassname);
+		end = it == m_mapLists.end() ? it : std::next(it);
+	}
+	else
+	{
+		// All classnames sharing the prefix are stored next to each other
+		size_t uiLength = strlen(szClassname);
+		it = m_mapLists.lower_bound(szClassname);
+		for (end = it; end != m_mapLists.end(); ++end)
+		{
+			if (end->first.compare(0, uiLength, szClassname) != 0)
+				break;
+		}
+	}
+
+	for (; it != end; ++it)
+	{
+		for (ClassIndexNode_t *pNode = it->second.m_pHead; pNode; pNode = pNode->m_pNext)
+		{
+			ClassIndexEntry_t entry = {pNode->m_pEntity, pNode->m_uiHandle};
+			vecEntries.push_back(entry);
+		}
+	}
+}
+
+bool CEntityClassIndex::IsAlive(const ClassIndexEntry_t &entry)
+{
+	ClassIndexNode_t *pNode = &m_Nodes[entry.m_uiHandle & ENT_ENTRY_MASK];
+	return pNode->m_pEntity == entry.m_pEntity && pNode->m_uiHandle == entry.m_uiHandle;
+}
+
+void CEntityClassIndex::Clear()
+{
+	memset(m_Nodes, 0, sizeof(m_Nodes));
+	memset(&m_Pending, 0, sizeof(m_Pending));
+	memset(&m_Unnamed, 0, sizeof(m_Unnamed));
+	m_mapLists.clear();
+
+	m_bPopulated = false;
+	m_nTickCount = -1;
+}
+
+ClassIndexNode_t *CEntityClassIndex::GetNode(CBaseEntity *pEntity)
+{
+	int iEntry = pEntity->GetRefEHandle().GetEntryIndex();
+	if (iEntry < 0 || iEntry >= NUM_ENT_ENTRIES)
+		return NULL;
+
+	return &m_Nodes[iEntry];
+}
+
+void CEntityClassIndex::Populate()
+{
+	m_bPopulated = true;
+
+	CBaseEntity *pEntity = (CBaseEntity *) servertools->FirstEntity();
+	while (pEntity)
+	{
+		OnEntityCreated(pEntity);
+		pEntity = (CBaseEntity *) servertools->NextEntity(pEntity);
+	}
+}
+
+void CEntityClassIndex::Refresh(ClassIndexNode_t *pNode)
+{
+	const char *szClassname = GetPooledClassname(pNode->m_pEntity);
+	if (szClassname == pNode->m_szClassname && pNode->m_pList != &m_Pending)
+		return;
+
+	pNode->m_szClassname = szClassname;
+
+	ClassIndexList_t *pList = &m_Unnamed;
+	if (szClassname && *szClassname)
+	{
+		ClassIndexLists_t::iterator it = m_mapLists.find(szClassname);
+		if (it == m_mapLists.end())
+		{
+			ClassIndexList_t list = {NULL, NULL, 0};
+			it = m_mapLists.insert(ClassIndexLists_t::value_type(szClassname, list)).first;
+		}
+
+		pList = &it->second;
+	}
+
+	if (pList != pNode->m_pList)
+	{
+		Unlink(pNode);
+		Link(pList, pNode);
+	}
+}
+
+void CEntityClassIndex::Revalidate()
+{
+	if (!m_bPopulated)
+		Populate();
+
+	// Classnames written through keyvalues are re-indexed immediately. Other
+	// writes to memory are caught once per tick, which only compares pooled
+	// pointers.
+	if (gpGlobals->tickcount == m_nTickCount)
+	{
+		// Entities created during this tick might have been named since
+		RevalidatePending();
+		return;
+	}
+
+	m_nTickCount = gpGlobals->tickcount;
+
+	// Entities that are still unnamed are moved to m_Unnamed, so they aren't
+	// walked on every query
+	RevalidateList(&m_Pending);
+	RevalidateList(&m_Unnamed);
+	for (ClassIndexLists_t::iterator it = m_mapLists.begin(); it != m_mapLists.end(); ++it)
+		RevalidateList(&it->second);
+}
+
+void CEntityClassIndex::RevalidatePending()
+{
+	ClassIndexNode_t *pNode = m_Pending.m_pHead;
+	while (pNode)
+	{
+		ClassIndexNode_t *pNext = pNode->m_pNext;
+
+		// Keep it pending until the constructor assigned a classname
+		const char *szClassname = GetPooledClassname(pNode->m_pEntity);
+		if (szClassname && *szClassname)
+			Refresh(pNode);
+
+		pNode = pNext;
+	}
+}
+
+void CEntityClassIndex::RevalidateList(ClassIndexList_t *pList)
+{
+	// Moved nodes are appended to their new list, so we won't miss any here
+	ClassIndexNode_t *pNode = pList->m_pHead;
+	while (pNode)
+	{
+		ClassIndexNode_t *pNext = pNode->m_pNext;
+		Refresh(pNode);
+		pNode = pNext;
+	}
+}
+
+void CEntityClassIndex::Link(ClassIndexList_t *pList, ClassIndexNode_t *pNode)
+{
+	pNode->m_pList = pList;
+	pNode->m_pPrev = pList->m_pTail;
+	pNode->m_pNext = NULL;
+
+	if (pList->m_pTail)
+		pList->m_pTail->m_pNext = pNode;
+	else
+		pList->m_pHead = pNode;
+
+	pList->m_pTail = pNode;
+	pList->m_uiCount++;
+}
+
+void CEntityClassIndex::Unlink(ClassIndexNode_t *pNode)
+{
+	ClassIndexList_t *pList = pNode->m_pList;
+	if (!pList)
+		return;
+
+	if (pNode->m_pPrev)
+		pNode->m_pPrev->m_pNext = pNode->m_pNext;
+	else
+		pList->m_pHead = pNode->m_pNext;
+
+	if (pNode->m_pNext)
+		pNode->m_pNext->m_pPrev = pNode->m_pPrev;
+	else
+		pList->m_pTail = pNode->m_pPrev;
+
+	pList->m_uiCount--;
+	pNode->m_pList = NULL;
+	pNode->m_pPrev = NULL;
+	pNode->m_pNext = NULL;
+}
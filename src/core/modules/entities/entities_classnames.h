@@ -0,0 +1,159 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _ENTITIES_CLASSNAMES_H
+#define _ENTITIES_CLASSNAMES_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "utilities/baseentity.h"
+
+// SDK
+#include "const.h"
+
+// C++
+#include <map>
+#include <string>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+struct ClassIndexList_t;
+
+
+//-----------------------------------------------------------------------------
+// ClassIndexNode_t structure.
+//-----------------------------------------------------------------------------
+struct ClassIndexNode_t
+{
+	CBaseEntity *m_pEntity;
+	unsigned int m_uiHandle;
+
+	// Pooled classname the entity was last indexed with
+	const char *m_szClassname;
+
+	ClassIndexList_t *m_pList;
+	ClassIndexNode_t *m_pPrev;
+	ClassIndexNode_t *m_pNext;
+};
+
+
+//-----------------------------------------------------------------------------
+// ClassIndexList_t structure.
+//-----------------------------------------------------------------------------
+struct ClassIndexList_t
+{
+	ClassIndexNode_t *m_pHead;
+	ClassIndexNode_t *m_pTail;
+	unsigned int m_uiCount;
+};
+
+
+//-----------------------------------------------------------------------------
+// ClassIndexEntry_t structure.
+//-----------------------------------------------------------------------------
+struct ClassIndexEntry_t
+{
+	CBaseEntity *m_pEntity;
+	unsigned int m_uiHandle;
+};
+
+typedef std::vector<ClassIndexEntry_t> ClassIndexEntries_t;
+
+// Ordered, so that prefix queries are a single lower_bound() away
+typedef std::map<std::string, ClassIndexList_t, std::less<> > ClassIndexLists_t;
+
+
+//-----------------------------------------------------------------------------
+// CEntityClassIndex class.
+//-----------------------------------------------------------------------------
+class CEntityClassIndex
+{
+public:
+	friend CEntityClassIndex *GetEntityClassIndex();
+
+private:
+	CEntityClassIndex();
+
+public:
+	void OnEntityCreated(CBaseEntity *pEntity);
+	void OnEntitySpawned(CBaseEntity *pEntity);
+	void OnEntityDeleted(CBaseEntity *pEntity);
+
+	// Re-indexes the entity right away after its classname was changed
+	void OnEntityRenamed(CBaseEntity *pEntity);
+
+	CBaseEntity *Find(const char *szClassname);
+
+	// Entries are grouped by classname. A prefix match visits the matching
+	// classnames in the order of the index, not in entity list order.
+	void Collect(const char *szClassname, bool bExactMatch, ClassIndexEntries_t &vecEntries);
+
+	// Returns whether the entry still refers to a living entity
+	bool IsAlive(const ClassIndexEntry_t &entry);
+
+	void Clear();
+
+private:
+	ClassIndexNode_t *GetNode(CBaseEntity *pEntity);
+
+	void Populate();
+	void Refresh(ClassIndexNode_t *pNode);
+	void Revalidate();
+	void RevalidateList(ClassIndexList_t *pList);
+	void RevalidatePending();
+
+	static void Link(ClassIndexList_t *pList, ClassIndexNode_t *pNode);
+	static void Unlink(ClassIndexNode_t *pNode);
+
+private:
+	bool m_bPopulated;
+	int m_nTickCount;
+
+	ClassIndexNode_t m_Nodes[NUM_ENT_ENTRIES];
+	ClassIndexLists_t m_mapLists;
+
+	// Entities created since the last tick that have no classname yet
+	ClassIndexList_t m_Pending;
+
+	// Entities that still had no classname on the next tick
+	ClassIndexList_t m_Unnamed;
+};
+
+
+// Singleton accessor.
+inline CEntityClassIndex *GetEntityClassIndex()
+{
+	static CEntityClassIndex *s_pEntityClassIndex = new CEntityClassIndex;
+	return s_pEntityClassIndex;
+}
+
+
+#endif // _ENTITIES_CLASSNAMES_H
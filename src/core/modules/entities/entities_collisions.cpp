@@ -117,6 +117,11 @@ void CCollisionManager::Finalize()
 
 	m_mapHooks.clear();
 
+	// Rules can be unregistered from a callback, while a trace is running
+	if (m_vecScopes.empty()) {
+		m_vecMemos.clear();
+	}
+
 	m_bInitialized = false;
 }
 
@@ -224,11 +229,10 @@ void CCollisionManager::RegisterHook(T tFunc, unsigned int uiFilterIndex, unsign
 		)
 	}
 
-	static CHookManager *pHookManager = GetHookManager();
 	void *pAddr = (void *)pFunc->m_ulAddr;
-	CHook *pHook = pHookManager->FindHook(pAddr);
+	CHook *pHook = FindHook(pAddr);
 	if (!pHook) {
-		pHook = pHookManager->HookFunction(pAddr, pFunc->m_pCallingConvention);
+		pHook = HookFunction(pAddr, pFunc->m_pCallingConvention);
 		if (!pHook) {
 			delete pFunc;
 			BOOST_RAISE_EXCEPTION(
@@ -341,6 +345,8 @@ bool CCollisionManager::EnterScope(HookType_t eHookType, CHook *pHook)
 	scope.m_uiIndex = uiIndex;
 	scope.m_bIsPlayer = ((CBaseEntityWrapper *)pWrapper->m_pPassEnt)->IsPlayer();
 	scope.m_pCache = pManager->GetCache(uiIndex);
+	scope.m_pMemo = pManager->GetMemo(pManager->m_vecScopes.size());
+	scope.m_pMemo->Reset();
 	scope.m_pExtraShouldHitCheckFunction = pWrapper->m_pExtraShouldHitCheckFunction;
 	pWrapper->m_pExtraShouldHitCheckFunction = (ShouldHitFunc_t)CCollisionManager::ShouldHitEntity;
 
@@ -378,7 +384,9 @@ bool CCollisionManager::ShouldHitEntity(IHandleEntity *pHandleEntity, int conten
 		return true;
 	}
 
-	CollisionScope_t scope = pManager->m_vecScopes.back();
+	// The scopes are stored in a deque, so this reference remains valid even
+	// if a callback starts another trace
+	const CollisionScope_t &scope = pManager->m_vecScopes.back();
 	if (scope.m_bSkip) {
 		return true;
 	}
@@ -401,18 +409,31 @@ bool CCollisionManager::ShouldHitEntity(IHandleEntity *pHandleEntity, int conten
 		}
 	}
 
+	// Candidates are often tested multiple times during the same trace
+	if (scope.m_pMemo->HasResult(uiIndex)) {
+		return scope.m_pMemo->GetResult(uiIndex);
+	}
+
+	bool bResult = pManager->CheckCollision(scope, pHandleEntity, uiIndex);
+	scope.m_pMemo->SetResult(uiIndex, bResult);
+
+	return bResult;
+}
+
+bool CCollisionManager::CheckCollision(const CollisionScope_t &scope, IHandleEntity *pHandleEntity, unsigned int uiIndex)
+{
 	object oEntity;
 	object oOther;
 
-	if (pManager->m_pCollisionHooks->GetCount()) {
+	if (m_pCollisionHooks->GetCount()) {
 		oEntity = GetEntityObject(scope.m_uiIndex);
 		oOther = GetEntityObject(uiIndex);
 
 		object oFilter = object(ptr((ITraceFilter *)scope.m_pFilter));
 
-		FOR_EACH_VEC(pManager->m_pCollisionHooks->m_vecCallables, i) {
+		FOR_EACH_VEC(m_pCollisionHooks->m_vecCallables, i) {
 			BEGIN_BOOST_PY()
-				object oResult = pManager->m_pCollisionHooks->m_vecCallables[i](oEntity, oOther, oFilter, scope.m_oMask);
+				object oResult = m_pCollisionHooks->m_vecCallables[i](oEntity, oOther, oFilter, scope.m_oMask);
 				if (!oResult.is_none() && !extract<bool>(oResult)) {
 					scope.m_pCache->SetResult(uiIndex, false);
 					return false;
@@ -425,15 +446,15 @@ bool CCollisionManager::ShouldHitEntity(IHandleEntity *pHandleEntity, int conten
 		return scope.m_pCache->GetResult(uiIndex);
 	}
 
-	FOR_EACH_VEC(pManager->m_vecRules, i) {
-		ICollisionRules *pRules = pManager->m_vecRules[i];
+	FOR_EACH_VEC(m_vecRules, i) {
+		ICollisionRules *pRules = m_vecRules[i];
 		if (!scope.m_bSolidContents && pRules->GetSolidOnly()) {
 			continue;
 		}
 
 		if (!pRules->ShouldCollide(
-				(CBaseEntityWrapper *)scope.m_pFilter->m_pPassEnt,
-				(CBaseEntityWrapper *)pHandleEntity)
+				(CBaseEntityWrapper *)scope.m_pFilter->m_pPassEnt, scope.m_uiIndex,
+				(CBaseEntityWrapper *)pHandleEntity, uiIndex)
 		) {
 			scope.m_pCache->SetResult(uiIndex, false);
 			return false;
@@ -512,6 +533,16 @@ CCollisionCache *CCollisionManager::GetCache(unsigned int uiIndex)
 	return pCache;
 }
 
+CCollisionCache *CCollisionManager::GetMemo(unsigned int uiDepth)
+{
+	// Growing a deque never moves the memos handed out to outer scopes
+	while (m_vecMemos.size() <= uiDepth) {
+		m_vecMemos.emplace_back();
+	}
+
+	return &m_vecMemos[uiDepth];
+}
+
 
 //-----------------------------------------------------------------------------
 // ICollisionRules class.
@@ -547,6 +578,11 @@ void ICollisionRules::SetSolidOnly(bool bSolidOnly)
 	m_bSolidOnly = bSolidOnly;
 }
 
+bool ICollisionRules::ShouldCollide(CBaseEntityWrapper *pEntity, unsigned int uiEntity, CBaseEntityWrapper *pOther, unsigned int uiOther)
+{
+	return ShouldCollide(pEntity, pOther);
+}
+
 
 //-----------------------------------------------------------------------------
 // CCollisionCache class.
@@ -567,10 +603,27 @@ void CCollisionCache::SetResult(unsigned int uiIndex, bool bResult)
 	m_vecCache.Set((int)uiIndex, bResult);
 }
 
+void CCollisionCache::Reset()
+{
+	ClearAll();
+	m_vecCache.ClearAll();
+}
+
 
 //-----------------------------------------------------------------------------
 // CCollisionHash class.
 //-----------------------------------------------------------------------------
+CCollisionHash::CCollisionHash():
+	m_uiSize(0)
+{
+	memset(m_pRows, 0, sizeof(m_pRows));
+}
+
+CCollisionHash::~CCollisionHash()
+{
+	Clear();
+}
+
 void CCollisionHash::OnEntityDeleted(CBaseEntityWrapper *pEntity)
 {
 	RemovePairs(pEntity);
@@ -582,10 +635,47 @@ bool CCollisionHash::ShouldCollide(CBaseEntityWrapper *pEntity, CBaseEntityWrapp
 		return true;
 	}
 
-	bool bResult = !HasPair(pEntity, pOther);
+	return ShouldCollide(pEntity, pEntity->GetIndex(), pOther, pOther->GetIndex());
+}
+
+bool CCollisionHash::ShouldCollide(CBaseEntityWrapper *pEntity, unsigned int uiEntity, CBaseEntityWrapper *pOther, unsigned int uiOther)
+{
+	if (!HasElements()) {
+		return true;
+	}
+
+	bool bResult = !HasPair(uiEntity, uiOther);
 	return GetMode() == COLLISION_MODE_ALLOW ? !bResult : bResult;
 }
 
+void CCollisionHash::SetPaired(unsigned int uiEntity, unsigned int uiOther, bool bPaired)
+{
+	CollisionRow_t *pRow = m_pRows[uiEntity];
+	if (!pRow) {
+		if (!bPaired) {
+			return;
+		}
+
+		pRow = new CollisionRow_t;
+		pRow->m_uiCount = 0;
+		pRow->m_vecEntities.ClearAll();
+		m_pRows[uiEntity] = pRow;
+	}
+
+	if (pRow->m_vecEntities.IsBitSet((int)uiOther) == bPaired) {
+		return;
+	}
+
+	pRow->m_vecEntities.Set((int)uiOther, bPaired);
+	if (bPaired) {
+		++pRow->m_uiCount;
+	}
+	else if (!--pRow->m_uiCount) {
+		delete pRow;
+		m_pRows[uiEntity] = NULL;
+	}
+}
+
 void CCollisionHash::AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther)
 {
 	if (!pEntity->IsNetworked() || !pOther->IsNetworked()) {
@@ -595,69 +685,96 @@ void CCollisionHash::AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pO
 		)
 	}
 
-	m_setPairs.insert(CollisionPair_t(pEntity, pOther));
+	unsigned int uiEntity = pEntity->GetIndex();
+	unsigned int uiOther = pOther->GetIndex();
+	if (HasPair(uiEntity, uiOther)) {
+		return;
+	}
+
+	SetPaired(uiEntity, uiOther, true);
+	SetPaired(uiOther, uiEntity, true);
+	++m_uiSize;
 }
 
 void CCollisionHash::RemovePair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther)
 {
-	m_setPairs.erase(CollisionPair_t(pEntity, pOther));
+	unsigned int uiEntity = pEntity->GetIndex();
+	unsigned int uiOther = pOther->GetIndex();
+	if (!HasPair(uiEntity, uiOther)) {
+		return;
+	}
+
+	SetPaired(uiEntity, uiOther, false);
+	SetPaired(uiOther, uiEntity, false);
+	--m_uiSize;
 }
 
 void CCollisionHash::RemovePairs(CBaseEntityWrapper *pEntity)
 {
-	for (CollisionPairs_t::const_iterator it = m_setPairs.begin(); it != m_setPairs.end(); ) {
-		if (it->first == pEntity || it->second == pEntity) {
-			it = m_setPairs.erase(it);
-			continue;
+	unsigned int uiEntity = pEntity->GetIndex();
+	CollisionRow_t *pRow = m_pRows[uiEntity];
+	if (!pRow) {
+		return;
+	}
+
+	// Only the rows of the paired entities need to be updated
+	for (int i = pRow->m_vecEntities.FindNextSetBit(0); i != -1; i = pRow->m_vecEntities.FindNextSetBit(i + 1)) {
+		if ((unsigned int)i != uiEntity) {
+			SetPaired((unsigned int)i, uiEntity, false);
 		}
 
-		++it;
+		--m_uiSize;
 	}
+
+	delete pRow;
+	m_pRows[uiEntity] = NULL;
 }
 
 void CCollisionHash::Clear()
 {
-	m_setPairs.clear();
+	for (unsigned int i=0; i < MAX_EDICTS; i++) {
+		if (m_pRows[i]) {
+			delete m_pRows[i];
+			m_pRows[i] = NULL;
+		}
+	}
+
+	m_uiSize = 0;
 }
 
 bool CCollisionHash::Contains(CBaseEntityWrapper *pEntity)
 {
-	BOOST_FOREACH(CollisionPair_t p, m_setPairs) {
-		if (p.first == pEntity || p.second == pEntity) {
-			return true;
-		}
-	}
+	return m_pRows[pEntity->GetIndex()] != NULL;
+}
 
-	return false;
+bool CCollisionHash::HasPair(unsigned int uiEntity, unsigned int uiOther)
+{
+	CollisionRow_t *pRow = m_pRows[uiEntity];
+	return pRow && pRow->m_vecEntities.IsBitSet((int)uiOther);
 }
 
 bool CCollisionHash::HasPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther)
 {
-	return m_setPairs.find(CollisionPair_t(pEntity, pOther)) != m_setPairs.end();
+	return HasPair(pEntity->GetIndex(), pOther->GetIndex());
 }
 
 unsigned int CCollisionHash::GetCount(CBaseEntityWrapper *pEntity)
 {
-	unsigned int nCount = 0;
-	BOOST_FOREACH(CollisionPair_t p, m_setPairs) {
-		if (p.first == pEntity || p.second == pEntity) {
-			++nCount;
-		}
-	}
-
-	return nCount;
+	CollisionRow_t *pRow = m_pRows[pEntity->GetIndex()];
+	return pRow ? pRow->m_uiCount : 0;
 }
 
 list CCollisionHash::GetPairs(CBaseEntityWrapper *pEntity)
 {
 	list oObjects;
-	BOOST_FOREACH(CollisionPair_t p, m_setPairs) {
-		if (p.first == pEntity) {
-			oObjects.append(GetEntityObject(p.second));
-		}
-		else if (p.second == pEntity) {
-			oObjects.append(GetEntityObject(p.first));
-		}
+
+	CollisionRow_t *pRow = m_pRows[pEntity->GetIndex()];
+	if (!pRow) {
+		return oObjects;
+	}
+
+	for (int i = pRow->m_vecEntities.FindNextSetBit(0); i != -1; i = pRow->m_vecEntities.FindNextSetBit(i + 1)) {
+		oObjects.append(GetEntityObject((unsigned int)i));
 	}
 
 	return oObjects;
@@ -665,12 +782,12 @@ list CCollisionHash::GetPairs(CBaseEntityWrapper *pEntity)
 
 unsigned int CCollisionHash::GetSize()
 {
-	return m_setPairs.size();
+	return m_uiSize;
 }
 
 bool CCollisionHash::HasElements()
 {
-	return !m_setPairs.empty();
+	return m_uiSize != 0;
 }
 
 object CCollisionHash::Iterate()
@@ -678,8 +795,16 @@ object CCollisionHash::Iterate()
 	list oEntities;
 
 	if (HasElements()) {
-		BOOST_FOREACH(CollisionPair_t it, m_setPairs) {
-			oEntities.append(make_tuple(GetEntityObject(it.first), GetEntityObject(it.second)));
+		for (unsigned int uiEntity=0; uiEntity < MAX_EDICTS; uiEntity++) {
+			CollisionRow_t *pRow = m_pRows[uiEntity];
+			if (!pRow) {
+				continue;
+			}
+
+			// Every pair is stored in both rows, so only yield it once
+			for (int i = pRow->m_vecEntities.FindNextSetBit(uiEntity); i != -1; i = pRow->m_vecEntities.FindNextSetBit(i + 1)) {
+				oEntities.append(make_tuple(GetEntityObject(uiEntity), GetEntityObject((unsigned int)i)));
+			}
 		}
 	}
 
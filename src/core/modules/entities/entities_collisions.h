@@ -36,6 +36,9 @@
 #include "modules/entities/entities_entity.h"
 #include "modules/memory/memory_hooks.h"
 
+// C++
+#include <deque>
+
 // Boost
 #include "boost/unordered_map.hpp"
 #include "boost/unordered_set.hpp"
@@ -62,9 +65,9 @@ class CCollisionCache;
 typedef boost::unordered_map<CHook *, CollisionHookData_t> CollisionHooksMap_t;
 
 typedef CBitVec<MAX_EDICTS> CollisionCache_t;
+typedef CBitVec<MAX_EDICTS> CollisionMask_t;
 typedef boost::unordered_map<unsigned int, CCollisionCache *> CollisionCacheMap_t;
 
-typedef std::pair<CBaseEntityWrapper *, CBaseEntityWrapper *> CollisionPair_t;
 typedef boost::unordered_map<CBaseEntityWrapper *, boost::shared_ptr<CCollisionSet> > CollisionMap_t;
 
 typedef boost::unordered_set<CBaseEntityWrapper *> CollisionSet_t;
@@ -93,6 +96,7 @@ struct CollisionScope_t
 	CTraceFilterSimpleWrapper *m_pFilter;
 	ShouldHitFunc_t m_pExtraShouldHitCheckFunction;
 	CCollisionCache *m_pCache;
+	CCollisionCache *m_pMemo;
 	object m_oMask;
 	bool m_bSolidContents;
 };
@@ -129,6 +133,9 @@ public:
 	virtual void OnEntityDeleted(CBaseEntityWrapper *pEntity) = 0;
 	virtual bool ShouldCollide(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther) = 0;
 
+	// Same as above, but with the already known indexes of both entities
+	virtual bool ShouldCollide(CBaseEntityWrapper *pEntity, unsigned int uiEntity, CBaseEntityWrapper *pOther, unsigned int uiOther);
+
 	virtual void Clear() = 0;
 	virtual void UnloadInstance();
 
@@ -145,27 +152,14 @@ private:
 
 
 //-----------------------------------------------------------------------------
-// CollisionPairs_t definition and specializations.
+// CollisionRow_t structure.
 //-----------------------------------------------------------------------------
-struct CollisionPairHash_t
-{
-	inline std::size_t operator()(CollisionPair_t const &p) const {
-		std::size_t s = 0;
-		boost::hash_combine(s, p.first < p.second ? p.first : p.second);
-		boost::hash_combine(s, p.first < p.second ? p.second : p.first);
-		return s;
-	}
-};
-
-struct CollisionPairEquals_t
+struct CollisionRow_t
 {
-	inline bool operator()(const CollisionPair_t &a, const CollisionPair_t &b) const {
-		return (a == b) || (a.first == b.second && a.second == b.first); 
-	}
+	unsigned int m_uiCount;
+	CollisionMask_t m_vecEntities;
 };
 
-typedef boost::unordered_set<CollisionPair_t, CollisionPairHash_t, CollisionPairEquals_t> CollisionPairs_t;
-
 
 //-----------------------------------------------------------------------------
 // CCollisionHash class.
@@ -173,8 +167,12 @@ typedef boost::unordered_set<CollisionPair_t, CollisionPairHash_t, CollisionPair
 class CCollisionHash : public ICollisionRules
 {
 public:
+	CCollisionHash();
+	~CCollisionHash();
+
 	void OnEntityDeleted(CBaseEntityWrapper *pEntity);
 	bool ShouldCollide(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
+	bool ShouldCollide(CBaseEntityWrapper *pEntity, unsigned int uiEntity, CBaseEntityWrapper *pOther, unsigned int uiOther);
 
 	void AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
 	void RemovePair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
@@ -183,6 +181,7 @@ public:
 	void Clear();
 
 	bool Contains(CBaseEntityWrapper *pEntity);
+	bool HasPair(unsigned int uiEntity, unsigned int uiOther);
 	bool HasPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
 
 	unsigned int GetCount(CBaseEntityWrapper *pEntity);
@@ -194,7 +193,12 @@ public:
 	object Iterate();
 
 private:
-	CollisionPairs_t m_setPairs;
+	void SetPaired(unsigned int uiEntity, unsigned int uiOther, bool bPaired);
+
+private:
+	// Entities paired with each entity, indexed by entity index
+	CollisionRow_t *m_pRows[MAX_EDICTS];
+	unsigned int m_uiSize;
 };
 
 
@@ -256,6 +260,7 @@ public:
 	bool HasResult(unsigned int uiIndex);
 	bool GetResult(unsigned int uiIndex);
 	void SetResult(unsigned int uiIndex, bool bResult);
+	void Reset();
 
 private:
 	CollisionCache_t m_vecCache;
@@ -303,21 +308,26 @@ private:
 	static bool ExitScope(HookType_t eHookType, CHook *pHook);
 
 	static bool ShouldHitEntity(IHandleEntity *pHandleEntity, int contentsMask);
+	bool CheckCollision(const CollisionScope_t &scope, IHandleEntity *pHandleEntity, unsigned int uiIndex);
 
 	CCollisionCache *GetCache(unsigned int uiIndex);
+	CCollisionCache *GetMemo(unsigned int uiDepth);
 
 private:
 	bool m_bInitialized;
 	unsigned int m_uiRefCount;
 	CUtlVector<ICollisionRules *> m_vecRules;
 	CollisionHooksMap_t m_mapHooks;
-	std::vector<CollisionScope_t> m_vecScopes;
+	std::deque<CollisionScope_t> m_vecScopes;
 
 	boost::unordered_set<unsigned int> m_setSolidMasks;
 
 	int m_nTickCount;
 	CollisionCacheMap_t m_mapCache;
 
+	// Results of the current traces, indexed by scope depth
+	std::deque<CCollisionCache> m_vecMemos;
+
 	CListenerManager *m_pCollisionHooks;
 };
 
@@ -153,7 +153,7 @@ void export_base_collision_rules(scope _collisions)
 	// Methods...
 	BaseCollisionRules.def(
 		"should_collide",
-		&ICollisionRules::ShouldCollide,
+		GET_METHOD(bool, ICollisionRules, ShouldCollide, CBaseEntityWrapper *, CBaseEntityWrapper *),
 		"Returns whether the given entities should collide with each other.\n"
 		"\n"
 		":rtype:\n"
@@ -255,7 +255,7 @@ void export_collision_hash(scope _collisions)
 
 	CollisionHash.def(
 		"has_pair",
-		&CCollisionHash::HasPair,
+		GET_METHOD(bool, CCollisionHash, HasPair, CBaseEntityWrapper *, CBaseEntityWrapper *),
 		"Returns whether the given pair is in the hash.\n"
 		"\n"
 		":rtype:\n"
@@ -28,10 +28,12 @@
 // >> INCLUDES
 // ============================================================================
 // Boost
-#include "boost/unordered_map.hpp"
+#include "boost/unordered/unordered_flat_map.hpp"
+#include "boost/unordered/unordered_node_map.hpp"
 
 // Source.Python
 #include "utilities/conversions.h"
+#include "utilities/string_map.h"
 
 #include "entities_datamaps.h"
 #include ENGINE_INCLUDE_PATH(entities_datamaps_wrap.h)
@@ -42,14 +44,21 @@ using namespace boost::placeholders;
 // ============================================================================
 // >> TYPEDEFS
 // ============================================================================
-typedef boost::unordered_map<std::string, int> OffsetsMap;
-typedef boost::unordered_map<std::string, OffsetsMap > DataMapsMap;
+typedef StringMap_t<int> OffsetsMap;
+typedef boost::unordered_flat_map<datamap_t*, OffsetsMap> DataMapsMap;
+typedef StringMap_t<typedescription_t*> DescriptionsMap;
+typedef boost::unordered_flat_map<datamap_t*, DescriptionsMap> DescriptionsCache;
+// Node based, so the fields returned by find_key_field() stay where they are
+typedef boost::unordered_node_map<std::string, KeyField_t, StringMapCaseHash, StringMapCaseEqual> KeyFieldsMap;
+typedef boost::unordered_flat_map<datamap_t*, KeyFieldsMap> KeyFieldsCache;
 
 
 // ============================================================================
 // >> GLOBAL VARIABLES
 // ============================================================================
 DataMapsMap g_DataMapsCache;
+DescriptionsCache g_DescriptionsCache;
+KeyFieldsCache g_KeyFieldsCache;
 
 
 // ============================================================================
@@ -68,14 +77,14 @@ void AddDataDesc(typedescription_t& dataDesc, OffsetsMap& offsets, int offset, c
 
 	int currentOffset = offset + TypeDescriptionExt::get_offset(dataDesc);
 
-	char* currentName = NULL;
+	const char* currentName = NULL;
+	char tempName[256];
 	if (baseName == NULL) {
-		currentName = (char*) dataDesc.fieldName;
+		currentName = dataDesc.fieldName;
 	}
 	else {
-		char tempName[256];
-		sprintf(tempName, "%s.%s", baseName, dataDesc.fieldName);
-		currentName = strdup(tempName);
+		V_snprintf(tempName, sizeof(tempName), "%s.%s", baseName, dataDesc.fieldName);
+		currentName = tempName;
 	}
 
 	if (dataDesc.fieldType == FIELD_EMBEDDED)
@@ -84,7 +93,7 @@ void AddDataDesc(typedescription_t& dataDesc, OffsetsMap& offsets, int offset, c
 	}
 	else
 	{
-		offsets.insert(std::make_pair(currentName, currentOffset));
+		offsets.emplace(currentName, currentOffset);
 	}
 }
 
@@ -96,6 +105,26 @@ void AddDataMap(datamap_t* pDataMap, OffsetsMap& offsets, int offset, const char
 	}
 }
 
+void AddDescriptions(datamap_t* pDataMap, DescriptionsMap& descriptions)
+{
+	// Same order as a linear search, so the first match wins
+	for (; pDataMap; pDataMap = pDataMap->baseMap)
+	{
+		for (int i=0; i < pDataMap->dataNumFields; i++)
+		{
+			typedescription_t& dataDesc = pDataMap->dataDesc[i];
+			if (dataDesc.fieldName)
+				descriptions.emplace(dataDesc.fieldName, &dataDesc);
+
+			if (dataDesc.externalName)
+				descriptions.emplace(dataDesc.externalName, &dataDesc);
+
+			if (dataDesc.fieldType == FIELD_EMBEDDED)
+				AddDescriptions(dataDesc.td, descriptions);
+		}
+	}
+}
+
 
 // ============================================================================
 // >> DataMapSharedExt
@@ -111,51 +140,89 @@ typedescription_t& DataMapSharedExt::__getitem__(const datamap_t& pDataMap, int
 
 typedescription_t* DataMapSharedExt::find(datamap_t* pDataMap, const char *szName)
 {
-	while (pDataMap)
+	if (!pDataMap)
+		return NULL;
+
+	DescriptionsCache::iterator descriptions = g_DescriptionsCache.find(pDataMap);
+	if (descriptions == g_DescriptionsCache.end())
 	{
-		for (int iCurrentIndex=0; iCurrentIndex < pDataMap->dataNumFields; iCurrentIndex++)
-		{
-			typedescription_t& pCurrentDataDesc = pDataMap->dataDesc[iCurrentIndex];
-			if ((pCurrentDataDesc.fieldName && strcmp(szName, pCurrentDataDesc.fieldName) == 0) ||
-				(pCurrentDataDesc.externalName && strcmp(szName, pCurrentDataDesc.externalName) == 0))
-			{
-				return &(pDataMap->dataDesc[iCurrentIndex]);
-			}
-			else if (pCurrentDataDesc.fieldType == FIELD_EMBEDDED)
-			{
-				typedescription_t *pReturnValue = find(pCurrentDataDesc.td, szName);
-				if (pReturnValue)
-				{
-					return pReturnValue;
-				}
-			}
-		}
-		pDataMap = pDataMap->baseMap;
+		descriptions = g_DescriptionsCache.emplace(pDataMap, DescriptionsMap()).first;
+		AddDescriptions(pDataMap, descriptions->second);
 	}
-	return NULL;
+
+	DescriptionsMap::iterator result = descriptions->second.find(szName);
+	if (result == descriptions->second.end())
+		return NULL;
+
+	return result->second;
 }
 
 int DataMapSharedExt::find_offset(datamap_t* pDataMap, const char* name)
 {
-	while (pDataMap)
+	if (!pDataMap)
+		return -1;
+
+	DataMapsMap::iterator offsets = g_DataMapsCache.find(pDataMap);
+	if (offsets == g_DataMapsCache.end())
 	{
-		DataMapsMap::iterator offsets = g_DataMapsCache.find(pDataMap->dataClassName);
-		if (offsets == g_DataMapsCache.end())
+		offsets = g_DataMapsCache.emplace(pDataMap, OffsetsMap()).first;
+
+		// Add the derived maps first, so their fields hide the ones of their
+		// base maps.
+		for (datamap_t* pCurrent = pDataMap; pCurrent; pCurrent = pCurrent->baseMap)
 		{
-			offsets = g_DataMapsCache.insert(std::make_pair(pDataMap->dataClassName, OffsetsMap())).first;
-			AddDataMap(pDataMap, offsets->second);
+			AddDataMap(pCurrent, offsets->second);
 		}
-		
-		OffsetsMap::iterator result = offsets->second.find(name);
-		if (result == offsets->second.end())
+	}
+
+	OffsetsMap::iterator result = offsets->second.find(name);
+	if (result == offsets->second.end())
+		return -1;
+
+	return result->second;
+}
+
+KeyField_t* DataMapSharedExt::find_key_field(datamap_t* pDataMap, const char* szName)
+{
+	KeyFieldsMap& fields = g_KeyFieldsCache[pDataMap];
+	KeyFieldsMap::iterator result = fields.find(szName);
+	if (result == fields.end())
+	{
+		// Resolve the KeyValue the same way the engine does. Fields that are
+		// not found or that are arrays are cached as well, so we don't look
+		// them up again.
+		KeyField_t current = {0, FIELD_VOID, KEY_FIELD_ENGINE};
+		bool bFound = false;
+		for (datamap_t* pCurrentMap = pDataMap; pCurrentMap && !bFound; pCurrentMap = pCurrentMap->baseMap)
 		{
-			pDataMap = pDataMap->baseMap;
-		}
-		else {
-			return result->second;
+			for (int iCurrentIndex=0; iCurrentIndex < pCurrentMap->dataNumFields; iCurrentIndex++)
+			{
+				typedescription_t& pCurrentDataDesc = pCurrentMap->dataDesc[iCurrentIndex];
+				if (!(pCurrentDataDesc.flags & FTYPEDESC_KEY) || !pCurrentDataDesc.externalName ||
+					V_stricmp(szName, pCurrentDataDesc.externalName) != 0)
+				{
+					continue;
+				}
+
+				if (pCurrentDataDesc.fieldSize == 1)
+				{
+					current.m_iOffset = TypeDescriptionExt::get_offset(pCurrentDataDesc);
+					current.m_FieldType = pCurrentDataDesc.fieldType;
+					current.m_eState = KEY_FIELD_UNVERIFIED;
+				}
+
+				bFound = true;
+				break;
+			}
 		}
+
+		result = fields.emplace(szName, current).first;
 	}
-	return -1;
+
+	if (result->second.m_eState == KEY_FIELD_ENGINE)
+		return NULL;
+
+	return &result->second;
 }
 
 
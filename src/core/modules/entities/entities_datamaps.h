@@ -46,6 +46,29 @@
 BOOST_FUNCTION_TYPEDEF(void (CBaseEntity*, inputdata_t&), BoostInputFn)
 
 
+//-----------------------------------------------------------------------------
+// A datamap field that is exposed as a KeyValue.
+//-----------------------------------------------------------------------------
+enum KeyFieldState_t
+{
+	// The engine's GetKeyValue has not been compared to the field yet
+	KEY_FIELD_UNVERIFIED,
+
+	// The field holds what GetKeyValue returns, so it can be read directly
+	KEY_FIELD_DIRECT,
+
+	// GetKeyValue is overridden or handles the name itself
+	KEY_FIELD_ENGINE
+};
+
+struct KeyField_t
+{
+	int m_iOffset;
+	fieldtype_t m_FieldType;
+	KeyFieldState_t m_eState;
+};
+
+
 //-----------------------------------------------------------------------------
 // datamap_t extension class.
 //-----------------------------------------------------------------------------
@@ -55,6 +78,7 @@ public:
 	static typedescription_t& __getitem__(const datamap_t& pDataMap, int iIndex);
 	static typedescription_t* find(datamap_t* pDataMap, const char *szName);
 	static int find_offset(datamap_t* pDataMap, const char* name);
+	static KeyField_t* find_key_field(datamap_t* pDataMap, const char* szName);
 };
 
 
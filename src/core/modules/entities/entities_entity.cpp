@@ -27,12 +27,17 @@
 // ============================================================================
 // >> INCLUDES
 // ============================================================================
+// C++
+#include <algorithm>
+#include <vector>
+
 // Source.Python
 #include "utilities/conversions.h"
 #include "entities_entity.h"
 #include "entities_props.h"
 #include "entities_factories.h"
 #include "entities_datamaps.h"
+#include "entities_classnames.h"
 #include "modules/physics/physics.h"
 #include ENGINE_INCLUDE_PATH(entities_datamaps_wrap.h)
 #include "../engines/engines.h"
@@ -42,6 +47,7 @@
 // >> External variables
 // ============================================================================
 extern IMDLCache *modelcache;
+extern IVEngineServer *engine;
 
 
 // ============================================================================
@@ -113,15 +119,7 @@ object CBaseEntityWrapper::create(object cls, const char *name)
 
 CBaseEntity* CBaseEntityWrapper::find(const char* name)
 {
-	CBaseEntity* pEntity = (CBaseEntity *) servertools->FirstEntity();
-	while (pEntity)
-	{
-		if (strcmp(IServerUnknownExt::GetClassname(pEntity), name) == 0)
-			return pEntity;
-
-		pEntity = (CBaseEntity*) servertools->NextEntity(pEntity);
-	}
-	return NULL;
+	return GetEntityClassIndex()->Find(name);
 }
 
 object CBaseEntityWrapper::find(object cls, const char *name)
@@ -307,6 +305,141 @@ bool CBaseEntityWrapper::operator==(object other)
 	return GetThis() == pOther;
 }
 
+void CBaseEntityWrapper::NetworkStateChanged()
+{
+	GetEdict()->StateChanged();
+}
+
+void CBaseEntityWrapper::NetworkStateChanged(int offset)
+{
+	NetworkStateChanged(&offset, 1);
+}
+
+void CBaseEntityWrapper::NetworkStateChanged(const int* pOffsets, int iCount)
+{
+	// This is CBaseEdict::StateChanged(unsigned short), except that all
+	// offsets are added to the same change info. We can't use the SDK's
+	// version, because g_pSharedChangeInfo is only set up by the game.
+	edict_t* pEdict = GetEdict();
+	if (pEdict->m_fStateFlags & FL_FULL_EDICT_CHANGED)
+		return;
+
+	pEdict->m_fStateFlags |= FL_EDICT_CHANGED;
+
+	static CSharedEdictChangeInfo* pSharedChangeInfo = engine->GetSharedEdictChangeInfo();
+	IChangeInfoAccessor* pAccessor = engine->GetChangeAccessor(pEdict);
+
+	CEdictChangeInfo* pChangeInfo;
+	if (pAccessor->GetChangeInfoSerialNumber() == pSharedChangeInfo->m_iSerialNumber)
+	{
+		pChangeInfo = &pSharedChangeInfo->m_ChangeInfos[pAccessor->GetChangeInfo()];
+	}
+	else if (pSharedChangeInfo->m_nChangeInfos == MAX_EDICT_CHANGE_INFOS)
+	{
+		// No room left to remember which offsets changed
+		pAccessor->SetChangeInfoSerialNumber(0);
+		pEdict->m_fStateFlags |= FL_FULL_EDICT_CHANGED;
+		return;
+	}
+	else
+	{
+		pAccessor->SetChangeInfo(pSharedChangeInfo->m_nChangeInfos);
+		pSharedChangeInfo->m_nChangeInfos++;
+		pAccessor->SetChangeInfoSerialNumber(pSharedChangeInfo->m_iSerialNumber);
+
+		pChangeInfo = &pSharedChangeInfo->m_ChangeInfos[pAccessor->GetChangeInfo()];
+		pChangeInfo->m_nChangeOffsets = 0;
+	}
+
+	for (int i=0; i < iCount; i++)
+	{
+		int offset = pOffsets[i];
+		if (offset <= 0 || offset > USHRT_MAX || pChangeInfo->m_nChangeOffsets == MAX_CHANGE_OFFSETS)
+		{
+			pAccessor->SetChangeInfoSerialNumber(0);
+			pEdict->m_fStateFlags |= FL_FULL_EDICT_CHANGED;
+			return;
+		}
+
+		bool bFound = false;
+		for (unsigned short j=0; j < pChangeInfo->m_nChangeOffsets; j++)
+		{
+			if (pChangeInfo->m_ChangeOffsets[j] == offset)
+			{
+				bFound = true;
+				break;
+			}
+		}
+
+		if (!bFound)
+			pChangeInfo->m_ChangeOffsets[pChangeInfo->m_nChangeOffsets++] = (unsigned short) offset;
+	}
+}
+
+void CBaseEntityWrapper::network_state_changed(object offsets)
+{
+	if (offsets.is_none())
+	{
+		NetworkStateChanged();
+		return;
+	}
+
+	extract<int> offset(offsets);
+	if (offset.check())
+	{
+		NetworkStateChanged(offset());
+		return;
+	}
+
+	std::vector<int> vecOffsets;
+	object iterator = offsets.attr("__iter__")();
+	while (true)
+	{
+		PyObject* pItem = PyIter_Next(iterator.ptr());
+		if (!pItem)
+		{
+			if (PyErr_Occurred())
+				throw_error_already_set();
+
+			break;
+		}
+
+		vecOffsets.push_back(extract<int>(object(handle<>(pItem))));
+	}
+
+	if (!vecOffsets.empty())
+		NetworkStateChanged(&vecOffsets[0], (int) vecOffsets.size());
+}
+
+KeyField_t* CBaseEntityWrapper::FindKeyField(const char* szName)
+{
+	datamap_t* datamap = GetDataDescMap();
+	if (!datamap)
+		return NULL;
+
+	return DataMapSharedExt::find_key_field(datamap, szName);
+}
+
+void CBaseEntityWrapper::VerifyKeyField(KeyField_t* pField, bool bEqual, bool bSignificant)
+{
+	if (pField->m_eState != KEY_FIELD_UNVERIFIED)
+		return;
+
+	// A class can override GetKeyValue, and the engine handles some names
+	// before it looks at the datamap. Default values match either way, so
+	// only trust the field once it matched a value that isn't one.
+	if (!bEqual)
+		pField->m_eState = KEY_FIELD_ENGINE;
+	else if (bSignificant)
+		pField->m_eState = KEY_FIELD_DIRECT;
+}
+
+// The engine formats floats as text, so allow for the lost precision
+inline bool KeyValueFloatEquals(double dEngine, double dDirect)
+{
+	return fabs(dEngine - dDirect) <= 1e-6 * std::max(1.0, fabs(dDirect));
+}
+
 void CBaseEntityWrapper::GetKeyValueStringRaw(const char* szName, char* szOut, int iLength)
 {
 	*szOut = NULL;
@@ -320,20 +453,62 @@ void CBaseEntityWrapper::GetKeyValueStringRaw(const char* szName, char* szOut, i
 
 str CBaseEntityWrapper::GetKeyValueString(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	const char* szDirect = NULL;
+	if (pField) {
+		switch (pField->m_FieldType) {
+			case FIELD_STRING:
+			case FIELD_MODELNAME:
+			case FIELD_SOUNDNAME:
+				szDirect = STRING(GetDatamapPropertyByOffset<string_t>(pField->m_iOffset));
+				if (pField->m_eState == KEY_FIELD_DIRECT)
+					return str(szDirect);
+				break;
+			default:
+				break;
+		}
+	}
+
 	char szResult[MAX_KEY_VALUE_LENGTH];
 	GetKeyValueStringRaw(szName, szResult, MAX_KEY_VALUE_LENGTH);
+	const char* szValue = szResult;
 
 	// TODO: Don't hardcode this
 	// Fix for field name "model". I think a string_t object is copied to szResult.
 	// https://developer.valvesoftware.com/wiki/Team_train_watcher
 	if (strcmp(szName, "model") == 0 || strcmp(szName, "train") == 0 || strcmp(szName, "LightningStart") == 0)
-		return str(*(const char **) szResult);
+		szValue = *(const char **) szResult;
+
+	if (szDirect && szValue)
+		VerifyKeyField(pField, strcmp(szValue, szDirect) == 0, *szValue != '\0');
 
-	return str(szResult);
+	return str(szValue);
 }
 
 long CBaseEntityWrapper::GetKeyValueInt(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL;
+	long iDirect = 0;
+	if (bDirect) {
+		switch (pField->m_FieldType) {
+			case FIELD_INTEGER:
+			case FIELD_TICK:
+				iDirect = GetDatamapPropertyByOffset<int>(pField->m_iOffset); break;
+			case FIELD_SHORT:
+				iDirect = GetDatamapPropertyByOffset<short>(pField->m_iOffset); break;
+			case FIELD_CHARACTER:
+				iDirect = GetDatamapPropertyByOffset<char>(pField->m_iOffset); break;
+			case FIELD_BOOLEAN:
+				iDirect = GetDatamapPropertyByOffset<bool>(pField->m_iOffset); break;
+			default:
+				bDirect = false;
+		}
+
+		if (bDirect && pField->m_eState == KEY_FIELD_DIRECT)
+			return iDirect;
+	}
+
 	char szResult[128];
 	GetKeyValueStringRaw(szName, szResult, 128);
 		
@@ -341,11 +516,30 @@ long CBaseEntityWrapper::GetKeyValueInt(const char* szName)
 	if (!sputils::UTIL_StringToLong(&iResult, szResult))
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "KeyValue does not seem to be an integer: '%s'.", szResult);
 
+	if (bDirect)
+		VerifyKeyField(pField, iResult == iDirect, iResult != 0);
+
 	return iResult;
 }
 
 double CBaseEntityWrapper::GetKeyValueFloat(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL;
+	double dDirect = 0;
+	if (bDirect) {
+		switch (pField->m_FieldType) {
+			case FIELD_FLOAT:
+			case FIELD_TIME:
+				dDirect = GetDatamapPropertyByOffset<float>(pField->m_iOffset); break;
+			default:
+				bDirect = false;
+		}
+
+		if (bDirect && pField->m_eState == KEY_FIELD_DIRECT)
+			return dDirect;
+	}
+
 	char szResult[128];
 	GetKeyValueStringRaw(szName, szResult, 128);
 		
@@ -353,11 +547,30 @@ double CBaseEntityWrapper::GetKeyValueFloat(const char* szName)
 	if (!sputils::UTIL_StringToDouble(&dResult, szResult))
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "KeyValue does not seem to be a float: '%s'.", szResult);
 
+	if (bDirect)
+		VerifyKeyField(pField, KeyValueFloatEquals(dResult, dDirect), dResult != 0);
+
 	return dResult;
 }
 
 Vector CBaseEntityWrapper::GetKeyValueVector(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL;
+	Vector vecDirect(0, 0, 0);
+	if (bDirect) {
+		switch (pField->m_FieldType) {
+			case FIELD_VECTOR:
+			case FIELD_POSITION_VECTOR:
+				vecDirect = GetDatamapPropertyByOffset<Vector>(pField->m_iOffset); break;
+			default:
+				bDirect = false;
+		}
+
+		if (bDirect && pField->m_eState == KEY_FIELD_DIRECT)
+			return vecDirect;
+	}
+
 	char szResult[128];
 	GetKeyValueStringRaw(szName, szResult, 128);
 
@@ -365,11 +578,33 @@ Vector CBaseEntityWrapper::GetKeyValueVector(const char* szName)
 	if (!sputils::UTIL_StringToFloatArray(fResult, 3, szResult))
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "KeyValue does not seem to be a vector: '%s'.", szResult);
 
+	if (bDirect)
+		VerifyKeyField(pField,
+			KeyValueFloatEquals(fResult[0], vecDirect.x) &&
+			KeyValueFloatEquals(fResult[1], vecDirect.y) &&
+			KeyValueFloatEquals(fResult[2], vecDirect.z),
+			fResult[0] != 0 || fResult[1] != 0 || fResult[2] != 0);
+
 	return Vector(fResult[0], fResult[1], fResult[2]);
 }
 
 QAngle CBaseEntityWrapper::GetKeyValueQAngle(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL;
+	QAngle angDirect(0, 0, 0);
+	if (bDirect) {
+		switch (pField->m_FieldType) {
+			case FIELD_VECTOR:
+				angDirect = GetDatamapPropertyByOffset<QAngle>(pField->m_iOffset); break;
+			default:
+				bDirect = false;
+		}
+
+		if (bDirect && pField->m_eState == KEY_FIELD_DIRECT)
+			return angDirect;
+	}
+
 	char szResult[128];
 	GetKeyValueStringRaw(szName, szResult, 128);
 
@@ -377,28 +612,58 @@ QAngle CBaseEntityWrapper::GetKeyValueQAngle(const char* szName)
 	if (!sputils::UTIL_StringToFloatArray(fResult, 3, szResult))
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "KeyValue does not seem to be an angle: '%s'.", szResult);
 
+	if (bDirect)
+		VerifyKeyField(pField,
+			KeyValueFloatEquals(fResult[0], angDirect.x) &&
+			KeyValueFloatEquals(fResult[1], angDirect.y) &&
+			KeyValueFloatEquals(fResult[2], angDirect.z),
+			fResult[0] != 0 || fResult[1] != 0 || fResult[2] != 0);
+
 	return QAngle(fResult[0], fResult[1], fResult[2]);
 }
 
 bool CBaseEntityWrapper::GetKeyValueBool(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL && pField->m_FieldType == FIELD_BOOLEAN;
+	bool bDirectValue = false;
+	if (bDirect) {
+		bDirectValue = GetDatamapPropertyByOffset<bool>(pField->m_iOffset);
+		if (pField->m_eState == KEY_FIELD_DIRECT)
+			return bDirectValue;
+	}
+
 	char szResult[3];
 	GetKeyValueStringRaw(szName, szResult, 3);
 	if (szResult[1] != '\0')
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "KeyValue does not seem to be a boolean: '%s'.", szResult);
 
+	bool bResult = false;
 	if (szResult[0] == '1')
-		return true;
+		bResult = true;
 	else if (szResult[0] == '0')
-		return false;
+		bResult = false;
 	else
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Invalid boolean value: '%c'.", szResult[0]);
 
-	return false; // to fix a warning.
+	if (bDirect)
+		VerifyKeyField(pField, bResult == bDirectValue, bResult);
+
+	return bResult;
 }
 
 Color CBaseEntityWrapper::GetKeyValueColor(const char* szName)
 {
+	KeyField_t* pField = FindKeyField(szName);
+	bool bDirect = pField != NULL && pField->m_FieldType == FIELD_COLOR32;
+	Color colorDirect;
+	if (bDirect) {
+		color32 color = GetDatamapPropertyByOffset<color32>(pField->m_iOffset);
+		colorDirect = Color(color.r, color.g, color.b, color.a);
+		if (pField->m_eState == KEY_FIELD_DIRECT)
+			return colorDirect;
+	}
+
 	char szResult[128];
 	GetKeyValueStringRaw(szName, szResult, 128);
 
@@ -411,15 +676,29 @@ Color CBaseEntityWrapper::GetKeyValueColor(const char* szName)
 	// If we got values bigger than 255, it's not a hard-coded keyvalue, but one that is read
 	// from the datamap. Those are incorrectly parsed by the SDK (int* should be unsiged char*):
 	// https://github.com/alliedmodders/hl2sdk/blob/0ef5d3d482157bc0bb3aafd37c08961373f87bfd/game/server/saverestore_gamedll.cpp#L205-L211
+	Color colorResult;
 	if (iResult[0] > 255 || iResult[1] > 255 || iResult[2] > 255 || iResult[3] > 255) {
-		return Color(
+		colorResult = Color(
 				iResult[0] & 0xff,
 				(iResult[0] & 0xff00) >> 8,
 				(iResult[0] & 0xff0000) >> 16,
 				(iResult[0] & 0xff000000) >> 24);
 	}
+	else {
+		colorResult = Color(iResult[0], iResult[1], iResult[2], iResult[3]);
+	}
+
+	if (bDirect)
+		VerifyKeyField(pField, colorResult == colorDirect, colorResult.GetRawColor() != 0);
 
-	return Color(iResult[0], iResult[1], iResult[2], iResult[3]);
+	return colorResult;
+}
+
+void CBaseEntityWrapper::OnKeyValueChanged(const char* szName)
+{
+	// Keep Entity.find() and EntityIter in sync with renamed entities
+	if (V_stricmp(szName, "classname") == 0)
+		GetEntityClassIndex()->OnEntityRenamed(GetThis());
 }
 
 void CBaseEntityWrapper::SetKeyValueColor(const char* szName, Color& color)
@@ -1040,3 +1319,305 @@ void CBaseEntityWrapper::StopSound(const char* sample, int channel)
 {
 	IEngineSoundExt::StopSound(enginesound, GetIndex(), channel, sample);
 }
+
+
+// ============================================================================
+// >> CEntityCache
+// ============================================================================
+static std::vector<CEntityCache *> &GetEntityCaches()
+{
+	static std::vector<CEntityCache *> s_vecCaches;
+	return s_vecCaches;
+}
+
+// Cache that holds the instance returned by GetEntityObject for each index.
+static CEntityCache *s_pObjectCaches[MAX_EDICTS] = {NULL};
+
+CEntityCache::CEntityCache()
+{
+	memset(m_Slots, 0, sizeof(m_Slots));
+	m_uiCount = 0;
+
+	GetEntityCaches().push_back(this);
+}
+
+CEntityCache::~CEntityCache()
+{
+	std::vector<CEntityCache *> &vecCaches = GetEntityCaches();
+	vecCaches.erase(std::remove(vecCaches.begin(), vecCaches.end(), this), vecCaches.end());
+
+	for (unsigned int i = 0; i < MAX_EDICTS; ++i) {
+		if (s_pObjectCaches[i] == this) {
+			s_pObjectCaches[i] = NULL;
+		}
+
+		Py_XDECREF(m_Slots[i].m_pObject);
+	}
+}
+
+PyObject *CEntityCache::Lookup(unsigned int uiIndex)
+{
+	if (uiIndex >= MAX_EDICTS || !m_Slots[uiIndex].m_pObject) {
+		return NULL;
+	}
+
+	// Drop instances that were cached for a previous entity of that index
+	unsigned int uiHandle;
+	if (!IntHandleFromIndex(uiIndex, uiHandle) || m_Slots[uiIndex].m_uiHandle != uiHandle) {
+		Py_DECREF(Release(uiIndex));
+		return NULL;
+	}
+
+	return m_Slots[uiIndex].m_pObject;
+}
+
+PyObject *CEntityCache::Release(unsigned int uiIndex)
+{
+	EntityCacheSlot_t &slot = m_Slots[uiIndex];
+
+	PyObject *pObject = slot.m_pObject;
+	if (pObject) {
+		slot.m_pObject = NULL;
+		slot.m_uiHandle = 0;
+		--m_uiCount;
+	}
+
+	return pObject;
+}
+
+PyObject *CEntityCache::Lookup(object oIndex, unsigned int &uiIndex)
+{
+	// Like a dict, keys that can't be an index are simply not in the cache
+	if (!PyLong_Check(oIndex.ptr())) {
+		return NULL;
+	}
+
+	long long llIndex = PyLong_AsLongLong(oIndex.ptr());
+	if (llIndex == -1 && PyErr_Occurred()) {
+		PyErr_Clear();
+		return NULL;
+	}
+
+	if (llIndex < 0 || llIndex >= MAX_EDICTS) {
+		return NULL;
+	}
+
+	uiIndex = (unsigned int) llIndex;
+	return Lookup(uiIndex);
+}
+
+object CEntityCache::GetItem(object oIndex)
+{
+	unsigned int uiIndex;
+	PyObject *pObject = Lookup(oIndex, uiIndex);
+	if (!pObject) {
+		PyErr_SetObject(PyExc_KeyError, oIndex.ptr());
+		throw_error_already_set();
+	}
+
+	return object(handle<>(borrowed(pObject)));
+}
+
+void CEntityCache::SetItem(unsigned int uiIndex, object oEntity)
+{
+	unsigned int uiHandle;
+	if (uiIndex >= MAX_EDICTS || !IntHandleFromIndex(uiIndex, uiHandle)) {
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Invalid index: %u", uiIndex)
+	}
+
+	EntityCacheSlot_t &slot = m_Slots[uiIndex];
+
+	// Swap before releasing, the old instance may call back into the cache
+	PyObject *pOld = slot.m_pObject;
+	slot.m_pObject = incref(oEntity.ptr());
+	slot.m_uiHandle = uiHandle;
+
+	if (pOld) {
+		Py_DECREF(pOld);
+	}
+	else {
+		++m_uiCount;
+	}
+}
+
+void CEntityCache::DelItem(object oIndex)
+{
+	unsigned int uiIndex;
+	if (!Lookup(oIndex, uiIndex)) {
+		PyErr_SetObject(PyExc_KeyError, oIndex.ptr());
+		throw_error_already_set();
+	}
+
+	Py_DECREF(Release(uiIndex));
+}
+
+bool CEntityCache::Contains(object oIndex)
+{
+	unsigned int uiIndex;
+	return Lookup(oIndex, uiIndex) != NULL;
+}
+
+unsigned int CEntityCache::GetCount()
+{
+	return m_uiCount;
+}
+
+object CEntityCache::Get(object oIndex, object oDefault)
+{
+	unsigned int uiIndex;
+	PyObject *pObject = Lookup(oIndex, uiIndex);
+	if (!pObject) {
+		return oDefault;
+	}
+
+	return object(handle<>(borrowed(pObject)));
+}
+
+object CEntityCache::Pop(object oIndex, object oDefault)
+{
+	unsigned int uiIndex;
+	if (!Lookup(oIndex, uiIndex)) {
+		return oDefault;
+	}
+
+	return object(handle<>(Release(uiIndex)));
+}
+
+void CEntityCache::Clear()
+{
+	std::vector<PyObject *> vecObjects;
+	for (unsigned int i = 0; i < MAX_EDICTS; ++i) {
+		PyObject *pObject = Release(i);
+		if (pObject) {
+			vecObjects.push_back(pObject);
+		}
+	}
+
+	for (std::vector<PyObject *>::iterator it = vecObjects.begin(); it != vecObjects.end(); ++it) {
+		Py_DECREF(*it);
+	}
+}
+
+list CEntityCache::GetKeys()
+{
+	list oKeys;
+	for (unsigned int i = 0; i < MAX_EDICTS; ++i) {
+		if (Lookup(i)) {
+			oKeys.append(i);
+		}
+	}
+
+	return oKeys;
+}
+
+list CEntityCache::GetValues()
+{
+	list oValues;
+	for (unsigned int i = 0; i < MAX_EDICTS; ++i) {
+		PyObject *pObject = Lookup(i);
+		if (pObject) {
+			oValues.append(object(handle<>(borrowed(pObject))));
+		}
+	}
+
+	return oValues;
+}
+
+list CEntityCache::GetItems()
+{
+	list oItems;
+	for (unsigned int i = 0; i < MAX_EDICTS; ++i) {
+		PyObject *pObject = Lookup(i);
+		if (pObject) {
+			oItems.append(make_tuple(i, object(handle<>(borrowed(pObject)))));
+		}
+	}
+
+	return oItems;
+}
+
+object CEntityCache::Iter()
+{
+	return GetKeys().attr("__iter__")();
+}
+
+void CEntityCache::Invalidate(unsigned int uiIndex)
+{
+	if (uiIndex >= MAX_EDICTS) {
+		return;
+	}
+
+	s_pObjectCaches[uiIndex] = NULL;
+
+	// Release the instances once all caches were updated, because releasing
+	// the last instance of a class also destroys the cache of that class.
+	std::vector<PyObject *> vecObjects;
+	std::vector<CEntityCache *> &vecCaches = GetEntityCaches();
+	for (std::vector<CEntityCache *>::iterator it = vecCaches.begin(); it != vecCaches.end(); ++it) {
+		PyObject *pObject = (*it)->Release(uiIndex);
+		if (pObject) {
+			vecObjects.push_back(pObject);
+		}
+	}
+
+	for (std::vector<PyObject *>::iterator it = vecObjects.begin(); it != vecObjects.end(); ++it) {
+		Py_DECREF(*it);
+	}
+}
+
+
+// ============================================================================
+// >> GetEntityObject
+// ============================================================================
+object GetEntityObject(CBaseEntityWrapper *pEntity)
+{
+	if (!pEntity->IsNetworked()) {
+		return object(ptr(pEntity));
+	}
+
+	const CBaseHandle &hHandle = pEntity->GetRefEHandle();
+	unsigned int uiIndex = hHandle.GetEntryIndex();
+	unsigned int uiHandle = hHandle.ToInt();
+
+	// Return the instance we handed out last time, if it is still cached
+	if (uiIndex < MAX_EDICTS) {
+		CEntityCache *pCache = s_pObjectCaches[uiIndex];
+		if (pCache) {
+			PyObject *pObject = pCache->Find(uiIndex, uiHandle);
+			if (pObject) {
+				return object(handle<>(borrowed(pObject)));
+			}
+		}
+	}
+
+	static object Player = import("players").attr("entity").attr("Player");
+	static CEntityCache *pPlayers = extract<CEntityCache *>(Player.attr("_cache"));
+
+	static object Weapon = import("weapons").attr("entity").attr("Weapon");
+	static CEntityCache *pWeapons = extract<CEntityCache *>(Weapon.attr("_cache"));
+
+	static object Entity = import("entities").attr("entity").attr("Entity");
+	static CEntityCache *pEntities = extract<CEntityCache *>(Entity.attr("_cache"));
+
+	object oEntity;
+	CEntityCache *pCache;
+	if (pEntity->IsPlayer()) {
+		oEntity = Player(uiIndex);
+		pCache = pPlayers;
+	}
+	else if (pEntity->IsWeapon()) {
+		oEntity = Weapon(uiIndex);
+		pCache = pWeapons;
+	}
+	else {
+		oEntity = Entity(uiIndex);
+		pCache = pEntities;
+	}
+
+	// Only remember the cache if the class actually cached the instance
+	if (uiIndex < MAX_EDICTS && pCache->Find(uiIndex, uiHandle) == oEntity.ptr()) {
+		s_pObjectCaches[uiIndex] = pCache;
+	}
+
+	return oEntity;
+}
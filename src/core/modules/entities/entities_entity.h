@@ -49,6 +49,7 @@ using namespace boost::python;
 class CPointer;
 class IPhysicsObjectWrapper;
 class CBaseEntityOutputWrapper;
+struct KeyField_t;
 
 
 //-----------------------------------------------------------------------------
@@ -201,7 +202,7 @@ public:
 	void SetNetworkPropertyByOffset(int offset, T value)
 	{
 		*(T *) (((unsigned long) this) + offset) = value;
-		GetEdict()->StateChanged();
+		NetworkStateChanged(offset);
 	}
 
 	void SetNetworkPropertyStringArray(const char* name, const char* value)
@@ -212,9 +213,15 @@ public:
 	void SetNetworkPropertyStringArrayByOffset(int offset, const char* value)
 	{
 		strcpy((char*) (((unsigned long) this) + offset), value);
-		GetEdict()->StateChanged();
+		NetworkStateChanged(offset);
 	}
 
+	// Network state methods
+	void NetworkStateChanged();
+	void NetworkStateChanged(int offset);
+	void NetworkStateChanged(const int* pOffsets, int iCount);
+	void network_state_changed(object offsets);
+
 	// Generic property getter/setter methods
 	template<class T>
 	T GetProperty(const char *name)
@@ -285,6 +292,8 @@ public:
 	}
 
 	// KeyValue methods
+	KeyField_t* FindKeyField(const char* szName);
+	static void VerifyKeyField(KeyField_t* pField, bool bEqual, bool bSignificant);
 	void GetKeyValueStringRaw(const char* szName, char* szOut, int iLength);
 	str GetKeyValueString(const char* szName);
 	long GetKeyValueInt(const char* szName);
@@ -307,8 +316,11 @@ public:
 		//			szName, GetDataDescMap()->dataClassName);
 
 		servertools->SetKeyValue(GetThis(), szName, value);
+		OnKeyValueChanged(szName);
 	}
 
+	void OnKeyValueChanged(const char* szName);
+
 	// Conversion methods
 	edict_t* GetEdict();
 	unsigned int GetIndex();
@@ -450,27 +462,70 @@ public:
 
 
 //-----------------------------------------------------------------------------
-// Returns an entity pointer as a Python object.
+// Index-addressed cache of entity instances.
 //-----------------------------------------------------------------------------
-inline object GetEntityObject(CBaseEntityWrapper *pEntity)
+struct EntityCacheSlot_t
+{
+	PyObject *m_pObject;
+	unsigned int m_uiHandle;
+};
+
+class CEntityCache
 {
-	if (pEntity->IsNetworked()) {
-		if (pEntity->IsPlayer()) {
-			static object Player = import("players").attr("entity").attr("Player");
-			return Player(pEntity->GetIndex());
+public:
+	CEntityCache();
+	~CEntityCache();
+
+	// Returns a borrowed reference to the cached instance, or NULL if the
+	// slot is empty or was filled for another entity using the same index.
+	inline PyObject *Find(unsigned int uiIndex, unsigned int uiHandle)
+	{
+		if (uiIndex >= MAX_EDICTS) {
+			return NULL;
 		}
 
-		if (pEntity->IsWeapon()) {
-			static object Weapon = import("weapons").attr("entity").attr("Weapon");
-			return Weapon(pEntity->GetIndex());
+		EntityCacheSlot_t &slot = m_Slots[uiIndex];
+		if (!slot.m_pObject || slot.m_uiHandle != uiHandle) {
+			return NULL;
 		}
 
-		static object Entity = import("entities").attr("entity").attr("Entity");
-		return Entity(pEntity->GetIndex());
+		return slot.m_pObject;
 	}
 
-	return object(ptr(pEntity));
-}
+	// Python mapping interface
+	object GetItem(object oIndex);
+	void SetItem(unsigned int uiIndex, object oEntity);
+	void DelItem(object oIndex);
+	bool Contains(object oIndex);
+	unsigned int GetCount();
+
+	object Get(object oIndex, object oDefault);
+	object Pop(object oIndex, object oDefault);
+	void Clear();
+
+	list GetKeys();
+	list GetValues();
+	list GetItems();
+	object Iter();
+
+	// Releases the instances cached by all caches for the given index.
+	static void Invalidate(unsigned int uiIndex);
+
+private:
+	PyObject *Lookup(unsigned int uiIndex);
+	PyObject *Lookup(object oIndex, unsigned int &uiIndex);
+	PyObject *Release(unsigned int uiIndex);
+
+private:
+	EntityCacheSlot_t m_Slots[MAX_EDICTS];
+	unsigned int m_uiCount;
+};
+
+
+//-----------------------------------------------------------------------------
+// Returns an entity pointer as a Python object.
+//-----------------------------------------------------------------------------
+object GetEntityObject(CBaseEntityWrapper *pEntity);
 
 inline object GetEntityObject(CBaseEntity *pEntity)
 {
@@ -39,6 +39,7 @@
 // Forward declarations.
 //-----------------------------------------------------------------------------
 void export_base_entity(scope);
+void export_entity_cache(scope);
 
 
 //-----------------------------------------------------------------------------
@@ -47,6 +48,7 @@ void export_base_entity(scope);
 DECLARE_SP_SUBMODULE(_entities, _entity)
 {
 	export_base_entity(_entity);
+	export_entity_cache(_entity);
 }
 
 
@@ -634,6 +636,30 @@ void export_base_entity(scope _entity)
 		args("field_name", "value")
 	);
 
+	// Offset methods
+	BaseEntity.def("find_datamap_property_offset",
+		&CBaseEntityWrapper::FindDatamapPropertyOffset,
+		"Return the offset of the given datamap field name.\n\n"
+		"The offset can be stored and used with the :class:`memory.Pointer`\n"
+		"methods of the entity to skip the name lookup.\n\n"
+		":rtype: int\n"
+		":raise ValueError:\n"
+		"    Raised if the field wasn't found.",
+		args("name")
+	);
+
+	BaseEntity.def("find_network_property_offset",
+		&CBaseEntityWrapper::FindNetworkPropertyOffset,
+		"Return the offset of the given server class field name.\n\n"
+		"The offset can be stored and used with the :class:`memory.Pointer`\n"
+		"methods of the entity to skip the name lookup. Call\n"
+		":meth:`network_state_changed` with it after writing the value.\n\n"
+		":rtype: int\n"
+		":raise ValueError:\n"
+		"    Raised if the field wasn't found.",
+		args("name")
+	);
+
 	// Datamap getter methods
 	BaseEntity.def("get_datamap_property_bool",
 		&CBaseEntityWrapper::GetDatamapProperty<bool>,
@@ -1105,6 +1131,17 @@ void export_base_entity(scope _entity)
 		"Set the value of the given server class field name."
 	);
 
+	BaseEntity.def("network_state_changed",
+		&CBaseEntityWrapper::network_state_changed,
+		"Notify the engine that the network properties at the given offsets changed.\n\n"
+		"All offsets are recorded in a single change info entry, so only the\n"
+		"matching send props are compared for the next snapshot.\n\n"
+		":param offsets:\n"
+		"    An offset, an iterable of offsets, or ``None`` to flag the entire\n"
+		"    entity as changed.",
+		(arg("offsets")=object())
+	);
+
 	// Generic property getters
 	BaseEntity.def("get_property_bool",
 		&CBaseEntityWrapper::GetProperty<bool>,
@@ -1358,3 +1395,92 @@ void export_base_entity(scope _entity)
 	);
 	cached_property(BaseEntity, "_size");
 }
+
+
+//-----------------------------------------------------------------------------
+// Exports CEntityCache.
+//-----------------------------------------------------------------------------
+void export_entity_cache(scope _entity)
+{
+	class_<CEntityCache, boost::noncopyable> EntityCache(
+		"EntityCache",
+		"Mapping of entity indexes to cached entity instances.\n\n"
+		".. note::\n\n"
+		"    Instances are dropped when their entity is deleted, or when their\n"
+		"    index has been reused by another entity."
+	);
+
+	EntityCache.def(
+		"__getitem__",
+		&CEntityCache::GetItem,
+		"Return the cached instance of the given index."
+	);
+
+	EntityCache.def(
+		"__setitem__",
+		&CEntityCache::SetItem,
+		"Cache the given instance for the entity currently using the given index."
+	);
+
+	EntityCache.def(
+		"__delitem__",
+		&CEntityCache::DelItem,
+		"Remove the cached instance of the given index."
+	);
+
+	EntityCache.def(
+		"__contains__",
+		&CEntityCache::Contains,
+		"Return True if an instance is cached for the given index."
+	);
+
+	EntityCache.def(
+		"__len__",
+		&CEntityCache::GetCount,
+		"Return the number of cached instances."
+	);
+
+	EntityCache.def(
+		"__iter__",
+		&CEntityCache::Iter,
+		"Return an iterator over the cached indexes."
+	);
+
+	EntityCache.def(
+		"get",
+		&CEntityCache::Get,
+		"Return the cached instance of the given index, or the default value.",
+		("index", arg("default")=object())
+	);
+
+	EntityCache.def(
+		"pop",
+		&CEntityCache::Pop,
+		"Remove and return the cached instance of the given index, or the default value.",
+		("index", arg("default")=object())
+	);
+
+	EntityCache.def(
+		"clear",
+		&CEntityCache::Clear,
+		"Remove all cached instances."
+	);
+
+	EntityCache.def(
+		"keys",
+		&CEntityCache::GetKeys,
+		"Return a list of the cached indexes."
+	);
+
+	EntityCache.def(
+		"values",
+		&CEntityCache::GetValues,
+		"Return a list of the cached instances."
+	);
+
+	EntityCache.def(
+		"items",
+		&CEntityCache::GetItems,
+		"Return a list of (index, instance) tuples."
+	);
+}
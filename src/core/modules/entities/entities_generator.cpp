@@ -43,6 +43,32 @@ extern IServerTools *servertools;
 extern IServerGameDLL* servergamedll;
 
 
+// ----------------------------------------------------------------------------
+// Returns the next snapshotted entity that is still alive and still matches.
+// ----------------------------------------------------------------------------
+static CBaseEntity* NextIndexedEntity(const ClassIndexEntries_t& vecEntries, unsigned int& uiEntry,
+	const char* szClassName, unsigned int uiClassNameLen, bool bExactMatch)
+{
+	static CEntityClassIndex *pIndex = GetEntityClassIndex();
+	while (uiEntry < vecEntries.size())
+	{
+		const ClassIndexEntry_t& entry = vecEntries[uiEntry++];
+		if (!pIndex->IsAlive(entry))
+			continue;
+
+		const char* szCurrent = IServerUnknownExt::GetClassname(entry.m_pEntity);
+		if (!bExactMatch && strncmp(szCurrent, szClassName, uiClassNameLen) != 0)
+			continue;
+
+		else if (bExactMatch && strcmp(szCurrent, szClassName) != 0)
+			continue;
+
+		return entry.m_pEntity;
+	}
+	return NULL;
+}
+
+
 // ----------------------------------------------------------------------------
 // CEntityGenerator
 // ----------------------------------------------------------------------------
@@ -51,7 +77,8 @@ CEntityGenerator::CEntityGenerator( PyObject* self ):
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_szClassName(NULL),
 	m_uiClassNameLen(0),
-	m_bExactMatch(false)
+	m_bExactMatch(false),
+	m_uiEntry(0)
 {
 }
 
@@ -59,7 +86,9 @@ CEntityGenerator::CEntityGenerator( PyObject* self, const CEntityGenerator& rhs
 	IPythonGenerator<edict_t>(self),
 	m_pCurrentEntity(rhs.m_pCurrentEntity),
 	m_uiClassNameLen(rhs.m_uiClassNameLen),
-	m_bExactMatch(rhs.m_bExactMatch)
+	m_bExactMatch(rhs.m_bExactMatch),
+	m_vecEntries(rhs.m_vecEntries),
+	m_uiEntry(rhs.m_uiEntry)
 {
 	makeStringCopy(rhs.m_szClassName, m_uiClassNameLen);
 }
@@ -68,18 +97,30 @@ CEntityGenerator::CEntityGenerator(PyObject* self, const char* szClassName):
 	IPythonGenerator<edict_t>(self),
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_uiClassNameLen(strlen(szClassName)),
-	m_bExactMatch(false)
+	m_bExactMatch(false),
+	m_uiEntry(0)
 {
 	makeStringCopy(szClassName, m_uiClassNameLen);
+	if (m_szClassName)
+	{
+		GetEntityClassIndex()->Collect(m_szClassName, m_bExactMatch, m_vecEntries);
+		m_pCurrentEntity = NULL;
+	}
 }
 
 CEntityGenerator::CEntityGenerator(PyObject* self, const char* szClassName, bool bExactMatch):
 	IPythonGenerator<edict_t>(self),
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_uiClassNameLen(strlen(szClassName)),
-	m_bExactMatch(bExactMatch)
+	m_bExactMatch(bExactMatch),
+	m_uiEntry(0)
 {
 	makeStringCopy(szClassName, m_uiClassNameLen);
+	if (m_szClassName)
+	{
+		GetEntityClassIndex()->Collect(m_szClassName, m_bExactMatch, m_vecEntries);
+		m_pCurrentEntity = NULL;
+	}
 }
 
 CEntityGenerator::~CEntityGenerator()
@@ -89,6 +130,18 @@ CEntityGenerator::~CEntityGenerator()
 
 edict_t* CEntityGenerator::getNext()
 {
+	if (m_szClassName)
+	{
+		CBaseEntity *pEntity;
+		while ((pEntity = NextIndexedEntity(m_vecEntries, m_uiEntry, m_szClassName, m_uiClassNameLen, m_bExactMatch)))
+		{
+			edict_t *pEdict;
+			if (EdictFromBaseEntity(pEntity, pEdict))
+				return pEdict;
+		}
+		return NULL;
+	}
+
 	while (m_pCurrentEntity)
 	{
 		edict_t *pEdict;
@@ -136,7 +189,8 @@ CBaseEntityGenerator::CBaseEntityGenerator( PyObject* self ):
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_szClassName(NULL),
 	m_uiClassNameLen(0),
-	m_bExactMatch(false)
+	m_bExactMatch(false),
+	m_uiEntry(0)
 {
 }
 
@@ -144,7 +198,9 @@ CBaseEntityGenerator::CBaseEntityGenerator( PyObject* self, const CBaseEntityGen
 	IPythonGenerator<CBaseEntityWrapper>(self),
 	m_pCurrentEntity(rhs.m_pCurrentEntity),
 	m_uiClassNameLen(rhs.m_uiClassNameLen),
-	m_bExactMatch(rhs.m_bExactMatch)
+	m_bExactMatch(rhs.m_bExactMatch),
+	m_vecEntries(rhs.m_vecEntries),
+	m_uiEntry(rhs.m_uiEntry)
 {
 	makeStringCopy(rhs.m_szClassName, m_uiClassNameLen);
 }
@@ -153,18 +209,30 @@ CBaseEntityGenerator::CBaseEntityGenerator(PyObject* self, const char* szClassNa
 	IPythonGenerator<CBaseEntityWrapper>(self),
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_uiClassNameLen(strlen(szClassName)),
-	m_bExactMatch(false)
+	m_bExactMatch(false),
+	m_uiEntry(0)
 {
 	makeStringCopy(szClassName, m_uiClassNameLen);
+	if (m_szClassName)
+	{
+		GetEntityClassIndex()->Collect(m_szClassName, m_bExactMatch, m_vecEntries);
+		m_pCurrentEntity = NULL;
+	}
 }
 
 CBaseEntityGenerator::CBaseEntityGenerator(PyObject* self, const char* szClassName, bool bExactMatch):
 	IPythonGenerator<CBaseEntityWrapper>(self),
 	m_pCurrentEntity((CBaseEntity *)servertools->FirstEntity()),
 	m_uiClassNameLen(strlen(szClassName)),
-	m_bExactMatch(bExactMatch)
+	m_bExactMatch(bExactMatch),
+	m_uiEntry(0)
 {
 	makeStringCopy(szClassName, m_uiClassNameLen);
+	if (m_szClassName)
+	{
+		GetEntityClassIndex()->Collect(m_szClassName, m_bExactMatch, m_vecEntries);
+		m_pCurrentEntity = NULL;
+	}
 }
 
 void CBaseEntityGenerator::makeStringCopy(const char* szClassName, unsigned int uiClassNameLen)
@@ -189,6 +257,9 @@ CBaseEntityGenerator::~CBaseEntityGenerator()
 
 CBaseEntityWrapper* CBaseEntityGenerator::getNext()
 {
+	if (m_szClassName)
+		return (CBaseEntityWrapper*) NextIndexedEntity(m_vecEntries, m_uiEntry, m_szClassName, m_uiClassNameLen, m_bExactMatch);
+
 	CBaseEntity* result = NULL;
 	while (m_pCurrentEntity)
 	{
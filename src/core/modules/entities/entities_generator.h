@@ -34,6 +34,7 @@
 #include "utilities/ipythongenerator.h"
 #include "utilities/baseentity.h"
 #include "entities_entity.h"
+#include "entities_classnames.h"
 #include "eiface.h"
 #include "game/server/entityoutput.h"
 
@@ -63,6 +64,10 @@ private:
 	const char* m_szClassName;
 	unsigned int m_uiClassNameLen;
 	bool m_bExactMatch;
+
+	// Matching entities, snapshotted from the classname index
+	ClassIndexEntries_t m_vecEntries;
+	unsigned int m_uiEntry;
 };
 
 BOOST_SPECIALIZE_HAS_BACK_REFERENCE(CEntityGenerator)
@@ -89,6 +94,10 @@ private:
 	const char* m_szClassName;
 	unsigned int m_uiClassNameLen;
 	bool m_bExactMatch;
+
+	// Matching entities, snapshotted from the classname index
+	ClassIndexEntries_t m_vecEntries;
+	unsigned int m_uiEntry;
 };
 
 BOOST_SPECIALIZE_HAS_BACK_REFERENCE(CBaseEntityGenerator)
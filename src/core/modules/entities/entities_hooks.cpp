@@ -0,0 +1,185 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "modules/entities/entities_hooks.h"
+#include "utilities/conversions.h"
+
+
+//-----------------------------------------------------------------------------
+// CEntityHookFilter class.
+//-----------------------------------------------------------------------------
+CEntityHookFilter::CEntityHookFilter(object oIndexes, object oClassnames, int iFlags):
+	m_iFlags(iFlags)
+{
+	if (!oIndexes.is_none())
+	{
+		object oIterator = object(handle<>(PyObject_GetIter(oIndexes.ptr())));
+		while (PyObject *pItem = PyIter_Next(oIterator.ptr())) {
+			AddIndex(extract<unsigned int>(object(handle<>(pItem))));
+		}
+
+		if (PyErr_Occurred())
+			throw_error_already_set();
+	}
+
+	if (!oClassnames.is_none())
+	{
+		object oIterator = object(handle<>(PyObject_GetIter(oClassnames.ptr())));
+		while (PyObject *pItem = PyIter_Next(oIterator.ptr())) {
+			AddClassname(extract<const char *>(object(handle<>(pItem))));
+		}
+
+		if (PyErr_Occurred())
+			throw_error_already_set();
+	}
+}
+
+bool CEntityHookFilter::ShouldCall(CHook* pHook)
+{
+	return Matches(pHook->GetArgument<CBaseEntity *>(0));
+}
+
+bool CEntityHookFilter::RequiresThisPointer()
+{
+	return true;
+}
+
+bool CEntityHookFilter::Matches(CBaseEntity* pEntity)
+{
+	if (!pEntity) {
+		return false;
+	}
+
+	unsigned int uiIndex;
+	bool bNetworked = IndexFromBaseEntity(pEntity, uiIndex);
+
+	if (!m_mapHandles.empty())
+	{
+		if (!bNetworked) {
+			return false;
+		}
+
+		EntityHookHandles_t::const_iterator it = m_mapHandles.find(uiIndex);
+		unsigned int uiHandle;
+		if (it == m_mapHandles.end() || !IntHandleFromBaseEntity(pEntity, uiHandle) || it->second != uiHandle) {
+			return false;
+		}
+	}
+
+	if (!m_setClassnames.empty()) {
+		const char *szClassname = IServerUnknownExt::GetClassname(pEntity);
+		if (!szClassname || m_setClassnames.find(szClassname) == m_setClassnames.end()) {
+			return false;
+		}
+	}
+
+	if (!m_iFlags) {
+		return true;
+	}
+
+	bool bPlayer = bNetworked && uiIndex > WORLD_ENTITY_INDEX && uiIndex <= (unsigned int) gpGlobals->maxClients;
+	if (!bPlayer) {
+		return (m_iFlags & ENTITY_HOOK_NON_PLAYERS) != 0;
+	}
+
+	if (m_iFlags & ENTITY_HOOK_PLAYERS) {
+		return true;
+	}
+
+	if (!(m_iFlags & (ENTITY_HOOK_HUMANS | ENTITY_HOOK_BOTS))) {
+		return false;
+	}
+
+	IPlayerInfo *pPlayerInfo;
+	bool bBot = PlayerInfoFromIndex(uiIndex, pPlayerInfo) && pPlayerInfo->IsFakeClient();
+	return (m_iFlags & (bBot ? ENTITY_HOOK_BOTS : ENTITY_HOOK_HUMANS)) != 0;
+}
+
+void CEntityHookFilter::AddIndex(unsigned int uiIndex)
+{
+	unsigned int uiHandle;
+	if (!IntHandleFromIndex(uiIndex, uiHandle)) {
+		BOOST_RAISE_EXCEPTION(
+			PyExc_ValueError,
+			"Invalid entity index: %u", uiIndex
+		)
+	}
+
+	m_mapHandles[uiIndex] = uiHandle;
+}
+
+void CEntityHookFilter::RemoveIndex(unsigned int uiIndex)
+{
+	m_mapHandles.erase(uiIndex);
+}
+
+bool CEntityHookFilter::HasIndex(unsigned int uiIndex)
+{
+	EntityHookHandles_t::const_iterator it = m_mapHandles.find(uiIndex);
+	if (it == m_mapHandles.end()) {
+		return false;
+	}
+
+	unsigned int uiHandle;
+	return IntHandleFromIndex(uiIndex, uiHandle) && it->second == uiHandle;
+}
+
+void CEntityHookFilter::AddClassname(const char* szClassname)
+{
+	m_setClassnames.insert(szClassname);
+}
+
+void CEntityHookFilter::RemoveClassname(const char* szClassname)
+{
+	EntityHookClassnames_t::iterator it = m_setClassnames.find(szClassname);
+	if (it != m_setClassnames.end()) {
+		m_setClassnames.erase(it);
+	}
+}
+
+bool CEntityHookFilter::HasClassname(const char* szClassname)
+{
+	return m_setClassnames.find(szClassname) != m_setClassnames.end();
+}
+
+int CEntityHookFilter::GetFlags()
+{
+	return m_iFlags;
+}
+
+void CEntityHookFilter::SetFlags(int iFlags)
+{
+	m_iFlags = iFlags;
+}
+
+bool CEntityHookFilter::__call__(CBaseEntityWrapper* pEntity)
+{
+	return Matches((CBaseEntity *) pEntity);
+}
@@ -0,0 +1,100 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _ENTITIES_HOOKS_H
+#define _ENTITIES_HOOKS_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "modules/entities/entities_entity.h"
+#include "modules/memory/memory_hooks.h"
+#include "utilities/string_map.h"
+
+// Boost
+#include "boost/unordered/unordered_flat_map.hpp"
+#include "boost/unordered/unordered_flat_set.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs.
+//-----------------------------------------------------------------------------
+typedef boost::unordered_flat_map<unsigned int, unsigned int> EntityHookHandles_t;
+typedef boost::unordered_flat_set<std::string, StringMapHash, StringMapEqual> EntityHookClassnames_t;
+
+
+//-----------------------------------------------------------------------------
+// EEntityHookFlags enumeration.
+//-----------------------------------------------------------------------------
+enum EEntityHookFlags
+{
+	ENTITY_HOOK_PLAYERS = 1 << 0,
+	ENTITY_HOOK_NON_PLAYERS = 1 << 1,
+	ENTITY_HOOK_HUMANS = 1 << 2,
+	ENTITY_HOOK_BOTS = 1 << 3
+};
+
+
+//-----------------------------------------------------------------------------
+// CEntityHookFilter class.
+//-----------------------------------------------------------------------------
+// Only accepts calls whose this pointer matches the given entity indexes,
+// classnames and flags. Empty criteria accept every entity. Indexes are bound
+// to the entity that occupies them when they are added, so an entity that
+// later reuses the index does not match.
+class CEntityHookFilter: public IHookFilter
+{
+public:
+	CEntityHookFilter(object oIndexes=object(), object oClassnames=object(), int iFlags=0);
+
+	virtual bool ShouldCall(CHook* pHook);
+	virtual bool RequiresThisPointer();
+	bool Matches(CBaseEntity* pEntity);
+
+	void AddIndex(unsigned int uiIndex);
+	void RemoveIndex(unsigned int uiIndex);
+	bool HasIndex(unsigned int uiIndex);
+
+	void AddClassname(const char* szClassname);
+	void RemoveClassname(const char* szClassname);
+	bool HasClassname(const char* szClassname);
+
+	int GetFlags();
+	void SetFlags(int iFlags);
+
+	bool __call__(CBaseEntityWrapper* pEntity);
+
+private:
+	// Maps each index to the handle of the entity it was added for.
+	EntityHookHandles_t m_mapHandles;
+
+	EntityHookClassnames_t m_setClassnames;
+	int m_iFlags;
+};
+
+
+#endif // _ENTITIES_HOOKS_H
@@ -0,0 +1,156 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "export_main.h"
+#include "modules/entities/entities_hooks.h"
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+void export_entity_hook_flags(scope);
+void export_entity_hook_filter(scope);
+
+
+//-----------------------------------------------------------------------------
+// Declare the _entities._hooks module.
+//-----------------------------------------------------------------------------
+DECLARE_SP_SUBMODULE(_entities, _hooks)
+{
+	export_entity_hook_flags(_hooks);
+	export_entity_hook_filter(_hooks);
+}
+
+
+//-----------------------------------------------------------------------------
+// Exports EEntityHookFlags.
+//-----------------------------------------------------------------------------
+void export_entity_hook_flags(scope _hooks)
+{
+	enum_<EEntityHookFlags> EntityHookFlags("EntityHookFlags");
+
+	// Values...
+	EntityHookFlags.value("PLAYERS", ENTITY_HOOK_PLAYERS);
+	EntityHookFlags.value("NON_PLAYERS", ENTITY_HOOK_NON_PLAYERS);
+	EntityHookFlags.value("HUMANS", ENTITY_HOOK_HUMANS);
+	EntityHookFlags.value("BOTS", ENTITY_HOOK_BOTS);
+}
+
+
+//-----------------------------------------------------------------------------
+// Exports CEntityHookFilter.
+//-----------------------------------------------------------------------------
+void export_entity_hook_filter(scope _hooks)
+{
+	class_<CEntityHookFilter, bases<IHookFilter>, boost::noncopyable> EntityHookFilter(
+		"EntityHookFilter",
+		init<optional<object, object, int> >(
+			(arg("indexes")=object(), arg("classnames")=object(), arg("flags")=0),
+			"Constructor.\n"
+			"\n"
+			"The filter can only be attached to thiscall functions.\n"
+			"\n"
+			":param iterable indexes:\n"
+			"	Entity indexes the this pointer must match. Each index is bound to the\n"
+			"	entity that currently occupies it. ``None`` accepts any index.\n"
+			":param iterable classnames:\n"
+			"	Classnames the this pointer must match. ``None`` accepts any classname.\n"
+			":param int flags:\n"
+			"	A combination of :class:`EntityHookFlags` the this pointer must match\n"
+			"	at least one of. ``0`` accepts any entity."
+		)
+	);
+
+	EntityHookFilter.def(
+		"__call__",
+		&CEntityHookFilter::__call__,
+		"Return whether the given entity matches the filter.\n"
+		"\n"
+		":rtype: bool",
+		args("self", "entity")
+	);
+
+	EntityHookFilter.def(
+		"add_index",
+		&CEntityHookFilter::AddIndex,
+		"Add an entity index to the filter.\n"
+		"\n"
+		"The index is bound to the entity that currently occupies it.\n"
+		"\n"
+		":raise ValueError:\n"
+		"	Raised if no entity occupies the index.",
+		args("self", "index")
+	);
+
+	EntityHookFilter.def(
+		"remove_index",
+		&CEntityHookFilter::RemoveIndex,
+		"Remove an entity index from the filter.",
+		args("self", "index")
+	);
+
+	EntityHookFilter.def(
+		"has_index",
+		&CEntityHookFilter::HasIndex,
+		"Return whether the given entity index was added to the filter and is\n"
+		"still occupied by the same entity.",
+		args("self", "index")
+	);
+
+	EntityHookFilter.def(
+		"add_classname",
+		&CEntityHookFilter::AddClassname,
+		"Add a classname to the filter.",
+		args("self", "classname")
+	);
+
+	EntityHookFilter.def(
+		"remove_classname",
+		&CEntityHookFilter::RemoveClassname,
+		"Remove a classname from the filter.",
+		args("self", "classname")
+	);
+
+	EntityHookFilter.def(
+		"has_classname",
+		&CEntityHookFilter::HasClassname,
+		"Return whether the given classname was added to the filter.",
+		args("self", "classname")
+	);
+
+	EntityHookFilter.add_property(
+		"flags",
+		&CEntityHookFilter::GetFlags,
+		&CEntityHookFilter::SetFlags,
+		"Return the flags of the filter.\n"
+		"\n"
+		":rtype: int"
+	);
+}
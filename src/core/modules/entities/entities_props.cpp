@@ -28,9 +28,10 @@
 // >> INCLUDES
 // ============================================================================
 // Boost
-#include "boost/unordered_map.hpp"
+#include "boost/unordered/unordered_flat_map.hpp"
 
 // Source.Python
+#include "utilities/string_map.h"
 #include "modules/memory/memory_pointer.h"
 #include "entities_props.h"
 #include ENGINE_INCLUDE_PATH(entities_props.h)
@@ -49,8 +50,8 @@ extern IServerGameDLL* servergamedll;
 // ============================================================================
 // >> TYPEDEFS
 // ============================================================================
-typedef boost::unordered_map<std::string, int> OffsetsMap;
-typedef boost::unordered_map<std::string, OffsetsMap > SendTableMap;
+typedef StringMap_t<int> OffsetsMap;
+typedef boost::unordered_flat_map<SendTable*, OffsetsMap> SendTableMap;
 
 
 // ============================================================================
@@ -88,14 +89,14 @@ void AddSendTable(SendTable* pTable, OffsetsMap& offsets, int offset=0, const ch
 
 		int currentOffset = offset + pProp->GetOffset();
 
-		char* currentName = NULL;
+		const char* currentName = NULL;
+		char tempName[256];
 		if (baseName == NULL) {
-			currentName = (char*) pProp->GetName();
+			currentName = pProp->GetName();
 		}
 		else {
-			char tempName[256];
-			sprintf(tempName, "%s.%s", baseName, pProp->GetName());
-			currentName = strdup(tempName);
+			V_snprintf(tempName, sizeof(tempName), "%s.%s", baseName, pProp->GetName());
+			currentName = tempName;
 		}
 
 		if (pProp->GetType() == DPT_DataTable)
@@ -104,11 +105,29 @@ void AddSendTable(SendTable* pTable, OffsetsMap& offsets, int offset=0, const ch
 		}
 		else
 		{
-			offsets.insert(std::make_pair(currentName, currentOffset));
+			offsets.emplace(currentName, currentOffset);
 		}
 	}
 }
 
+OffsetsMap& GetSendTableOffsets(SendTable* pTable)
+{
+	SendTableMap::iterator offsets = g_SendTableCache.find(pTable);
+	if (offsets == g_SendTableCache.end())
+	{
+		offsets = g_SendTableCache.emplace(pTable, OffsetsMap()).first;
+
+		// Add the derived tables first, so their props hide the ones of their
+		// base tables.
+		for (SendTable* pCurrent = pTable; pCurrent; pCurrent = GetNextSendTable(pCurrent))
+		{
+			AddSendTable(pCurrent, offsets->second);
+		}
+	}
+
+	return offsets->second;
+}
+
 
 // ============================================================================
 // >> ServerClassExt
@@ -145,25 +164,15 @@ SendProp* SendTableSharedExt::__getitem__(SendTable *pSendTable, int iIndex)
 
 int SendTableSharedExt::find_offset(SendTable* pTable, const char* name)
 {
-	while(pTable)
-	{
-		SendTableMap::iterator offsets = g_SendTableCache.find(pTable->GetName());
-		if (offsets == g_SendTableCache.end())
-		{
-			offsets = g_SendTableCache.insert(std::make_pair(pTable->GetName(), OffsetsMap())).first;
-			AddSendTable(pTable, offsets->second);
-		}
-		
-		OffsetsMap::iterator result = offsets->second.find(name);
-		if (result == offsets->second.end())
-		{
-			pTable = GetNextSendTable(pTable);
-		}
-		else {
-			return result->second;
-		}
-	}
-	return -1;
+	if (!pTable)
+		return -1;
+
+	OffsetsMap& offsets = GetSendTableOffsets(pTable);
+	OffsetsMap::iterator result = offsets.find(name);
+	if (result == offsets.end())
+		return -1;
+
+	return result->second;
 }
 
 
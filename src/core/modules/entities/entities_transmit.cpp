@@ -44,6 +44,44 @@ extern IServerGameEnts *gameents;
 extern CGlobalVars *gpGlobals;
 
 
+//-----------------------------------------------------------------------------
+// Helper functions.
+//-----------------------------------------------------------------------------
+inline void AndMask(TransmitMask_t &vecMask, const TransmitMask_t &vecOther)
+{
+	uint32 *pDest = vecMask.Base();
+	const uint32 *pOther = vecOther.Base();
+	for (int i=0; i < vecMask.GetNumDWords(); i++) {
+		pDest[i] &= pOther[i];
+	}
+}
+
+inline void AndNotMask(TransmitMask_t &vecMask, const TransmitMask_t &vecOther)
+{
+	uint32 *pDest = vecMask.Base();
+	const uint32 *pOther = vecOther.Base();
+	for (int i=0; i < vecMask.GetNumDWords(); i++) {
+		pDest[i] &= ~pOther[i];
+	}
+}
+
+// Returns a one-dimensional memoryview over an owned copy of the given buffer.
+// The engine's buffers are only valid during the hook, but Python code can keep
+// views, slices or arrays derived from them forever. So never expose them.
+inline object MakeBufferCopy(const void *pBuffer, Py_ssize_t nSize, const char *szFormat, bool bReadOnly, object &oStorage)
+{
+	if (bReadOnly) {
+		oStorage = object(handle<>(PyBytes_FromStringAndSize((const char *)pBuffer, nSize)));
+	}
+	else {
+		oStorage = object(handle<>(PyByteArray_FromStringAndSize((const char *)pBuffer, nSize)));
+	}
+
+	object oView = object(handle<>(PyMemoryView_FromObject(oStorage.ptr())));
+	return oView.attr("cast")(szFormat);
+}
+
+
 //-----------------------------------------------------------------------------
 // CTransmitStates class.
 //-----------------------------------------------------------------------------
@@ -78,14 +116,17 @@ void CTransmitStates::__setitem__(int iBit, bool bValue)
 CTransmitManager::CTransmitManager():
 	m_bInitialized(false),
 	m_uiRefCount(0),
-	m_pHook(NULL)
+	m_pHook(NULL),
+	m_uiMasksVersion(1)
 {
 	m_pTransmitHooks = new CListenerManager();
+	m_pTransmitBufferHooks = new CListenerManager();
 }
 
 CTransmitManager::~CTransmitManager()
 {
 	delete m_pTransmitHooks;
+	delete m_pTransmitBufferHooks;
 }
 
 void CTransmitManager::IncRef()
@@ -133,10 +174,10 @@ void CTransmitManager::Initialize()
 		)
 
 	void *pAddr = (void *)pFunc->m_ulAddr;
-	m_pHook = GetHookManager()->FindHook(pAddr);
+	m_pHook = FindHook(pAddr);
 	if (!m_pHook)
 	{
-		m_pHook = GetHookManager()->HookFunction(pAddr, pFunc->m_pCallingConvention);
+		m_pHook = HookFunction(pAddr, pFunc->m_pCallingConvention);
 		if (!m_pHook) {
 			delete pFunc;
 			BOOST_RAISE_EXCEPTION(
@@ -173,6 +214,12 @@ void CTransmitManager::Finalize()
 	}
 
 	m_mapCache.clear();
+
+	BOOST_FOREACH(TransmitPlayerMasks_t::value_type it, m_mapMasks) {
+		delete it.second;
+	}
+
+	m_mapMasks.clear();
 	m_bInitialized = false;
 }
 
@@ -187,6 +234,7 @@ void CTransmitManager::RegisterRules(ITransmitRules *pRules)
 
 	IncRef();
 	m_vecRules.AddToTail(pRules);
+	InvalidateMasks();
 }
 
 void CTransmitManager::UnregisterRules(ITransmitRules *pRules)
@@ -195,6 +243,7 @@ void CTransmitManager::UnregisterRules(ITransmitRules *pRules)
 		return;
 	}
 
+	InvalidateMasks();
 	DecRef();
 }
 
@@ -213,6 +262,12 @@ void CTransmitManager::OnNetworkedEntityDeleted(CBaseEntityWrapper *pEntity, uns
 		m_mapCache.erase(uiEntity);
 		delete it->second;
 	}
+
+	TransmitPlayerMasks_t::iterator mask = m_mapMasks.find(uiEntity);
+	if (mask != m_mapMasks.end()) {
+		delete mask->second;
+		m_mapMasks.erase(mask);
+	}
 }
 
 void CTransmitManager::OnLevelShutdown()
@@ -234,6 +289,23 @@ void CTransmitManager::UnregisterTransmitHook(object oCallback)
 	DecRef();
 }
 
+void CTransmitManager::RegisterTransmitBufferHook(object oCallback)
+{
+	m_pTransmitBufferHooks->RegisterListener(oCallback.ptr());
+	IncRef();
+}
+
+void CTransmitManager::UnregisterTransmitBufferHook(object oCallback)
+{
+	m_pTransmitBufferHooks->UnregisterListener(oCallback.ptr());
+	DecRef();
+}
+
+void CTransmitManager::InvalidateMasks()
+{
+	++m_uiMasksVersion;
+}
+
 bool CTransmitManager::CheckTransmit(HookType_t eHookType, CHook *pHook)
 {
 	int nEdicts = pHook->GetArgument<int>(3);
@@ -270,6 +342,39 @@ bool CTransmitManager::CheckTransmit(HookType_t eHookType, CHook *pHook)
 		CALL_LISTENERS_WITH_MNGR(pManager->m_pTransmitHooks, oPlayer, oIndexes, oStates)
 	}
 
+	if (pManager->m_pTransmitBufferHooks->GetCount()) {
+		uint32 *pStates = pInfo->m_pTransmitEdict->Base();
+		Py_ssize_t nStatesSize = pInfo->m_pTransmitEdict->GetNumDWords() * sizeof(uint32);
+
+		object oIndexesStorage, oStatesStorage;
+		object oIndexes = MakeBufferCopy(pIndexes, nEdicts * sizeof(unsigned short), "H", true, oIndexesStorage);
+		object oStates = MakeBufferCopy(pStates, nStatesSize, "I", false, oStatesStorage);
+
+		CALL_LISTENERS_WITH_MNGR(pManager->m_pTransmitBufferHooks, uiPlayer, oIndexes, oStates)
+
+		// Write the states back. The bytearray can't be resized while a view
+		// is exported, but a callback might have released ours.
+		Py_ssize_t nSize = PyByteArray_GET_SIZE(oStatesStorage.ptr());
+		memcpy(pStates, PyByteArray_AS_STRING(oStatesStorage.ptr()), nSize < nStatesSize ? nSize : nStatesSize);
+	}
+
+	if (pManager->m_vecRules.Count()) {
+		// The world and the player itself are never filtered
+		bool bWorld = pInfo->m_pTransmitEdict->IsBitSet(WORLD_ENTITY_INDEX);
+		bool bSelf = pInfo->m_pTransmitEdict->IsBitSet(uiPlayer);
+
+		AndMask(*pInfo->m_pTransmitEdict, pManager->GetMask(uiPlayer));
+
+		pInfo->m_pTransmitEdict->Set(WORLD_ENTITY_INDEX, bWorld);
+		pInfo->m_pTransmitEdict->Set((int)uiPlayer, bSelf);
+	}
+
+	static CTransmitListenerManager *OnPlayerTransmit = GetOnPlayerTransmitListenerManager();
+	static CTransmitListenerManager *OnEntityTransmit = GetOnEntityTransmitListenerManager();
+	if (!OnPlayerTransmit->GetCount() && !OnEntityTransmit->GetCount()) {
+		return false;
+	}
+
 	for (int i=0; i < nEdicts; i++)
 	{
 		unsigned int uiEntity = (unsigned int)pIndexes[i];
@@ -279,19 +384,6 @@ bool CTransmitManager::CheckTransmit(HookType_t eHookType, CHook *pHook)
 			continue;
 		}
 
-		bool bResult = true;
-		FOR_EACH_VEC(pManager->m_vecRules, j) {
-			if (!pManager->m_vecRules[j]->ShouldTransmit(uiPlayer, uiEntity)) {
-				bResult = false;
-				break;
-			}
-		}
-
-		if (!bResult) {
-			pInfo->m_pTransmitEdict->Set((int)uiEntity, false);
-			continue;
-		}
-
 #if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
 		edict_t *pEdict = engine->PEntityOfEntIndex(uiEntity);
 #else
@@ -303,8 +395,6 @@ bool CTransmitManager::CheckTransmit(HookType_t eHookType, CHook *pHook)
 		}
 
 		if (uiEntity <= (unsigned int)gpGlobals->maxClients) {
-			static CTransmitListenerManager *OnPlayerTransmit = GetOnPlayerTransmitListenerManager();
-
 			if (!OnPlayerTransmit->GetCount() ||
 					((PlayerMixin *)pEdict->GetUnknown()->GetBaseEntity())->GetLifeState() != LIFE_ALIVE) {
 				continue;
@@ -323,8 +413,6 @@ bool CTransmitManager::CheckTransmit(HookType_t eHookType, CHook *pHook)
 			continue;
 		}
 
-		static CTransmitListenerManager *OnEntityTransmit = GetOnEntityTransmitListenerManager();
-
 		if (!OnEntityTransmit->GetCount() ||
 				pEdict->m_fStateFlags & FL_EDICT_ALWAYS) {
 			continue;
@@ -366,6 +454,34 @@ CTransmitCache *CTransmitManager::GetCache(unsigned int uiIndex)
 	return pCache;
 }
 
+TransmitMask_t &CTransmitManager::GetMask(unsigned int uiPlayer)
+{
+	TransmitPlayerMask_t *pMask;
+
+	TransmitPlayerMasks_t::const_iterator it = m_mapMasks.find(uiPlayer);
+	if (it != m_mapMasks.end()) {
+		pMask = it->second;
+	}
+	else {
+		pMask = new TransmitPlayerMask_t;
+		pMask->m_uiVersion = 0;
+		m_mapMasks[uiPlayer] = pMask;
+	}
+
+	// Only rebuild the mask if any of the rules changed
+	if (pMask->m_uiVersion != m_uiMasksVersion) {
+		pMask->m_vecMask.SetAll();
+
+		FOR_EACH_VEC(m_vecRules, i) {
+			m_vecRules[i]->ApplyMask(uiPlayer, pMask->m_vecMask);
+		}
+
+		pMask->m_uiVersion = m_uiMasksVersion;
+	}
+
+	return pMask->m_vecMask;
+}
+
 
 //-----------------------------------------------------------------------------
 // CTransmitCache class.
@@ -419,6 +535,13 @@ ETransmitMode ITransmitRules::GetMode()
 void ITransmitRules::SetMode(ETransmitMode eMode)
 {
 	m_eMode = eMode;
+	InvalidateMasks();
+}
+
+void ITransmitRules::InvalidateMasks()
+{
+	static CTransmitManager *pManager = GetTransmitManager();
+	pManager->InvalidateMasks();
 }
 
 
@@ -440,6 +563,29 @@ bool CTransmitHash::ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity)
 	return GetMode() == TRANSMIT_MODE_ALLOW ? !bResult : bResult;
 }
 
+void CTransmitHash::ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask)
+{
+	if (!HasElements()) {
+		return;
+	}
+
+	TransmitMasks_t::const_iterator it = m_mapMasks.find(uiPlayer);
+	if (it == m_mapMasks.end()) {
+		if (GetMode() == TRANSMIT_MODE_ALLOW) {
+			vecMask.ClearAll();
+		}
+
+		return;
+	}
+
+	if (GetMode() == TRANSMIT_MODE_ALLOW) {
+		AndMask(vecMask, it->second);
+	}
+	else {
+		AndNotMask(vecMask, it->second);
+	}
+}
+
 void CTransmitHash::AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther)
 {
 	if (!pEntity->IsPlayer() && !pOther->IsPlayer()) {
@@ -449,12 +595,28 @@ void CTransmitHash::AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOt
 		)
 	}
 
-	m_setPairs.insert(TransmitPair_t(pEntity->GetIndex(), pOther->GetIndex()));
+	unsigned int uiEntity = pEntity->GetIndex();
+	unsigned int uiOther = pOther->GetIndex();
+	if (!m_setPairs.insert(TransmitPair_t(uiEntity, uiOther)).second) {
+		return;
+	}
+
+	m_mapMasks[uiEntity].Set((int)uiOther);
+	m_mapMasks[uiOther].Set((int)uiEntity);
+	InvalidateMasks();
 }
 
 void CTransmitHash::RemovePair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther)
 {
-	m_setPairs.erase(TransmitPair_t(pEntity->GetIndex(), pOther->GetIndex()));
+	unsigned int uiEntity = pEntity->GetIndex();
+	unsigned int uiOther = pOther->GetIndex();
+	if (!m_setPairs.erase(TransmitPair_t(uiEntity, uiOther))) {
+		return;
+	}
+
+	m_mapMasks[uiEntity].Clear((int)uiOther);
+	m_mapMasks[uiOther].Clear((int)uiEntity);
+	InvalidateMasks();
 }
 
 void CTransmitHash::RemovePairs(CBaseEntityWrapper *pEntity)
@@ -462,17 +624,24 @@ void CTransmitHash::RemovePairs(CBaseEntityWrapper *pEntity)
 	unsigned int uiEntity = pEntity->GetIndex();
 	for (TransmitPairs_t::const_iterator it = m_setPairs.begin(); it != m_setPairs.end(); ) {
 		if (it->first == uiEntity || it->second == uiEntity) {
+			m_mapMasks[it->first == uiEntity ? it->second : it->first].Clear((int)uiEntity);
 			it = m_setPairs.erase(it);
 			continue;
 		}
 
 		++it;
 	}
+
+	if (m_mapMasks.erase(uiEntity)) {
+		InvalidateMasks();
+	}
 }
 
 void CTransmitHash::Clear()
 {
 	m_setPairs.clear();
+	m_mapMasks.clear();
+	InvalidateMasks();
 }
 
 bool CTransmitHash::Contains(CBaseEntityWrapper *pEntity)
@@ -569,17 +738,26 @@ void CTransmitSet::Add(CBaseEntityWrapper *pEntity)
 		)
 	}
 
-	m_pSet.insert(pEntity->GetIndex());
+	unsigned int uiEntity = pEntity->GetIndex();
+	m_pSet.insert(uiEntity);
+	m_vecEntities.Set((int)uiEntity);
+	InvalidateMasks();
 }
 
 void CTransmitSet::Remove(CBaseEntityWrapper *pEntity)
 {
-	m_pSet.erase(pEntity->GetIndex());
+	unsigned int uiEntity = pEntity->GetIndex();
+	if (!m_pSet.erase(uiEntity)) {
+		return;
+	}
+
+	m_vecEntities.Clear((int)uiEntity);
+	InvalidateMasks();
 }
 
 bool CTransmitSet::Contains(unsigned int uiEntity)
 {
-	return m_pSet.find(uiEntity) != m_pSet.end();
+	return uiEntity < MAX_EDICTS && m_vecEntities.IsBitSet((int)uiEntity);
 }
 
 bool CTransmitSet::Contains(CBaseEntityWrapper *pEntity)
@@ -590,6 +768,8 @@ bool CTransmitSet::Contains(CBaseEntityWrapper *pEntity)
 void CTransmitSet::Clear()
 {
 	m_pSet.clear();
+	m_vecEntities.ClearAll();
+	InvalidateMasks();
 }
 
 unsigned int CTransmitSet::GetSize()
@@ -626,10 +806,24 @@ bool CTransmitSet::ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity)
 		return true;
 	}
 
-	bool bResult = !(m_pSet.find(uiEntity) != m_pSet.end());
+	bool bResult = !Contains(uiEntity);
 	return GetMode() == TRANSMIT_MODE_ALLOW ? !bResult : bResult;
 };
 
+void CTransmitSet::ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask)
+{
+	if (!HasElements()) {
+		return;
+	}
+
+	if (GetMode() == TRANSMIT_MODE_ALLOW) {
+		AndMask(vecMask, m_vecEntities);
+	}
+	else {
+		AndNotMask(vecMask, m_vecEntities);
+	}
+}
+
 
 //-----------------------------------------------------------------------------
 // CTransmitMap class.
@@ -646,6 +840,7 @@ boost::shared_ptr<CTransmitSet> CTransmitMap::Find(unsigned int uiEntity)
 
 	boost::shared_ptr<CTransmitSet> spSet = boost::shared_ptr<CTransmitSet>(pSet);
 	m_mapSets[uiEntity] = spSet;
+	InvalidateMasks();
 
 	return spSet;
 }
@@ -657,12 +852,15 @@ boost::shared_ptr<CTransmitSet> CTransmitMap::Find(CBaseEntityWrapper *pEntity)
 
 void CTransmitMap::Remove(CBaseEntityWrapper *pEntity)
 {
-	m_mapSets.erase(pEntity->GetIndex());
+	if (m_mapSets.erase(pEntity->GetIndex())) {
+		InvalidateMasks();
+	}
 }
 
 void CTransmitMap::Clear()
 {
 	m_mapSets.clear();
+	InvalidateMasks();
 }
 
 bool CTransmitMap::Contains(unsigned int uiEntity)
@@ -723,6 +921,16 @@ bool CTransmitMap::ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity)
 	return GetMode() == TRANSMIT_MODE_ALLOW ? !bResult : bResult;
 }
 
+void CTransmitMap::ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask)
+{
+	// Only called when the rules changed, so walking the keys is fine
+	BOOST_FOREACH(TransmitMap_t::value_type it, m_mapSets) {
+		if (!ShouldTransmit(uiPlayer, it.first)) {
+			vecMask.Clear((int)it.first);
+		}
+	}
+}
+
 
 //-----------------------------------------------------------------------------
 // CTransmitListenerManager class.
@@ -60,6 +60,22 @@ typedef std::pair<unsigned int, unsigned int> TransmitPair_t;
 
 typedef CBitVec<MAX_EDICTS> TransmitStates_t;
 
+typedef CBitVec<MAX_EDICTS> TransmitMask_t;
+typedef boost::unordered_map<unsigned int, TransmitMask_t> TransmitMasks_t;
+
+
+//-----------------------------------------------------------------------------
+// TransmitPlayerMask_t structure.
+//-----------------------------------------------------------------------------
+struct TransmitPlayerMask_t
+{
+	// Version of the rules this mask was built from
+	unsigned int m_uiVersion;
+	TransmitMask_t m_vecMask;
+};
+
+typedef boost::unordered_map<unsigned int, TransmitPlayerMask_t *> TransmitPlayerMasks_t;
+
 
 //-----------------------------------------------------------------------------
 // CTransmitStates class.
@@ -95,12 +111,18 @@ public:
 
 	virtual bool ShouldTransmit(CBaseEntityWrapper *pPlayer, CBaseEntityWrapper *pEntity);
 
+	// Clears all entities from the mask that shouldn't be transmitted to the player
+	virtual void ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask) = 0;
+
 	virtual void Clear() = 0;
 	virtual void UnloadInstance();
 
 	ETransmitMode GetMode();
 	void SetMode(ETransmitMode eMode);
 
+protected:
+	void InvalidateMasks();
+
 private:
 	ETransmitMode m_eMode;
 };
@@ -148,10 +170,16 @@ public:
 	void RegisterTransmitHook(object oCallback);
 	void UnregisterTransmitHook(object oCallback);
 
+	void RegisterTransmitBufferHook(object oCallback);
+	void UnregisterTransmitBufferHook(object oCallback);
+
+	void InvalidateMasks();
+
 private:
 	static bool CheckTransmit(HookType_t eHookType, CHook *pHook);
 
 	CTransmitCache *GetCache(unsigned int uiIndex);
+	TransmitMask_t &GetMask(unsigned int uiPlayer);
 
 protected:
 	void IncRef();
@@ -165,7 +193,11 @@ private:
 	CHook *m_pHook;
 	TransmitCacheMap_t m_mapCache;
 
+	unsigned int m_uiMasksVersion;
+	TransmitPlayerMasks_t m_mapMasks;
+
 	CListenerManager *m_pTransmitHooks;
+	CListenerManager *m_pTransmitBufferHooks;
 };
 
 // Singleton accessor.
@@ -207,6 +239,7 @@ class CTransmitHash : public ITransmitRules
 public:
 	void OnEntityDeleted(CBaseEntityWrapper *pEntity);
 	bool ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity);
+	void ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask);
 
 	void AddPair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
 	void RemovePair(CBaseEntityWrapper *pEntity, CBaseEntityWrapper *pOther);
@@ -228,6 +261,9 @@ public:
 
 private:
 	TransmitPairs_t m_setPairs;
+
+	// Entities paired with each entity
+	TransmitMasks_t m_mapMasks;
 };
 
 
@@ -250,9 +286,11 @@ public:
 
 	void OnEntityDeleted(CBaseEntityWrapper *pEntity);
 	bool ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity);
+	void ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask);
 
 private:
 	TransmitSet_t m_pSet;
+	TransmitMask_t m_vecEntities;
 };
 
 
@@ -264,6 +302,7 @@ class CTransmitMap: public ITransmitRules
 public:
 	void OnEntityDeleted(CBaseEntityWrapper *pEntity);
 	bool ShouldTransmit(unsigned int uiPlayer, unsigned int uiEntity);
+	void ApplyMask(unsigned int uiPlayer, TransmitMask_t &vecMask);
 
 	boost::shared_ptr<CTransmitSet> Find(unsigned int uiEntity);
 	boost::shared_ptr<CTransmitSet> Find(CBaseEntityWrapper *pEntity);
@@ -93,6 +93,39 @@ void export_transmit_manager(scope _transmit)
 		args("self", "callback")
 	);
 
+	TransmitManager.def(
+		"register_buffer_hook",
+		&CTransmitManager::RegisterTransmitBufferHook,
+		"Registers a transmit buffer hook.\n"
+		"\n"
+		"The callback is called once per player and tick with the player's index, "
+		"a read-only memoryview of the edict indexes (format ``H``) and a writable "
+		"memoryview of the transmit states (format ``I``). Bit ``index % 32`` of "
+		"word ``index // 32`` defines whether the entity is transmitted. Both "
+		"views are backed by copies, and changes to the states are written back "
+		"once all callbacks have been called.\n"
+		"\n"
+		":param function callback:\n"
+		"	Function to register as a transmit buffer hook callback.\n"
+		"\n"
+		":raises ValueError:\n"
+		"	If the given callback is already registered.",
+		args("self", "callback")
+	);
+
+	TransmitManager.def(
+		"unregister_buffer_hook",
+		&CTransmitManager::UnregisterTransmitBufferHook,
+		"Unregisters a transmit buffer hook.\n"
+		"\n"
+		":param function callback:\n"
+		"	Function to unregister as a transmit buffer hook callback.\n"
+		"\n"
+		":raises ValueError:\n"
+		"	If the given callback was not registered.",
+		args("self", "callback")
+	);
+
 	// Singleton...
 	_transmit.attr("transmit_manager") = object(ptr(GetTransmitManager()));
 
@@ -33,6 +33,7 @@
 #include "igameevents.h"
 #include "modules/keyvalues/keyvalues.h"
 #include "events_generator.h"
+#include "events_schema.h"
 
 
 //-----------------------------------------------------------------------------
@@ -62,43 +63,95 @@ public:
 
 	static object __getitem__(IGameEvent* pEvent, const char* item)
 	{
-		object return_value = object();
-		try
+		KeyValues* pKey = GetVariables(pEvent)->FindKey(item);
+		if (pKey)
+			return KeyValuesExt::GetValue(pKey);
+
+		// Fields that haven't been set yet return their default value
+		const EventField_t* pField = FindField(pEvent, item);
+		if (!pField || pField->m_oDefault.is_none())
+			BOOST_RAISE_EXCEPTION(PyExc_KeyError, "Key '%s' does not exist.", item);
+
+		return pField->m_oDefault;
+	}
+
+	static dict as_dict(IGameEvent* pEvent)
+	{
+		dict result;
+		KeyValues* pVariables = GetVariables(pEvent);
+
+		CGameEventSchema* pSchema = GetGameEventSchema(GetDescriptor(pEvent));
+		if (pSchema)
+		{
+			for (unsigned int i=0; i < pSchema->m_vecFields.size(); ++i)
+			{
+				const EventField_t& field = pSchema->m_vecFields[i];
+				result[field.m_strName] = CGameEventSchema::ReadField(pVariables, field);
+			}
+		}
+
+		// Add variables that are not part of the event's declaration
+		for (KeyValues* pKey = pVariables->GetFirstSubKey(); pKey; pKey = pKey->GetNextKey())
+		{
+			if (!pSchema || !pSchema->FindField(pKey->GetName()))
+				result[pKey->GetName()] = KeyValuesExt::GetValue(pKey);
+		}
+
+		return result;
+	}
+
+	static object values(IGameEvent* pEvent, boost::python::tuple args, dict kwargs)
+	{
+		if (kwargs)
+			BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Keywords are not supported.")
+
+		KeyValues* pVariables = GetVariables(pEvent);
+		CGameEventSchema* pSchema = GetGameEventSchema(GetDescriptor(pEvent));
+
+		// Without keys, all declared fields are returned in their order
+		if (!len(args))
 		{
-			return KeyValuesExt::__getitem__(GetVariables(pEvent), item);
+			unsigned int uiCount = pSchema ? (unsigned int) pSchema->m_vecFields.size() : 0;
+			PyObject* pResult = PyTuple_New(uiCount);
+			for (unsigned int i=0; i < uiCount; ++i)
+			{
+				object value = CGameEventSchema::ReadField(pVariables, pSchema->m_vecFields[i]);
+				PyTuple_SET_ITEM(pResult, i, incref(value.ptr()));
+			}
+
+			return object(handle<>(pResult));
 		}
-		catch(...)
+
+		object result = object(handle<>(PyTuple_New(len(args))));
+		for (int i=0; i < len(args); ++i)
 		{
-			KeyValues *field = GetDescriptor(pEvent)->keys->FindKey(item);
-			if (field != NULL)
+			const char* szKey = extract<const char*>(args[i]);
+
+			object value;
+			const EventField_t* pField = pSchema ? pSchema->FindField(szKey) : NULL;
+			if (pField)
 			{
-				switch ((EventVarType)atoi(field->GetString()))
-				{
-					case TYPE_STRING:
-					case TYPE_WSTRING:
-						return_value = object("");
-						break;
-					case TYPE_FLOAT:
-						return_value = object(0.0f);
-						break;
-					case TYPE_LONG:
-					case TYPE_SHORT:
-					case TYPE_BYTE:
-					case TYPE_UINT64:
-						return_value = object(0);
-						break;
-					case TYPE_BOOL:
-						return_value = object(false);
-						break;
-				}
+				value = CGameEventSchema::ReadField(pVariables, *pField);
 			}
+			else
+			{
+				KeyValues* pKey = pVariables->FindKey(szKey);
+				if (!pKey)
+					BOOST_RAISE_EXCEPTION(PyExc_KeyError, "Key '%s' does not exist.", szKey);
 
-			if (return_value.ptr() == Py_None && PyErr_Occurred())
-				throw_error_already_set();
+				value = KeyValuesExt::GetValue(pKey);
+			}
 
-			PyErr_Clear();
+			PyTuple_SET_ITEM(result.ptr(), i, incref(value.ptr()));
 		}
-		return return_value;
+
+		return result;
+	}
+
+	static const EventField_t* FindField(IGameEvent* pEvent, const char* szName)
+	{
+		CGameEventSchema* pSchema = GetGameEventSchema(GetDescriptor(pEvent));
+		return pSchema ? pSchema->FindField(szName) : NULL;
 	}
 
 	static void __setitem__(IGameEvent* pEvent, const char* item, object value)
@@ -0,0 +1,254 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "events_hooks.h"
+#include "modules/memory/memory_function_info.h"
+#include "utilities/sp_util.h"
+
+
+//-----------------------------------------------------------------------------
+// Definitions.
+//-----------------------------------------------------------------------------
+// Event ids above this value are looked up by name without being cached
+#define MAX_CACHED_EVENT_ID 4096
+
+
+//-----------------------------------------------------------------------------
+// Externals.
+//-----------------------------------------------------------------------------
+extern IGameEventManager2 *gameeventmanager;
+
+
+//-----------------------------------------------------------------------------
+// CPreEventRouter class.
+//-----------------------------------------------------------------------------
+CPreEventRouter::CPreEventRouter():
+	m_bInitialized(false),
+	m_pHook(NULL)
+{
+}
+
+void CPreEventRouter::Initialize()
+{
+	if (m_bInitialized)
+		return;
+
+	CFunctionInfo *pInfo = GetFunctionInfo(&IGameEventManager2::FireEvent);
+	if (!pInfo)
+		BOOST_RAISE_EXCEPTION(
+			PyExc_ValueError,
+			"Failed to retrieve FireEvent's info."
+		)
+
+	CFunction *pFunc = CPointer((unsigned long)((void *)gameeventmanager)).MakeVirtualFunction(*pInfo);
+	delete pInfo;
+
+	if (!pFunc || !pFunc->IsHookable())
+		BOOST_RAISE_EXCEPTION(
+			PyExc_ValueError,
+			"FireEvent is invalid or not hookable."
+		)
+
+	void *pAddr = (void *)pFunc->m_ulAddr;
+	m_pHook = FindHook(pAddr);
+	if (!m_pHook)
+	{
+		m_pHook = HookFunction(pAddr, pFunc->m_pCallingConvention);
+		if (!m_pHook) {
+			delete pFunc;
+			BOOST_RAISE_EXCEPTION(
+				PyExc_ValueError,
+				"Failed to hook FireEvent."
+			)
+		}
+	}
+
+	delete pFunc;
+	m_pHook->AddCallback(
+		HOOKTYPE_PRE,
+		(HookHandlerFn *)&CPreEventRouter::FireEvent
+	);
+
+	m_bInitialized = true;
+}
+
+void CPreEventRouter::Subscribe(const char *szEventName, object oCallbacks)
+{
+	if (!PySequence_Check(oCallbacks.ptr()))
+		BOOST_RAISE_EXCEPTION(PyExc_TypeError, "The callbacks must be a sequence.")
+
+	// Events are only routed once the hook is installed
+	Initialize();
+
+	StringMap_t<object>::iterator it = m_mapSubscriptions.find(szEventName);
+	if (it != m_mapSubscriptions.end())
+		it->second = oCallbacks;
+	else
+		m_mapSubscriptions.emplace(szEventName, oCallbacks);
+
+	// The cache borrows its references from the map
+	m_vecCache.clear();
+}
+
+void CPreEventRouter::Unsubscribe(const char *szEventName)
+{
+	StringMap_t<object>::iterator it = m_mapSubscriptions.find(szEventName);
+	if (it == m_mapSubscriptions.end())
+		return;
+
+	m_vecCache.clear();
+	m_mapSubscriptions.erase(it);
+}
+
+bool CPreEventRouter::IsSubscribed(const char *szEventName)
+{
+	return m_mapSubscriptions.find(szEventName) != m_mapSubscriptions.end();
+}
+
+void CPreEventRouter::Clear()
+{
+	m_vecCache.clear();
+	m_mapSubscriptions.clear();
+}
+
+PyObject *CPreEventRouter::FindCallbacks(IGameEvent *pEvent)
+{
+	if (m_mapSubscriptions.empty())
+		return NULL;
+
+	CGameEventDescriptor *pDescriptor = IGameEventExt::GetDescriptor(pEvent);
+	int iEventID = pDescriptor ? pDescriptor->eventid : -1;
+
+	if (iEventID < 0 || iEventID >= MAX_CACHED_EVENT_ID)
+	{
+		StringMap_t<object>::iterator it = m_mapSubscriptions.find(pEvent->GetName());
+		return it != m_mapSubscriptions.end() ? it->second.ptr() : NULL;
+	}
+
+	if ((unsigned int) iEventID >= m_vecCache.size())
+	{
+		PreEventCache_t empty = {NULL, NULL};
+		m_vecCache.resize(iEventID + 1, empty);
+	}
+
+	// The descriptor changes if the events have been reloaded
+	PreEventCache_t &cache = m_vecCache[iEventID];
+	if (cache.m_pDescriptor != pDescriptor)
+	{
+		StringMap_t<object>::iterator it = m_mapSubscriptions.find(pEvent->GetName());
+		cache.m_pDescriptor = pDescriptor;
+		cache.m_pCallbacks = it != m_mapSubscriptions.end() ? it->second.ptr() : NULL;
+	}
+
+	return cache.m_pCallbacks;
+}
+
+EventAction CPreEventRouter::CallCallbacks(PyObject *pCallbacks, IGameEvent *pEvent)
+{
+	EventAction eAction = EVENT_ACTION_CONTINUE;
+
+	try
+	{
+		// Callbacks are allowed to unregister themselves
+		object oCallbacks = object(handle<>(PySequence_Tuple(pCallbacks)));
+		object oEvent = object(ptr(pEvent));
+
+		for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(oCallbacks.ptr()); ++i)
+		{
+			try
+			{
+				object oCallback = object(handle<>(borrowed(PyTuple_GET_ITEM(oCallbacks.ptr(), i))));
+				object oAction = oCallback(oEvent);
+				if (oAction.is_none())
+					continue;
+
+				extract<int> extractAction(oAction);
+				int iAction = extractAction.check() ? extractAction() : -1;
+				if (iAction < EVENT_ACTION_CONTINUE || iAction > EVENT_ACTION_BLOCK)
+					BOOST_RAISE_EXCEPTION(
+						PyExc_ValueError,
+						"Invalid return value for pre-event \"%s\".",
+						extract<const char *>(str(oAction))()
+					)
+
+				// Keep the action with the highest priority
+				if (iAction > eAction)
+					eAction = (EventAction) iAction;
+			}
+			catch (...)
+			{
+				PrintCurrentException(false);
+			}
+		}
+	}
+	catch (...)
+	{
+		PrintCurrentException(false);
+	}
+
+	return eAction;
+}
+
+bool CPreEventRouter::FireEvent(HookType_t eHookType, CHook *pHook)
+{
+	static CPreEventRouter *pRouter = GetPreEventRouter();
+
+	IGameEvent *pEvent = pHook->GetArgument<IGameEvent *>(1);
+
+	// Crashfix for CS:GO:
+	// https://github.com/Source-Python-Dev-Team/Source.Python/issues/230
+	if (!pEvent)
+	{
+		pHook->SetReturnValue<bool>(false);
+		return true;
+	}
+
+	// Unsubscribed events never reach Python
+	PyObject *pCallbacks = pRouter->FindCallbacks(pEvent);
+	if (!pCallbacks)
+		return false;
+
+	switch (pRouter->CallCallbacks(pCallbacks, pEvent))
+	{
+		case EVENT_ACTION_STOP_BROADCAST:
+			pHook->SetArgument<bool>(2, true);
+			break;
+
+		case EVENT_ACTION_BLOCK:
+			gameeventmanager->FreeEvent(pEvent);
+			pHook->SetReturnValue<bool>(false);
+			return true;
+
+		default:
+			break;
+	}
+
+	return false;
+}
@@ -0,0 +1,110 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _EVENTS_HOOKS_H
+#define _EVENTS_HOOKS_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// C++
+#include <vector>
+
+// Source.Python
+#include "utilities/wrap_macros.h"
+#include "events.h"
+#include "modules/memory/memory_hooks.h"
+#include "utilities/string_map.h"
+
+
+//-----------------------------------------------------------------------------
+// EventAction enum.
+//-----------------------------------------------------------------------------
+// Must match events.hooks.EventAction
+enum EventAction
+{
+	EVENT_ACTION_CONTINUE = 0,
+	EVENT_ACTION_STOP_BROADCAST,
+	EVENT_ACTION_BLOCK
+};
+
+
+//-----------------------------------------------------------------------------
+// PreEventCache_t structure.
+//-----------------------------------------------------------------------------
+struct PreEventCache_t
+{
+	CGameEventDescriptor *m_pDescriptor;
+
+	// Borrowed from the subscription map or NULL if nobody is subscribed
+	PyObject *m_pCallbacks;
+};
+
+
+//-----------------------------------------------------------------------------
+// CPreEventRouter class.
+//-----------------------------------------------------------------------------
+class CPreEventRouter
+{
+public:
+	friend CPreEventRouter *GetPreEventRouter();
+
+private:
+	CPreEventRouter();
+
+public:
+	// The callbacks are called with the GameEvent instance in their order
+	void Subscribe(const char *szEventName, object oCallbacks);
+	void Unsubscribe(const char *szEventName);
+	bool IsSubscribed(const char *szEventName);
+	void Clear();
+
+	static bool FireEvent(HookType_t eHookType, CHook *pHook);
+
+private:
+	void Initialize();
+	PyObject *FindCallbacks(IGameEvent *pEvent);
+	EventAction CallCallbacks(PyObject *pCallbacks, IGameEvent *pEvent);
+
+private:
+	bool m_bInitialized;
+	CHook *m_pHook;
+
+	StringMap_t<object> m_mapSubscriptions;
+
+	// Indexed by the descriptor's event id
+	std::vector<PreEventCache_t> m_vecCache;
+};
+
+// Singleton accessor.
+inline CPreEventRouter *GetPreEventRouter()
+{
+	static CPreEventRouter *s_pPreEventRouter = new CPreEventRouter;
+	return s_pPreEventRouter;
+}
+
+
+#endif // _EVENTS_HOOKS_H
@@ -0,0 +1,105 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include "export_main.h"
+#include "utilities/wrap_macros.h"
+#include "events_hooks.h"
+#include "modules/memory/memory_tools.h"
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+void export_pre_event_router(scope);
+
+
+//-----------------------------------------------------------------------------
+// Declare the _events._hooks module.
+//-----------------------------------------------------------------------------
+DECLARE_SP_SUBMODULE(_events, _hooks)
+{
+	export_pre_event_router(_hooks);
+}
+
+
+//-----------------------------------------------------------------------------
+// Exports CPreEventRouter.
+//-----------------------------------------------------------------------------
+void export_pre_event_router(scope _hooks)
+{
+	class_<CPreEventRouter, boost::noncopyable> PreEventRouter("PreEventRouter", no_init);
+
+	// Methods...
+	PreEventRouter.def(
+		"subscribe",
+		&CPreEventRouter::Subscribe,
+		"Route the given event to the given callbacks before it is fired.\n"
+		"\n"
+		":param str event_name:\n"
+		"	Name of the event.\n"
+		":param callbacks:\n"
+		"	A sequence of callables that are called with the :class:`events.GameEvent`\n"
+		"	instance. The sequence is not copied, so later changes to it are\n"
+		"	picked up automatically. The return values are interpreted as\n"
+		"	:class:`events.hooks.EventAction`.",
+		args("self", "event_name", "callbacks")
+	);
+
+	PreEventRouter.def(
+		"unsubscribe",
+		&CPreEventRouter::Unsubscribe,
+		"Stop routing the given event. Nothing happens if it was not subscribed.\n"
+		"\n"
+		":param str event_name:\n"
+		"	Name of the event.",
+		args("self", "event_name")
+	);
+
+	PreEventRouter.def(
+		"clear",
+		&CPreEventRouter::Clear,
+		"Stop routing all events."
+	);
+
+	// Special methods...
+	PreEventRouter.def(
+		"__contains__",
+		&CPreEventRouter::IsSubscribed,
+		"Return whether the given event is subscribed.\n"
+		"\n"
+		":rtype: bool",
+		args("self", "event_name")
+	);
+
+	// Singleton...
+	_hooks.attr("pre_event_router") = object(ptr(GetPreEventRouter()));
+
+	// Add memory tools...
+	PreEventRouter ADD_MEM_TOOLS(CPreEventRouter);
+}
@@ -0,0 +1,150 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "events_schema.h"
+#include "modules/keyvalues/keyvalues.h"
+
+// SDK
+#include "vstdlib/IKeyValuesSystem.h"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs.
+//-----------------------------------------------------------------------------
+typedef boost::unordered_flat_map<int, CGameEventSchema *> GameEventSchemaMap_t;
+
+
+//-----------------------------------------------------------------------------
+// Helper functions.
+//-----------------------------------------------------------------------------
+static object GetDefaultValue(EventVarType eType)
+{
+	switch (eType)
+	{
+		case TYPE_STRING:
+		case TYPE_WSTRING:
+			return object("");
+		case TYPE_FLOAT:
+			return object(0.0f);
+		case TYPE_LONG:
+		case TYPE_SHORT:
+		case TYPE_BYTE:
+		case TYPE_UINT64:
+			return object(0);
+		case TYPE_BOOL:
+			return object(false);
+		default:
+			return object();
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// CGameEventSchema class.
+//-----------------------------------------------------------------------------
+CGameEventSchema::CGameEventSchema(CGameEventDescriptor *pDescriptor)
+{
+	if (!pDescriptor->keys)
+		return;
+
+	for (KeyValues *pKey = pDescriptor->keys->GetFirstSubKey(); pKey; pKey = pKey->GetNextKey())
+	{
+		EventField_t field;
+		field.m_strName = pKey->GetName();
+		field.m_iSymbol = KeyValuesSystem()->GetSymbolForString(pKey->GetName());
+		field.m_eType = (EventVarType) atoi(pKey->GetString());
+		field.m_oDefault = GetDefaultValue(field.m_eType);
+
+		m_mapSlots.emplace(field.m_strName, (unsigned int) m_vecFields.size());
+		m_vecFields.push_back(field);
+	}
+}
+
+const EventField_t *CGameEventSchema::FindField(const char *szName)
+{
+	StringMap_t<unsigned int>::iterator it = m_mapSlots.find(szName);
+	if (it == m_mapSlots.end())
+		return NULL;
+
+	return &m_vecFields[it->second];
+}
+
+bool CGameEventSchema::Matches(CGameEventDescriptor *pDescriptor)
+{
+	// Only compares symbols and integers, so it's cheap enough for every lookup
+	KeyValues *pKey = pDescriptor->keys ? pDescriptor->keys->GetFirstSubKey() : NULL;
+	for (std::vector<EventField_t>::const_iterator it = m_vecFields.begin(); it != m_vecFields.end(); ++it)
+	{
+		if (!pKey || pKey->GetNameSymbol() != it->m_iSymbol || pKey->GetInt() != it->m_eType)
+			return false;
+
+		pKey = pKey->GetNextKey();
+	}
+
+	return pKey == NULL;
+}
+
+object CGameEventSchema::ReadField(KeyValues *pVariables, const EventField_t &field)
+{
+	KeyValues *pKey = pVariables ? pVariables->FindKey(field.m_iSymbol) : NULL;
+	if (!pKey)
+		return field.m_oDefault;
+
+	return KeyValuesExt::GetValue(pKey);
+}
+
+
+//-----------------------------------------------------------------------------
+// Functions.
+//-----------------------------------------------------------------------------
+CGameEventSchema *GetGameEventSchema(CGameEventDescriptor *pDescriptor)
+{
+	static GameEventSchemaMap_t s_mapSchemas;
+
+	if (!pDescriptor)
+		return NULL;
+
+	// The descriptors are stored in a vector that is reallocated when events
+	// are added, so use the event ID instead
+	CGameEventSchema *&pSchema = s_mapSchemas[pDescriptor->eventid];
+
+	// Events are re-registered with new keys if an event file is reloaded.
+	// The new keys might be allocated at the same address, so compare them.
+	if (pSchema && !pSchema->Matches(pDescriptor))
+	{
+		delete pSchema;
+		pSchema = NULL;
+	}
+
+	if (!pSchema)
+		pSchema = new CGameEventSchema(pDescriptor);
+
+	return pSchema;
+}
@@ -0,0 +1,94 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _EVENTS_SCHEMA_H
+#define _EVENTS_SCHEMA_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// C++
+#include <string>
+#include <vector>
+
+// Source.Python
+#include "utilities/wrap_macros.h"
+#include "utilities/string_map.h"
+#include "events_generator.h"
+
+// Boost
+#include "boost/unordered/unordered_flat_map.hpp"
+
+// SDK
+#include "tier1/KeyValues.h"
+
+
+//-----------------------------------------------------------------------------
+// EventField_t structure.
+//-----------------------------------------------------------------------------
+struct EventField_t
+{
+	std::string m_strName;
+	int m_iSymbol;
+	EventVarType m_eType;
+
+	// Returned if the event doesn't carry a value for the field
+	object m_oDefault;
+};
+
+
+//-----------------------------------------------------------------------------
+// CGameEventSchema class.
+//-----------------------------------------------------------------------------
+// The fields of an event as declared by its descriptor.
+class CGameEventSchema
+{
+public:
+	CGameEventSchema(CGameEventDescriptor *pDescriptor);
+
+	const EventField_t *FindField(const char *szName);
+
+	// Return whether the descriptor still declares the same fields
+	bool Matches(CGameEventDescriptor *pDescriptor);
+
+	// Return the value of the field or its default value
+	static object ReadField(KeyValues *pVariables, const EventField_t &field);
+
+public:
+	std::vector<EventField_t> m_vecFields;
+	StringMap_t<unsigned int> m_mapSlots;
+};
+
+
+//-----------------------------------------------------------------------------
+// Functions.
+//-----------------------------------------------------------------------------
+// Return the schema of the given event. Schemas are compiled once per event ID
+// and rebuilt if the event has been re-registered with other fields.
+CGameEventSchema *GetGameEventSchema(CGameEventDescriptor *pDescriptor);
+
+
+#endif // _EVENTS_SCHEMA_H
@@ -160,6 +160,20 @@ static void export_igameevent(scope _events)
 			"Sets an event variable."
 		)
 
+		.def("as_dict",
+			&IGameEventExt::as_dict,
+			"Return all event variables as a dict. Declared variables that haven't been set yet are included with their default value.\n\n"
+			":rtype: dict"
+		)
+
+		.def("values",
+			raw_method(&IGameEventExt::values),
+			"Return the values of the given event variables as a tuple in their proper data type. "
+			"If no key was passed, the values of all declared variables are returned in their declared order.\n\n"
+			":raise KeyError: Raised if a key is neither declared nor set.\n"
+			":rtype: tuple"
+		)
+
 		ADD_MEM_TOOLS(IGameEvent)
 	;
 
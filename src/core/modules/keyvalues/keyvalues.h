@@ -184,6 +184,12 @@ public:
 			BOOST_RAISE_EXCEPTION(PyExc_KeyError, "Key '%s' does not exist.", key);
 		}
 
+		return GetValue(subkey);
+	}
+
+	// Return the value of the given key in its proper data type.
+	static object GetValue(KeyValues* subkey)
+	{
 		switch (subkey->GetDataType())
 		{
 			case KeyValues::TYPE_NONE: return object(ptr(subkey)); break;
@@ -272,7 +278,7 @@ public:
 				result[name] = as_dict(pCurrent);
 			}
 			else {
-				result[name] = __getitem__(pKeyValues, name);
+				result[name] = GetValue(pCurrent);
 			}
 
 			pCurrent = pCurrent->GetNextKey();
@@ -28,6 +28,7 @@
 // Includes.
 //-----------------------------------------------------------------------------
 #include "listeners_manager.h"
+#include "listeners_output.h"
 #include "sp_main.h"
 #include "utilities/sp_util.h"
 
@@ -207,7 +208,9 @@ SpewRetval_t SP_SpewOutput( SpewType_t spewType, const tchar *pMsg )
 {
 	static CServerOutputListenerManager *pManager = GetOnServerOutputListenerManager();
 
-	if (!pManager->CallCallbacks((MessageSeverity)spewType, pMsg) && pManager->m_pOldSpewOutputFunc) {
+	const Color *pColor = GetSpewOutputColor();
+	if (!pManager->OnServerOutput((MessageSeverity)spewType, pColor ? *pColor : Color(255, 255, 255, 255), pMsg)
+		&& pManager->m_pOldSpewOutputFunc) {
 		return pManager->m_pOldSpewOutputFunc(spewType, pMsg);
 	}
 
@@ -221,7 +224,7 @@ public:
 	{
 		static CServerOutputListenerManager *pManager = GetOnServerOutputListenerManager();
 
-		if (!pManager->CallCallbacks((MessageSeverity)pContext->m_Severity, pMessage))
+		if (!pManager->OnServerOutput((MessageSeverity)pContext->m_Severity, pContext->m_Color, pMessage))
 		{
 			// Restore the old logging state before SP has been loaded
 			LoggingSystem_PopLoggingState(false);
@@ -252,8 +255,9 @@ public:
 // CServerOutputListenerManager constructor.
 //-----------------------------------------------------------------------------
 CServerOutputListenerManager::CServerOutputListenerManager()
+	:m_uiHookUsers(0)
 #if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
-	:m_pOldSpewOutputFunc(NULL)
+	,m_pOldSpewOutputFunc(NULL)
 #endif
 {
 }
@@ -264,6 +268,27 @@ CServerOutputListenerManager::CServerOutputListenerManager()
 //-----------------------------------------------------------------------------
 void CServerOutputListenerManager::Initialize()
 {
+	AcquireHook();
+}
+
+
+//-----------------------------------------------------------------------------
+// Called when the last callback is being unregistered.
+//-----------------------------------------------------------------------------
+void CServerOutputListenerManager::Finalize()
+{
+	ReleaseHook();
+}
+
+
+//-----------------------------------------------------------------------------
+// Installs the server output hook for its first user.
+//-----------------------------------------------------------------------------
+void CServerOutputListenerManager::AcquireHook()
+{
+	if (m_uiHookUsers++)
+		return;
+
 #if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
 	DevMsg(1, MSG_PREFIX "Retrieving old output function...\n");
 	m_pOldSpewOutputFunc = GetSpewOutputFunc();
@@ -283,10 +308,13 @@ void CServerOutputListenerManager::Initialize()
 
 
 //-----------------------------------------------------------------------------
-// Called when the last callback is being unregistered.
+// Removes the server output hook after its last user is gone.
 //-----------------------------------------------------------------------------
-void CServerOutputListenerManager::Finalize()
+void CServerOutputListenerManager::ReleaseHook()
 {
+	if (!m_uiHookUsers || --m_uiHookUsers)
+		return;
+
 #if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
 	if (m_pOldSpewOutputFunc) {
 		DevMsg(1, MSG_PREFIX "Restoring old output function...\n");
@@ -299,6 +327,21 @@ void CServerOutputListenerManager::Finalize()
 }
 
 
+//-----------------------------------------------------------------------------
+// Called by the server output hook for every message.
+//-----------------------------------------------------------------------------
+bool CServerOutputListenerManager::OnServerOutput(MessageSeverity severity, const Color &color, const tchar *pMsg)
+{
+	// Only take the lock if somebody is able to block the message
+	if (GetCount() && CallCallbacks(severity, pMsg))
+		return true;
+
+	static CServerOutputCapture *pCapture = GetServerOutputCapture();
+	pCapture->Capture(severity, color, pMsg);
+	return false;
+}
+
+
 //-----------------------------------------------------------------------------
 // Calls all registered server output callbacks.
 //-----------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include "utlvector.h"
 #include "convar.h"
 #include "dbg.h"
+#include "Color.h"
 #include "tier0/threadtools.h"
 
 
@@ -129,10 +130,17 @@ public:
 	virtual void Initialize();
 	virtual void Finalize();
 
+	// The hook stays installed as long as it has at least one user
+	void AcquireHook();
+	void ReleaseHook();
+
+	// Returns true if the output should be blocked
+	bool OnServerOutput(MessageSeverity severity, const Color &color, const tchar *pMsg);
 	bool CallCallbacks(MessageSeverity severity, const tchar *pMsg);
 
 public:
 	CThreadMutex m_Mutex;
+	unsigned int m_uiHookUsers;
 
 #if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
 	SpewOutputFunc_t m_pOldSpewOutputFunc;
@@ -0,0 +1,447 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// C++
+#include <chrono>
+#include <string.h>
+#include <time.h>
+
+// Boost
+#include "boost/optional.hpp"
+
+// Source.Python
+#include "listeners_output.h"
+#include "utilities/sp_util.h"
+
+
+//-----------------------------------------------------------------------------
+// External variables.
+//-----------------------------------------------------------------------------
+extern CServerOutputListenerManager *GetOnServerOutputListenerManager();
+extern COutputBatchListenerManager *GetOnServerOutputBatchListenerManager();
+
+
+//-----------------------------------------------------------------------------
+// COutputBuffer class.
+//-----------------------------------------------------------------------------
+COutputBuffer::COutputBuffer()
+	:m_uiHead(0),
+	m_uiTail(0),
+	m_uiDropped(0)
+{
+	// A slot can be written once its sequence matches the head
+	for (unsigned int i = 0; i < OUTPUT_BUFFER_SIZE; ++i)
+		m_Slots[i].m_uiSequence.store(i, std::memory_order_relaxed);
+}
+
+bool COutputBuffer::Push(MessageSeverity severity, const Color &color, double dTimestamp, const tchar *pMsg)
+{
+	Slot_t *pSlot;
+	unsigned int uiPosition = m_uiHead.load(std::memory_order_relaxed);
+
+	for (;;)
+	{
+		pSlot = &m_Slots[uiPosition & OUTPUT_BUFFER_MASK];
+		int iDiff = (int) (pSlot->m_uiSequence.load(std::memory_order_acquire) - uiPosition);
+
+		if (iDiff == 0)
+		{
+			// Reserve the slot
+			if (m_uiHead.compare_exchange_weak(uiPosition, uiPosition + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (iDiff < 0)
+		{
+			// The consumer didn't catch up yet
+			m_uiDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			// Another producer took the slot
+			uiPosition = m_uiHead.load(std::memory_order_relaxed);
+		}
+	}
+
+	OutputRecord_t &record = pSlot->m_Record;
+	record.m_Severity = severity;
+	record.m_Color = color;
+	record.m_dTimestamp = dTimestamp;
+
+	size_t uiLength = pMsg ? strlen(pMsg) : 0;
+	if (uiLength >= OUTPUT_RECORD_LENGTH)
+		uiLength = OUTPUT_RECORD_LENGTH - 1;
+
+	memcpy(record.m_szMessage, pMsg, uiLength);
+	record.m_szMessage[uiLength] = '\0';
+
+	// Publish the record to the consumer
+	pSlot->m_uiSequence.store(uiPosition + 1, std::memory_order_release);
+	return true;
+}
+
+OutputRecord_t *COutputBuffer::Front()
+{
+	Slot_t &slot = m_Slots[m_uiTail & OUTPUT_BUFFER_MASK];
+	if (slot.m_uiSequence.load(std::memory_order_acquire) != m_uiTail + 1)
+		return NULL;
+
+	return &slot.m_Record;
+}
+
+void COutputBuffer::Pop()
+{
+	// Hand the slot back to the producers
+	m_Slots[m_uiTail & OUTPUT_BUFFER_MASK].m_uiSequence.store(
+		m_uiTail + OUTPUT_BUFFER_SIZE, std::memory_order_release);
+
+	++m_uiTail;
+}
+
+unsigned int COutputBuffer::GetDropped()
+{
+	return m_uiDropped.exchange(0, std::memory_order_relaxed);
+}
+
+
+//-----------------------------------------------------------------------------
+// COutputFileSink class.
+//-----------------------------------------------------------------------------
+COutputFileSink::COutputFileSink()
+	:m_uiMaxBytes(0),
+	m_uiBackups(0),
+	m_pFile(NULL),
+	m_ulWritten(0),
+	m_bStop(false)
+{
+}
+
+COutputFileSink::~COutputFileSink()
+{
+	Close();
+}
+
+void COutputFileSink::Open(const char *szPath, unsigned int uiMaxBytes, unsigned int uiBackups)
+{
+	// Open the new file first, so a failure doesn't close the current one
+	FILE *pFile = fopen(szPath, "ab");
+	if (!pFile)
+		BOOST_RAISE_EXCEPTION(PyExc_IOError, "Unable to open '%s'.", szPath)
+
+	Close();
+
+	fseek(pFile, 0, SEEK_END);
+	m_ulWritten = (unsigned long) ftell(pFile);
+	m_pFile = pFile;
+
+	m_strPath = szPath;
+	m_uiMaxBytes = uiMaxBytes;
+	m_uiBackups = uiBackups;
+
+	m_bStop = false;
+	m_Thread = std::thread(&COutputFileSink::Run, this);
+}
+
+void COutputFileSink::Close()
+{
+	if (!IsOpen())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bStop = true;
+	}
+
+	// The writer thread flushes all pending chunks before it exits
+	m_Signal.notify_one();
+	m_Thread.join();
+
+	if (m_pFile)
+	{
+		fclose(m_pFile);
+		m_pFile = NULL;
+	}
+
+	m_strPath.clear();
+}
+
+bool COutputFileSink::IsOpen()
+{
+	// The file itself belongs to the writer thread
+	return m_Thread.joinable();
+}
+
+const char *COutputFileSink::GetPath()
+{
+	return m_strPath.c_str();
+}
+
+void COutputFileSink::Write(std::string &strChunk)
+{
+	if (!IsOpen() || strChunk.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Pending.push_back(std::string());
+		m_Pending.back().swap(strChunk);
+	}
+
+	m_Signal.notify_one();
+}
+
+void COutputFileSink::Run()
+{
+	std::deque<std::string> chunks;
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	for (;;)
+	{
+		m_Signal.wait(lock, [this] { return m_bStop || !m_Pending.empty(); });
+
+		chunks.swap(m_Pending);
+		bool bStop = m_bStop;
+		lock.unlock();
+
+		for (std::deque<std::string>::iterator it = chunks.begin(); it != chunks.end() && m_pFile; ++it)
+		{
+			fwrite(it->data(), 1, it->size(), m_pFile);
+			m_ulWritten += (unsigned long) it->size();
+
+			if (m_uiMaxBytes && m_ulWritten >= m_uiMaxBytes)
+				Rotate();
+		}
+
+		chunks.clear();
+		if (m_pFile)
+			fflush(m_pFile);
+
+		lock.lock();
+		if (bStop && m_Pending.empty())
+			break;
+	}
+}
+
+void COutputFileSink::Rotate()
+{
+	fclose(m_pFile);
+
+	if (m_uiBackups)
+	{
+		// log.N-1 -> log.N, ..., log -> log.1
+		std::string strTarget = m_strPath + "." + std::to_string(m_uiBackups);
+		remove(strTarget.c_str());
+
+		for (unsigned int i = m_uiBackups - 1; i > 0; --i)
+		{
+			std::string strSource = m_strPath + "." + std::to_string(i);
+			rename(strSource.c_str(), strTarget.c_str());
+			strTarget.swap(strSource);
+		}
+
+		rename(m_strPath.c_str(), strTarget.c_str());
+		m_pFile = fopen(m_strPath.c_str(), "ab");
+	}
+	else
+	{
+		// Without backups the file simply starts over
+		m_pFile = fopen(m_strPath.c_str(), "wb");
+	}
+
+	m_ulWritten = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// COutputBatchListenerManager class.
+//-----------------------------------------------------------------------------
+void COutputBatchListenerManager::Initialize()
+{
+	GetServerOutputCapture()->Acquire();
+}
+
+void COutputBatchListenerManager::Finalize()
+{
+	GetServerOutputCapture()->Release();
+}
+
+
+//-----------------------------------------------------------------------------
+// CServerOutputCapture class.
+//-----------------------------------------------------------------------------
+CServerOutputCapture::CServerOutputCapture()
+	:m_bActive(false),
+	m_uiUsers(0),
+	m_uiDropped(0),
+	m_bLineStart(true)
+{
+}
+
+void CServerOutputCapture::Capture(MessageSeverity severity, const Color &color, const tchar *pMsg)
+{
+	if (!m_bActive.load(std::memory_order_relaxed))
+		return;
+
+	double dTimestamp = std::chrono::duration<double>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+
+	m_Buffer.Push(severity, color, dTimestamp, pMsg);
+}
+
+void CServerOutputCapture::Drain()
+{
+	if (!m_bActive.load(std::memory_order_relaxed))
+		return;
+
+	static COutputBatchListenerManager *pManager = GetOnServerOutputBatchListenerManager();
+	bool bNotify = pManager->GetCount() > 0;
+	bool bWrite = m_Sink.IsOpen();
+
+	// Python might not be available anymore if we are only writing to a file
+	boost::optional<list> records;
+	if (bNotify)
+		records.emplace();
+
+	std::string strChunk;
+
+	// Don't let a flood of output keep us in this loop forever
+	for (unsigned int i = 0; i < OUTPUT_BUFFER_SIZE; ++i)
+	{
+		OutputRecord_t *pRecord = m_Buffer.Front();
+		if (!pRecord)
+			break;
+
+		if (bNotify)
+		{
+			records->append(make_tuple(
+				pRecord->m_Severity,
+				make_str(pRecord->m_szMessage, "ignore"),
+				pRecord->m_Color,
+				pRecord->m_dTimestamp));
+		}
+
+		if (bWrite)
+			FormatLine(strChunk, pRecord);
+
+		m_Buffer.Pop();
+	}
+
+	m_uiDropped += m_Buffer.GetDropped();
+
+	if (bWrite)
+		m_Sink.Write(strChunk);
+
+	if (bNotify && len(*records))
+		CALL_LISTENERS_WITH_MNGR(pManager, *records);
+}
+
+void CServerOutputCapture::FormatLine(std::string &strChunk, OutputRecord_t *pRecord)
+{
+	if (m_bLineStart)
+	{
+		// Same prefix the engine uses for its log files
+		time_t tTime = (time_t) pRecord->m_dTimestamp;
+		char szPrefix[32];
+		strftime(szPrefix, sizeof(szPrefix), "L %m/%d/%Y - %H:%M:%S: ", localtime(&tTime));
+		strChunk += szPrefix;
+	}
+
+	size_t uiLength = strlen(pRecord->m_szMessage);
+	if (!uiLength)
+		return;
+
+	strChunk.append(pRecord->m_szMessage, uiLength);
+	m_bLineStart = pRecord->m_szMessage[uiLength - 1] == '\n';
+}
+
+void CServerOutputCapture::OpenLog(const char *szPath, unsigned int uiMaxBytes, unsigned int uiBackups)
+{
+	bool bWasOpen = m_Sink.IsOpen();
+
+	// Write everything that belongs to the current file
+	if (bWasOpen)
+		Drain();
+
+	m_Sink.Open(szPath, uiMaxBytes, uiBackups);
+	m_bLineStart = true;
+
+	if (!bWasOpen)
+		Acquire();
+}
+
+void CServerOutputCapture::CloseLog()
+{
+	if (!m_Sink.IsOpen())
+		return;
+
+	Drain();
+	m_Sink.Close();
+	Release();
+}
+
+object CServerOutputCapture::GetLogPath()
+{
+	if (!m_Sink.IsOpen())
+		return object();
+
+	return object(m_Sink.GetPath());
+}
+
+unsigned int CServerOutputCapture::GetDropped()
+{
+	m_uiDropped += m_Buffer.GetDropped();
+	return m_uiDropped;
+}
+
+bool CServerOutputCapture::IsActive()
+{
+	return m_bActive.load(std::memory_order_relaxed);
+}
+
+void CServerOutputCapture::Acquire()
+{
+	if (m_uiUsers++)
+		return;
+
+	m_bActive.store(true, std::memory_order_relaxed);
+	GetOnServerOutputListenerManager()->AcquireHook();
+}
+
+void CServerOutputCapture::Release()
+{
+	if (!m_uiUsers || --m_uiUsers)
+		return;
+
+	GetOnServerOutputListenerManager()->ReleaseHook();
+	m_bActive.store(false, std::memory_order_relaxed);
+
+	// Nobody is interested in the remaining lines
+	while (m_Buffer.Front())
+		m_Buffer.Pop();
+}
@@ -0,0 +1,214 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _LISTENERS_OUTPUT_H
+#define _LISTENERS_OUTPUT_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// C++
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+// Source.Python
+#include "utilities/wrap_macros.h"
+#include "modules/core/core.h"
+#include "listeners_manager.h"
+
+// SDK
+#include "Color.h"
+
+
+//-----------------------------------------------------------------------------
+// Constants.
+//-----------------------------------------------------------------------------
+// The capture buffer holds 2^OUTPUT_BUFFER_BITS lines
+#define OUTPUT_BUFFER_BITS 10
+#define OUTPUT_BUFFER_SIZE (1 << OUTPUT_BUFFER_BITS)
+#define OUTPUT_BUFFER_MASK (OUTPUT_BUFFER_SIZE - 1)
+
+// Longer lines are truncated
+#define OUTPUT_RECORD_LENGTH 512
+
+
+//-----------------------------------------------------------------------------
+// OutputRecord_t structure.
+//-----------------------------------------------------------------------------
+struct OutputRecord_t
+{
+	MessageSeverity m_Severity;
+	Color m_Color;
+
+	// Seconds since the epoch, same clock as Python's time.time()
+	double m_dTimestamp;
+
+	char m_szMessage[OUTPUT_RECORD_LENGTH];
+};
+
+
+//-----------------------------------------------------------------------------
+// COutputBuffer class.
+//-----------------------------------------------------------------------------
+// Bounded ring buffer. Any thread can push lines without locking, but only a
+// single consumer is allowed to read them.
+class COutputBuffer
+{
+public:
+	COutputBuffer();
+
+	// Returns false if the buffer is full and the line has been dropped
+	bool Push(MessageSeverity severity, const Color &color, double dTimestamp, const tchar *pMsg);
+
+	// Returns the oldest record or NULL if the buffer is empty
+	OutputRecord_t *Front();
+	void Pop();
+
+	unsigned int GetDropped();
+
+private:
+	struct Slot_t
+	{
+		std::atomic<unsigned int> m_uiSequence;
+		OutputRecord_t m_Record;
+	};
+
+	Slot_t m_Slots[OUTPUT_BUFFER_SIZE];
+	std::atomic<unsigned int> m_uiHead;
+	unsigned int m_uiTail;
+	std::atomic<unsigned int> m_uiDropped;
+};
+
+
+//-----------------------------------------------------------------------------
+// COutputFileSink class.
+//-----------------------------------------------------------------------------
+// Writes chunks of text to a file on a background thread.
+class COutputFileSink
+{
+public:
+	COutputFileSink();
+	~COutputFileSink();
+
+	void Open(const char *szPath, unsigned int uiMaxBytes, unsigned int uiBackups);
+	void Close();
+
+	bool IsOpen();
+	const char *GetPath();
+
+	// Hands the chunk over to the writer thread. The string is left empty
+	void Write(std::string &strChunk);
+
+private:
+	void Run();
+	void Rotate();
+
+private:
+	std::string m_strPath;
+	unsigned int m_uiMaxBytes;
+	unsigned int m_uiBackups;
+
+	// Owned by the writer thread while the sink is open
+	FILE *m_pFile;
+	unsigned long m_ulWritten;
+
+	std::thread m_Thread;
+	std::mutex m_Mutex;
+	std::condition_variable m_Signal;
+	std::deque<std::string> m_Pending;
+	bool m_bStop;
+};
+
+
+//-----------------------------------------------------------------------------
+// COutputBatchListenerManager class.
+//-----------------------------------------------------------------------------
+class COutputBatchListenerManager: public CListenerManager
+{
+public:
+	virtual void Initialize();
+	virtual void Finalize();
+};
+
+
+//-----------------------------------------------------------------------------
+// CServerOutputCapture class.
+//-----------------------------------------------------------------------------
+class CServerOutputCapture
+{
+public:
+	friend CServerOutputCapture *GetServerOutputCapture();
+
+private:
+	CServerOutputCapture();
+
+public:
+	// Can be called from any thread
+	void Capture(MessageSeverity severity, const Color &color, const tchar *pMsg);
+
+	// Called every game frame
+	void Drain();
+
+	void OpenLog(const char *szPath, unsigned int uiMaxBytes = 0, unsigned int uiBackups = 0);
+	void CloseLog();
+	object GetLogPath();
+
+	unsigned int GetDropped();
+	bool IsActive();
+
+	// Every user keeps the server output hook installed
+	void Acquire();
+	void Release();
+
+private:
+	void FormatLine(std::string &strChunk, OutputRecord_t *pRecord);
+
+private:
+	COutputBuffer m_Buffer;
+	COutputFileSink m_Sink;
+
+	std::atomic<bool> m_bActive;
+	unsigned int m_uiUsers;
+	unsigned int m_uiDropped;
+
+	// Whether the next record starts a new line in the log file
+	bool m_bLineStart;
+};
+
+// Singleton accessor.
+inline CServerOutputCapture *GetServerOutputCapture()
+{
+	static CServerOutputCapture *s_pServerOutputCapture = new CServerOutputCapture;
+	return s_pServerOutputCapture;
+}
+
+
+#endif // _LISTENERS_OUTPUT_H
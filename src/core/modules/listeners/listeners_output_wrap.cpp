@@ -0,0 +1,118 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include "export_main.h"
+#include "utilities/wrap_macros.h"
+#include "listeners_output.h"
+#include "modules/memory/memory_tools.h"
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+void export_server_output_capture(scope);
+
+
+//-----------------------------------------------------------------------------
+// Declare the _listeners._output module.
+//-----------------------------------------------------------------------------
+DECLARE_SP_SUBMODULE(_listeners, _output)
+{
+	export_server_output_capture(_output);
+}
+
+
+//-----------------------------------------------------------------------------
+// Exports CServerOutputCapture.
+//-----------------------------------------------------------------------------
+void export_server_output_capture(scope _output)
+{
+	class_<CServerOutputCapture, boost::noncopyable> ServerOutputCapture("ServerOutputCapture", no_init);
+
+	// Methods...
+	ServerOutputCapture.def(
+		"open_log",
+		&CServerOutputCapture::OpenLog,
+		"Write all server output to the given file. The file is written on a background thread.\n"
+		"\n"
+		":param str path:\n"
+		"	Path of the log file. Output is appended if the file already exists.\n"
+		":param int max_bytes:\n"
+		"	If not 0, the file is rotated as soon as it reaches this size.\n"
+		":param int backups:\n"
+		"	Number of rotated files (``path.1`` to ``path.<backups>``) to keep.\n"
+		"	If 0, the file is truncated when it is rotated.\n"
+		":raise IOError:\n"
+		"	Raised if the file could not be opened.",
+		("self", arg("path"), arg("max_bytes")=0, arg("backups")=0)
+	);
+
+	ServerOutputCapture.def(
+		"close_log",
+		&CServerOutputCapture::CloseLog,
+		"Write all pending output and close the log file."
+	);
+
+	ServerOutputCapture.def(
+		"drain",
+		&CServerOutputCapture::Drain,
+		"Deliver all captured output immediately instead of waiting for the next frame."
+	);
+
+	// Properties...
+	ServerOutputCapture.add_property(
+		"log_path",
+		&CServerOutputCapture::GetLogPath,
+		"Return the path of the current log file or None if no file is open.\n"
+		"\n"
+		":rtype: str"
+	);
+
+	ServerOutputCapture.add_property(
+		"dropped",
+		&CServerOutputCapture::GetDropped,
+		"Return the number of lines that have been dropped, because the capture buffer was full.\n"
+		"\n"
+		":rtype: int"
+	);
+
+	ServerOutputCapture.add_property(
+		"active",
+		&CServerOutputCapture::IsActive,
+		"Return whether server output is currently being captured.\n"
+		"\n"
+		":rtype: bool"
+	);
+
+	// Singleton...
+	_output.attr("server_output_capture") = object(ptr(GetServerOutputCapture()));
+
+	// Add memory tools...
+	ServerOutputCapture ADD_MEM_TOOLS(CServerOutputCapture);
+}
@@ -0,0 +1,380 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// C++
+#include <chrono>
+#include <math.h>
+
+// Source.Python
+#include "listeners_tick.h"
+
+
+//-----------------------------------------------------------------------------
+// TimerList_t structure.
+//-----------------------------------------------------------------------------
+void TimerList_t::Append(Timer_t *pTimer)
+{
+	pTimer->m_pList = this;
+	pTimer->m_pNext = NULL;
+	pTimer->m_pPrev = m_pTail;
+
+	if (m_pTail)
+		m_pTail->m_pNext = pTimer;
+	else
+		m_pHead = pTimer;
+
+	m_pTail = pTimer;
+}
+
+void TimerList_t::Unlink(Timer_t *pTimer)
+{
+	if (pTimer->m_pPrev)
+		pTimer->m_pPrev->m_pNext = pTimer->m_pNext;
+	else
+		m_pHead = pTimer->m_pNext;
+
+	if (pTimer->m_pNext)
+		pTimer->m_pNext->m_pPrev = pTimer->m_pPrev;
+	else
+		m_pTail = pTimer->m_pPrev;
+
+	pTimer->m_pPrev = NULL;
+	pTimer->m_pNext = NULL;
+	pTimer->m_pList = NULL;
+}
+
+Timer_t *TimerList_t::PopFront()
+{
+	Timer_t *pTimer = m_pHead;
+	if (pTimer)
+		Unlink(pTimer);
+
+	return pTimer;
+}
+
+
+//-----------------------------------------------------------------------------
+// CTimerWheel class.
+//-----------------------------------------------------------------------------
+CTimerWheel::CTimerWheel():
+	m_ullCurrent(0),
+	m_uiCount(0)
+{
+	memset(m_Slots, 0, sizeof(m_Slots));
+	memset(m_uiLevelCounts, 0, sizeof(m_uiLevelCounts));
+	memset(&m_Overflow, 0, sizeof(m_Overflow));
+	memset(&m_Ready, 0, sizeof(m_Ready));
+}
+
+void CTimerWheel::Reset(unsigned long long ullNow)
+{
+	m_ullCurrent = ullNow;
+}
+
+void CTimerWheel::Add(Timer_t *pTimer)
+{
+	++m_uiCount;
+
+	if (pTimer->m_ullExpires <= m_ullCurrent) {
+		m_Ready.Append(pTimer);
+		return;
+	}
+
+	unsigned long long ullDelta = pTimer->m_ullExpires - m_ullCurrent;
+	for (int iLevel=0; iLevel < TIMER_WHEEL_LEVELS; iLevel++) {
+		if (ullDelta < (1ULL << (TIMER_WHEEL_BITS * (iLevel + 1)))) {
+			int iSlot = (pTimer->m_ullExpires >> (TIMER_WHEEL_BITS * iLevel)) & TIMER_WHEEL_MASK;
+			m_Slots[iLevel][iSlot].Append(pTimer);
+			++m_uiLevelCounts[iLevel];
+			return;
+		}
+	}
+
+	m_Overflow.Append(pTimer);
+}
+
+void CTimerWheel::Remove(Timer_t *pTimer)
+{
+	if (!pTimer->m_pList)
+		return;
+
+	int iLevel = GetLevel(pTimer->m_pList);
+	if (iLevel != -1)
+		--m_uiLevelCounts[iLevel];
+
+	pTimer->m_pList->Unlink(pTimer);
+	--m_uiCount;
+}
+
+void CTimerWheel::Cascade(int iLevel)
+{
+	TimerList_t *pList;
+	if (iLevel < TIMER_WHEEL_LEVELS) {
+		int iSlot = (m_ullCurrent >> (TIMER_WHEEL_BITS * iLevel)) & TIMER_WHEEL_MASK;
+		pList = &m_Slots[iLevel][iSlot];
+
+		for (Timer_t *pTimer = pList->m_pHead; pTimer; pTimer = pTimer->m_pNext)
+			--m_uiLevelCounts[iLevel];
+	}
+	else {
+		pList = &m_Overflow;
+	}
+
+	// Re-add all timers of this slot, so they end up in a lower level
+	Timer_t *pHead = pList->m_pHead;
+	pList->m_pHead = NULL;
+	pList->m_pTail = NULL;
+
+	while (pHead) {
+		Timer_t *pNext = pHead->m_pNext;
+		--m_uiCount;
+		Add(pHead);
+		pHead = pNext;
+	}
+}
+
+void CTimerWheel::Advance(unsigned long long ullNow)
+{
+	while (m_ullCurrent < ullNow) {
+		// Nothing to do, so skip ahead
+		if (!m_uiCount) {
+			m_ullCurrent = ullNow;
+			return;
+		}
+
+		// If the lower levels are empty, nothing can expire before the next
+		// slot of the first non-empty level is cascaded
+		unsigned long long ullNext = m_ullCurrent + 1;
+		for (int iLevel=0; iLevel < TIMER_WHEEL_LEVELS && !m_uiLevelCounts[iLevel]; iLevel++)
+			ullNext = (m_ullCurrent | ((1ULL << (TIMER_WHEEL_BITS * (iLevel + 1))) - 1)) + 1;
+
+		if (ullNext > ullNow) {
+			m_ullCurrent = ullNow;
+			return;
+		}
+
+		m_ullCurrent = ullNext;
+
+		int iSlot = m_ullCurrent & TIMER_WHEEL_MASK;
+		for (int iLevel=1; !iSlot && iLevel <= TIMER_WHEEL_LEVELS; iLevel++) {
+			Cascade(iLevel);
+			iSlot = iLevel < TIMER_WHEEL_LEVELS ? (m_ullCurrent >> (TIMER_WHEEL_BITS * iLevel)) & TIMER_WHEEL_MASK : 1;
+		}
+
+		Timer_t *pTimer;
+		while ((pTimer = m_Slots[0][m_ullCurrent & TIMER_WHEEL_MASK].PopFront()) != NULL) {
+			--m_uiLevelCounts[0];
+			m_Ready.Append(pTimer);
+		}
+	}
+}
+
+Timer_t *CTimerWheel::PopReady()
+{
+	Timer_t *pTimer = m_Ready.PopFront();
+	if (pTimer)
+		--m_uiCount;
+
+	return pTimer;
+}
+
+int CTimerWheel::GetLevel(TimerList_t *pList)
+{
+	if (pList < &m_Slots[0][0] || pList > &m_Slots[TIMER_WHEEL_LEVELS - 1][TIMER_WHEEL_MASK])
+		return -1;
+
+	return (pList - &m_Slots[0][0]) / TIMER_WHEEL_SIZE;
+}
+
+unsigned long long CTimerWheel::GetCurrent()
+{
+	return m_ullCurrent;
+}
+
+
+//-----------------------------------------------------------------------------
+// CTickScheduler class.
+//-----------------------------------------------------------------------------
+CTickScheduler::CTickScheduler():
+	m_ullTicks(0),
+	m_uiNextHandle(0)
+{
+	m_TimeWheel.Reset((unsigned long long)(GetTime() * 1000));
+}
+
+CTickScheduler::~CTickScheduler()
+{
+	CancelAll();
+}
+
+double CTickScheduler::GetTime()
+{
+	// Same clock as Python's time.time()
+	return std::chrono::duration<double>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+unsigned int CTickScheduler::Schedule(double dExecTime, object oCallback, double dInterval)
+{
+	Timer_t *pTimer = new Timer_t;
+	pTimer->m_bTickBased = false;
+	pTimer->m_oCallback = oCallback;
+
+	// Round up, so the timer never runs before the given time
+	double dExpires = ceil(dExecTime * 1000);
+	pTimer->m_ullExpires = dExpires > 0 ? (unsigned long long)dExpires : 0;
+	// A negative interval creates a one-shot timer
+	pTimer->m_bRepeat = dInterval >= 0;
+	pTimer->m_ullInterval = pTimer->m_bRepeat ? (unsigned long long)ceil(dInterval * 1000) : 0;
+
+	return Add(pTimer);
+}
+
+unsigned int CTickScheduler::ScheduleTicks(int iTicks, object oCallback, int iInterval)
+{
+	Timer_t *pTimer = new Timer_t;
+	pTimer->m_bTickBased = true;
+	pTimer->m_oCallback = oCallback;
+	pTimer->m_ullExpires = m_TickWheel.GetCurrent() + (iTicks > 0 ? iTicks : 0);
+	pTimer->m_bRepeat = iInterval >= 0;
+	pTimer->m_ullInterval = pTimer->m_bRepeat ? iInterval : 0;
+
+	return Add(pTimer);
+}
+
+unsigned int CTickScheduler::Add(Timer_t *pTimer)
+{
+	// 0 is never used as a handle
+	if (!++m_uiNextHandle) {
+		++m_uiNextHandle;
+	}
+
+	pTimer->m_uiHandle = m_uiNextHandle;
+	pTimer->m_bCancelled = false;
+	pTimer->m_pList = NULL;
+
+	(pTimer->m_bTickBased ? m_TickWheel : m_TimeWheel).Add(pTimer);
+	m_mapTimers[pTimer->m_uiHandle] = pTimer;
+
+	return pTimer->m_uiHandle;
+}
+
+bool CTickScheduler::Cancel(unsigned int uiHandle)
+{
+	TimerMap_t::iterator it = m_mapTimers.find(uiHandle);
+	if (it == m_mapTimers.end()) {
+		return false;
+	}
+
+	Timer_t *pTimer = it->second;
+	m_mapTimers.erase(it);
+
+	// The timer is currently being executed, so let Run() delete it
+	if (!pTimer->m_pList) {
+		pTimer->m_bCancelled = true;
+		return true;
+	}
+
+	(pTimer->m_bTickBased ? m_TickWheel : m_TimeWheel).Remove(pTimer);
+	delete pTimer;
+	return true;
+}
+
+bool CTickScheduler::IsScheduled(unsigned int uiHandle)
+{
+	return m_mapTimers.find(uiHandle) != m_mapTimers.end();
+}
+
+unsigned int CTickScheduler::GetCount()
+{
+	return m_mapTimers.size();
+}
+
+void CTickScheduler::CancelAll()
+{
+	while (!m_mapTimers.empty()) {
+		Cancel(m_mapTimers.begin()->first);
+	}
+}
+
+void CTickScheduler::OnTick()
+{
+	// Count the ticks ourselves, because the engine's tick count is reset
+	// on map changes
+	++m_ullTicks;
+
+	if (m_mapTimers.empty()) {
+		// Keep the wheels in sync, so new timers are added relative to now
+		m_TimeWheel.Reset((unsigned long long)(GetTime() * 1000));
+		m_TickWheel.Reset(m_ullTicks);
+		return;
+	}
+
+	m_TimeWheel.Advance((unsigned long long)(GetTime() * 1000));
+	Run(m_TimeWheel);
+
+	m_TickWheel.Advance(m_ullTicks);
+	Run(m_TickWheel);
+}
+
+void CTickScheduler::Run(CTimerWheel &wheel)
+{
+	Timer_t *pTimer;
+	while ((pTimer = wheel.PopReady()) != NULL) {
+		// Keep the callback alive, even if the timer is cancelled by it
+		object oCallback = pTimer->m_oCallback;
+
+		BEGIN_BOOST_PY()
+			oCallback();
+		END_BOOST_PY_NORET()
+
+		if (pTimer->m_bCancelled) {
+			delete pTimer;
+			continue;
+		}
+
+		if (!pTimer->m_bRepeat) {
+			m_mapTimers.erase(pTimer->m_uiHandle);
+			delete pTimer;
+			continue;
+		}
+
+		// Re-arm repeating timers relative to their previous deadline, so a
+		// late tick doesn't make them drift. Periods that have been missed
+		// entirely are skipped, so they are run at most once per tick.
+		unsigned long long ullInterval = pTimer->m_ullInterval ? pTimer->m_ullInterval : 1;
+		unsigned long long ullNow = wheel.GetCurrent();
+
+		pTimer->m_ullExpires += ullInterval;
+		if (pTimer->m_ullExpires <= ullNow)
+			pTimer->m_ullExpires += ((ullNow - pTimer->m_ullExpires) / ullInterval + 1) * ullInterval;
+
+		wheel.Add(pTimer);
+	}
+}
@@ -0,0 +1,181 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _LISTENERS_TICK_H
+#define _LISTENERS_TICK_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "utilities/wrap_macros.h"
+
+// Boost
+#include "boost/unordered_map.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Constants.
+//-----------------------------------------------------------------------------
+// Each level of the wheel has 2^TIMER_WHEEL_BITS slots
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SIZE (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SIZE - 1)
+#define TIMER_WHEEL_LEVELS 4
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+struct TimerList_t;
+
+
+//-----------------------------------------------------------------------------
+// Timer_t structure.
+//-----------------------------------------------------------------------------
+struct Timer_t
+{
+	Timer_t *m_pPrev;
+	Timer_t *m_pNext;
+	TimerList_t *m_pList;
+
+	// Expiration time in units of the owning wheel
+	unsigned long long m_ullExpires;
+
+	// Re-arm interval of repeating timers
+	unsigned long long m_ullInterval;
+
+	unsigned int m_uiHandle;
+	bool m_bRepeat;
+	bool m_bTickBased;
+	bool m_bCancelled;
+	object m_oCallback;
+};
+
+
+//-----------------------------------------------------------------------------
+// TimerList_t structure.
+//-----------------------------------------------------------------------------
+struct TimerList_t
+{
+	Timer_t *m_pHead;
+	Timer_t *m_pTail;
+
+	void Append(Timer_t *pTimer);
+	void Unlink(Timer_t *pTimer);
+	Timer_t *PopFront();
+};
+
+
+//-----------------------------------------------------------------------------
+// CTimerWheel class.
+//-----------------------------------------------------------------------------
+class CTimerWheel
+{
+public:
+	CTimerWheel();
+
+	void Reset(unsigned long long ullNow);
+	void Add(Timer_t *pTimer);
+	void Remove(Timer_t *pTimer);
+
+	// Moves all timers that expired until the given time to the ready list
+	void Advance(unsigned long long ullNow);
+	Timer_t *PopReady();
+
+	unsigned long long GetCurrent();
+
+private:
+	void Cascade(int iLevel);
+	int GetLevel(TimerList_t *pList);
+
+private:
+	unsigned long long m_ullCurrent;
+	TimerList_t m_Slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
+	unsigned int m_uiLevelCounts[TIMER_WHEEL_LEVELS];
+
+	// Timers that are too far in the future for the wheel
+	TimerList_t m_Overflow;
+	TimerList_t m_Ready;
+
+	unsigned int m_uiCount;
+};
+
+
+//-----------------------------------------------------------------------------
+// CTickScheduler class.
+//-----------------------------------------------------------------------------
+typedef boost::unordered_map<unsigned int, Timer_t *> TimerMap_t;
+
+class CTickScheduler
+{
+public:
+	friend CTickScheduler *GetTickScheduler();
+
+private:
+	CTickScheduler();
+	~CTickScheduler();
+
+public:
+	unsigned int Schedule(double dExecTime, object oCallback, double dInterval = -1);
+	unsigned int ScheduleTicks(int iTicks, object oCallback, int iInterval = -1);
+
+	bool Cancel(unsigned int uiHandle);
+	bool IsScheduled(unsigned int uiHandle);
+	unsigned int GetCount();
+
+	void CancelAll();
+
+	// Called every game frame
+	void OnTick();
+
+	static double GetTime();
+
+private:
+	unsigned int Add(Timer_t *pTimer);
+	void Run(CTimerWheel &wheel);
+
+private:
+	// Units are milliseconds since the epoch
+	CTimerWheel m_TimeWheel;
+
+	// Units are ticks since the scheduler has been created
+	CTimerWheel m_TickWheel;
+	unsigned long long m_ullTicks;
+
+	TimerMap_t m_mapTimers;
+	unsigned int m_uiNextHandle;
+};
+
+// Singleton accessor.
+inline CTickScheduler *GetTickScheduler()
+{
+	static CTickScheduler *s_pTickScheduler = new CTickScheduler;
+	return s_pTickScheduler;
+}
+
+
+#endif // _LISTENERS_TICK_H
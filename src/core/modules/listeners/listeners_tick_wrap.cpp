@@ -0,0 +1,137 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include "export_main.h"
+#include "utilities/wrap_macros.h"
+#include "listeners_tick.h"
+#include "modules/memory/memory_tools.h"
+
+
+//-----------------------------------------------------------------------------
+// Forward declarations.
+//-----------------------------------------------------------------------------
+void export_tick_scheduler(scope);
+
+
+//-----------------------------------------------------------------------------
+// Declare the _listeners._tick module.
+//-----------------------------------------------------------------------------
+DECLARE_SP_SUBMODULE(_listeners, _tick)
+{
+	export_tick_scheduler(_tick);
+}
+
+
+//-----------------------------------------------------------------------------
+// Exports CTickScheduler.
+//-----------------------------------------------------------------------------
+void export_tick_scheduler(scope _tick)
+{
+	class_<CTickScheduler, boost::noncopyable> TickScheduler("TickScheduler", no_init);
+
+	// Methods...
+	TickScheduler.def(
+		"schedule",
+		&CTickScheduler::Schedule,
+		"Schedules a callback.\n"
+		"\n"
+		":param float exec_time:\n"
+		"	Time (as returned by :func:`time.time`) when the callback should be called.\n"
+		":param callback:\n"
+		"	Callable object that is called without arguments.\n"
+		":param float interval:\n"
+		"	If not negative, the callback is called again every ``interval`` seconds until it's cancelled.\n"
+		":return:\n"
+		"	A handle that can be used to cancel the callback.\n"
+		":rtype: int",
+		("self", arg("exec_time"), arg("callback"), arg("interval")=-1)
+	);
+
+	TickScheduler.def(
+		"schedule_ticks",
+		&CTickScheduler::ScheduleTicks,
+		"Schedules a callback that is called after the given number of ticks.\n"
+		"\n"
+		":param int ticks:\n"
+		"	Number of ticks to wait.\n"
+		":param callback:\n"
+		"	Callable object that is called without arguments.\n"
+		":param int interval:\n"
+		"	If not negative, the callback is called again every ``interval`` ticks until it's cancelled.\n"
+		":return:\n"
+		"	A handle that can be used to cancel the callback.\n"
+		":rtype: int",
+		("self", arg("ticks"), arg("callback"), arg("interval")=-1)
+	);
+
+	TickScheduler.def(
+		"cancel",
+		&CTickScheduler::Cancel,
+		"Cancels a scheduled callback.\n"
+		"\n"
+		":param int handle:\n"
+		"	The handle returned by :meth:`schedule` or :meth:`schedule_ticks`.\n"
+		":return:\n"
+		"	Return whether the callback was scheduled.\n"
+		":rtype: bool",
+		args("self", "handle")
+	);
+
+	TickScheduler.def(
+		"is_scheduled",
+		&CTickScheduler::IsScheduled,
+		"Return whether the given handle is scheduled.\n"
+		"\n"
+		":rtype: bool",
+		args("self", "handle")
+	);
+
+	TickScheduler.def(
+		"get_time",
+		&CTickScheduler::GetTime,
+		"Return the current time of the scheduler's clock.\n"
+		"\n"
+		":rtype: float"
+	).staticmethod("get_time");
+
+	// Special methods...
+	TickScheduler.def(
+		"__len__",
+		&CTickScheduler::GetCount,
+		"Return the number of scheduled callbacks.\n"
+		"\n"
+		":rtype: int"
+	);
+
+	// Singleton...
+	_tick.attr("tick_scheduler") = object(ptr(GetTickScheduler()));
+
+	// Add memory tools...
+	TickScheduler ADD_MEM_TOOLS(CTickScheduler);
+}
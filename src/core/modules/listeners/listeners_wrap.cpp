@@ -30,6 +30,7 @@
 #include "export_main.h"
 #include "utilities/wrap_macros.h"
 #include "listeners_manager.h"
+#include "listeners_output.h"
 #include "modules/entities/entities_collisions.h"
 #include "modules/entities/entities_transmit.h"
 
@@ -79,6 +80,12 @@ CServerOutputListenerManager *GetOnServerOutputListenerManager()
 	return &s_OnServerOutput;
 }
 
+static COutputBatchListenerManager s_OnServerOutputBatch;
+COutputBatchListenerManager *GetOnServerOutputBatchListenerManager()
+{
+	return &s_OnServerOutputBatch;
+}
+
 
 //-----------------------------------------------------------------------------
 // Forward declarations.
@@ -190,6 +197,7 @@ void export_listener_managers(scope _listeners)
 	_listeners.attr("on_data_unloaded_listener_manager") = object(ptr(GetOnDataUnloadedListenerManager()));
 	
 	_listeners.attr("on_server_output_listener_manager") = object(ptr((CListenerManager *)GetOnServerOutputListenerManager()));
+	_listeners.attr("on_server_output_batch_listener_manager") = object(ptr((CListenerManager *)GetOnServerOutputBatchListenerManager()));
 	
 	_listeners.attr("on_player_run_command_listener_manager") = object(ptr(GetOnPlayerRunCommandListenerManager()));
 	_listeners.attr("on_player_post_run_command_listener_manager") = object(ptr(GetOnPlayerPostRunCommandListenerManager()));
@@ -0,0 +1,152 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+// ============================================================================
+// >> INCLUDES
+// ============================================================================
+#include "memory_field.h"
+#include "memory_pointer.h"
+#include "memory_utilities.h"
+#include "utilities/wrap_macros.h"
+
+
+// ============================================================================
+// >> FIELD ACCESSORS
+// ============================================================================
+template<class T>
+object GetField(unsigned long ulAddr)
+{
+	return object(CPointer(ulAddr).Get<T>());
+}
+
+template<class T>
+void SetField(unsigned long ulAddr, object value)
+{
+	T val = extract<T>(value);
+	CPointer(ulAddr).Set<T>(val);
+}
+
+object GetPointerField(unsigned long ulAddr)
+{
+	return object(CPointer(CPointer(ulAddr).Get<unsigned long>()));
+}
+
+void SetPointerField(unsigned long ulAddr, object value)
+{
+	CPointer(ulAddr).Set<unsigned long>(ExtractAddress(value));
+}
+
+void GetFieldAccessors(DataType_t eType, FieldGetterFn& pGetter, FieldSetterFn& pSetter)
+{
+	switch(eType)
+	{
+		case DATA_TYPE_BOOL:		pGetter = &GetField<bool>; pSetter = &SetField<bool>; break;
+		case DATA_TYPE_CHAR:		pGetter = &GetField<char>; pSetter = &SetField<char>; break;
+		case DATA_TYPE_UCHAR:		pGetter = &GetField<unsigned char>; pSetter = &SetField<unsigned char>; break;
+		case DATA_TYPE_SHORT:		pGetter = &GetField<short>; pSetter = &SetField<short>; break;
+		case DATA_TYPE_USHORT:		pGetter = &GetField<unsigned short>; pSetter = &SetField<unsigned short>; break;
+		case DATA_TYPE_INT:			pGetter = &GetField<int>; pSetter = &SetField<int>; break;
+		case DATA_TYPE_UINT:		pGetter = &GetField<unsigned int>; pSetter = &SetField<unsigned int>; break;
+		case DATA_TYPE_LONG:		pGetter = &GetField<long>; pSetter = &SetField<long>; break;
+		case DATA_TYPE_ULONG:		pGetter = &GetField<unsigned long>; pSetter = &SetField<unsigned long>; break;
+		case DATA_TYPE_LONG_LONG:	pGetter = &GetField<long long>; pSetter = &SetField<long long>; break;
+		case DATA_TYPE_ULONG_LONG:	pGetter = &GetField<unsigned long long>; pSetter = &SetField<unsigned long long>; break;
+		case DATA_TYPE_FLOAT:		pGetter = &GetField<float>; pSetter = &SetField<float>; break;
+		case DATA_TYPE_DOUBLE:		pGetter = &GetField<double>; pSetter = &SetField<double>; break;
+		case DATA_TYPE_POINTER:		pGetter = &GetPointerField; pSetter = &SetPointerField; break;
+		case DATA_TYPE_STRING:		pGetter = &GetField<const char *>; pSetter = &SetField<const char *>; break;
+		default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unsupported field type.")
+	}
+}
+
+
+// ============================================================================
+// >> CFieldDescriptor
+// ============================================================================
+CFieldDescriptor::CFieldDescriptor(int iOffset, object oDataType, object oConverter, object oSetter, bool bIndirect)
+{
+	m_iOffset = iOffset;
+	m_bIndirect = bIndirect;
+	m_oDataType = oDataType;
+	m_oConverter = oConverter;
+	m_oSetter = oSetter;
+	m_pGetter = NULL;
+	m_pSetter = NULL;
+
+	if (!oDataType.is_none())
+	{
+		GetFieldAccessors(extract<DataType_t>(oDataType), m_pGetter, m_pSetter);
+	}
+	else if (oConverter.is_none())
+	{
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Either a data type or a converter is required.")
+	}
+}
+
+unsigned long CFieldDescriptor::GetFieldAddress(object instance)
+{
+	CPointer* pPtr = extract<CPointer*>(instance);
+	pPtr->Validate();
+
+	if (m_bIndirect)
+		return CPointer(pPtr->m_ulAddr).Get<unsigned long>(m_iOffset);
+
+	return pPtr->m_ulAddr + m_iOffset;
+}
+
+object CFieldDescriptor::__get__(object self, object instance, object owner)
+{
+	if (instance.is_none())
+		return self;
+
+	CFieldDescriptor& descriptor = extract<CFieldDescriptor&>(self);
+	unsigned long ulAddr = descriptor.GetFieldAddress(instance);
+
+	if (descriptor.m_pGetter)
+		return descriptor.m_pGetter(ulAddr);
+
+	return descriptor.m_oConverter(CPointer(ulAddr));
+}
+
+void CFieldDescriptor::__set__(object instance, object value)
+{
+	if (m_pSetter)
+	{
+		// Indirect fields that don't point to anything yet are handled by the
+		// setter, so it can allocate the memory.
+		unsigned long ulAddr = GetFieldAddress(instance);
+		if (ulAddr || !m_bIndirect)
+		{
+			m_pSetter(ulAddr, value);
+			return;
+		}
+	}
+
+	if (m_oSetter.is_none())
+		BOOST_RAISE_EXCEPTION(PyExc_AttributeError, "Field is read-only.")
+
+	m_oSetter(instance, value);
+}
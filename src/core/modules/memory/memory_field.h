@@ -0,0 +1,78 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef MEMORY_FIELD_H
+#define MEMORY_FIELD_H
+
+//---------------------------------------------------------------------------------
+// Includes
+//---------------------------------------------------------------------------------
+#include "boost/python.hpp"
+using namespace boost::python;
+
+// DynamicHooks
+#include "convention.h"
+
+
+//---------------------------------------------------------------------------------
+// Typedefs
+//---------------------------------------------------------------------------------
+typedef object (*FieldGetterFn)(unsigned long ulAddr);
+typedef void (*FieldSetterFn)(unsigned long ulAddr, object value);
+
+
+//---------------------------------------------------------------------------------
+// CFieldDescriptor
+//---------------------------------------------------------------------------------
+class CFieldDescriptor
+{
+public:
+	// If a data type is given, the value is loaded and stored directly.
+	// Otherwise the converter is called with a Pointer to the field and the
+	// setter is called with the instance and the new value.
+	CFieldDescriptor(int iOffset, object oDataType=object(), object oConverter=object(),
+		object oSetter=object(), bool bIndirect=false);
+
+	static object __get__(object self, object instance, object owner);
+	void __set__(object instance, object value);
+
+private:
+	unsigned long GetFieldAddress(object instance);
+
+public:
+	int m_iOffset;
+	bool m_bIndirect;
+	object m_oDataType;
+	object m_oConverter;
+	object m_oSetter;
+
+private:
+	FieldGetterFn m_pGetter;
+	FieldSetterFn m_pSetter;
+};
+
+
+#endif // MEMORY_FIELD_H
@@ -49,12 +49,6 @@
 #include "utilities/call_python.h"
 
 
-// ============================================================================
-// >> EXTERNALS
-// ============================================================================
-extern std::map<CHook *, std::map<HookType_t, std::list<object> > > g_mapCallbacks;
-
-
 // ============================================================================
 // >> GLOBAL VARIABLES
 // ============================================================================
@@ -121,6 +115,8 @@ CFunction::CFunction(unsigned long ulAddr, object oCallingConvention, object oAr
 {
 	// Step 1: Validate and convert the argument types
 	m_tArgs = tuple(oArgs);
+	m_vecArgTypes = ObjectToDataTypeVector(m_tArgs);
+	m_pCallVM = NULL;
 
 	// Step 2: Determine the return type/converter
 	try
@@ -145,7 +141,7 @@ CFunction::CFunction(unsigned long ulAddr, object oCallingConvention, object oAr
 	{
 		// If this line succeeds the user wants to create a function with the built-in calling conventions
 		m_eCallingConvention = extract<Convention_t>(oCallingConvention);
-		m_pCallingConvention = MakeDynamicHooksConvention(m_eCallingConvention, ObjectToDataTypeVector(m_tArgs), m_eReturnType);
+		m_pCallingConvention = MakeDynamicHooksConvention(m_eCallingConvention, m_vecArgTypes, m_eReturnType);
 		m_oCallingConvention = object();
 	}
 	catch( ... )
@@ -172,6 +168,8 @@ CFunction::CFunction(unsigned long ulAddr, Convention_t eCallingConvention,
 	m_oCallingConvention = object();
 
 	m_tArgs = tArgs;
+	m_vecArgTypes = ObjectToDataTypeVector(m_tArgs);
+	m_pCallVM = NULL;
 	m_eReturnType = eReturnType;
 	m_oConverter = oConverter;
 }
@@ -180,6 +178,8 @@ CFunction::CFunction(const CFunction& obj)
 	:CPointer(obj)
 {
 	m_tArgs = obj.m_tArgs;
+	m_vecArgTypes = obj.m_vecArgTypes;
+	m_pCallVM = NULL;
 	m_eReturnType = obj.m_eReturnType;
 	m_oConverter = obj.m_oConverter;
 
@@ -188,7 +188,7 @@ CFunction::CFunction(const CFunction& obj)
 
 	if (m_eCallingConvention != CONV_CUSTOM)
 	{
-		m_pCallingConvention = MakeDynamicHooksConvention(m_eCallingConvention, ObjectToDataTypeVector(m_tArgs), m_eReturnType);
+		m_pCallingConvention = MakeDynamicHooksConvention(m_eCallingConvention, m_vecArgTypes, m_eReturnType);
 		m_oCallingConvention = object();
 	}
 	else
@@ -200,6 +200,12 @@ CFunction::CFunction(const CFunction& obj)
 
 CFunction::~CFunction()
 {
+	if (m_pCallVM)
+	{
+		dcFree(m_pCallVM);
+		m_pCallVM = NULL;
+	}
+
 	if (!m_pCallingConvention)
 		return;
 
@@ -229,12 +235,12 @@ bool CFunction::IsHookable()
 
 bool CFunction::IsHooked()
 {
-	return GetHookManager()->FindHook((void *) m_ulAddr) != NULL;
+	return FindHook((void *) m_ulAddr) != NULL;
 }
 
 CFunction* CFunction::GetTrampoline()
 {
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+	CHook* pHook = FindHook((void *) m_ulAddr);
 	if (!pHook)
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function was not hooked.")
 
@@ -259,86 +265,130 @@ void CallHelperVoid(DCCallVM* vm, unsigned long addr)
 	EXCEPT_SEGV()
 }
 
-object CFunction::Call(PyObject *args, PyObject *kw)
+void CFunction::PushArguments(DCCallVM* pVM, PyObject** ppArgs)
 {
-	if (!IsCallable())
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function is not callable.")
-
-	Validate();
-	if (PyTuple_GET_SIZE(args) - 1 != len(m_tArgs))
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Number of passed arguments is not equal to the required number.")
-
-	// Reset VM and set the calling convention
-	dcReset(g_pCallVM);
-	dcMode(g_pCallVM, m_iCallingConvention);
-
-	// Loop through all passed arguments and add them to the VM
-	for(int i=1; i < PyTuple_GET_SIZE(args); i++)
+	for(unsigned int i=0; i < m_vecArgTypes.size(); i++)
 	{
-		PyObject *arg = PyTuple_GET_ITEM(args, i);
-		switch(extract<DataType_t>(m_tArgs[i - 1]))
+		PyObject *arg = ppArgs[i];
+		switch(m_vecArgTypes[i])
 		{
-			case DATA_TYPE_BOOL:		dcArgBool(g_pCallVM, extract<bool>(arg)); break;
-			case DATA_TYPE_CHAR:		dcArgChar(g_pCallVM, extract<char>(arg)); break;
-			case DATA_TYPE_UCHAR:		dcArgChar(g_pCallVM, extract<unsigned char>(arg)); break;
-			case DATA_TYPE_SHORT:		dcArgShort(g_pCallVM, extract<short>(arg)); break;
-			case DATA_TYPE_USHORT:		dcArgShort(g_pCallVM, extract<unsigned short>(arg)); break;
-			case DATA_TYPE_INT:			dcArgInt(g_pCallVM, extract<int>(arg)); break;
-			case DATA_TYPE_UINT:		dcArgInt(g_pCallVM, extract<unsigned int>(arg)); break;
-			case DATA_TYPE_LONG:		dcArgLong(g_pCallVM, extract<long>(arg)); break;
-			case DATA_TYPE_ULONG:		dcArgLong(g_pCallVM, extract<unsigned long>(arg)); break;
-			case DATA_TYPE_LONG_LONG:	dcArgLongLong(g_pCallVM, extract<long long>(arg)); break;
-			case DATA_TYPE_ULONG_LONG:	dcArgLongLong(g_pCallVM, extract<unsigned long long>(arg)); break;
-			case DATA_TYPE_FLOAT:		dcArgFloat(g_pCallVM, extract<float>(arg)); break;
-			case DATA_TYPE_DOUBLE:		dcArgDouble(g_pCallVM, extract<double>(arg)); break;
+			case DATA_TYPE_BOOL:		dcArgBool(pVM, extract<bool>(arg)); break;
+			case DATA_TYPE_CHAR:		dcArgChar(pVM, extract<char>(arg)); break;
+			case DATA_TYPE_UCHAR:		dcArgChar(pVM, extract<unsigned char>(arg)); break;
+			case DATA_TYPE_SHORT:		dcArgShort(pVM, extract<short>(arg)); break;
+			case DATA_TYPE_USHORT:		dcArgShort(pVM, extract<unsigned short>(arg)); break;
+			case DATA_TYPE_INT:			dcArgInt(pVM, extract<int>(arg)); break;
+			case DATA_TYPE_UINT:		dcArgInt(pVM, extract<unsigned int>(arg)); break;
+			case DATA_TYPE_LONG:		dcArgLong(pVM, extract<long>(arg)); break;
+			case DATA_TYPE_ULONG:		dcArgLong(pVM, extract<unsigned long>(arg)); break;
+			case DATA_TYPE_LONG_LONG:	dcArgLongLong(pVM, extract<long long>(arg)); break;
+			case DATA_TYPE_ULONG_LONG:	dcArgLongLong(pVM, extract<unsigned long long>(arg)); break;
+			case DATA_TYPE_FLOAT:		dcArgFloat(pVM, extract<float>(arg)); break;
+			case DATA_TYPE_DOUBLE:		dcArgDouble(pVM, extract<double>(arg)); break;
 			case DATA_TYPE_POINTER:
 			{
 				unsigned long ulAddr = 0;
 				if (arg != Py_None)
 					ulAddr = ExtractAddress(object(handle<>(borrowed(arg))));
 
-				dcArgPointer(g_pCallVM, ulAddr);
+				dcArgPointer(pVM, ulAddr);
 				break;
 			}
-			case DATA_TYPE_STRING:		dcArgPointer(g_pCallVM, (unsigned long) (void *) extract<char *>(arg)); break;
+			case DATA_TYPE_STRING:		dcArgPointer(pVM, (unsigned long) (void *) extract<char *>(arg)); break;
 			default:					BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Unknown argument type.")
 		}
 	}
+}
 
-	// Call the function
+object CFunction::Invoke(DCCallVM* pVM)
+{
 	switch(m_eReturnType)
 	{
-		case DATA_TYPE_VOID:		CallHelperVoid(g_pCallVM, m_ulAddr); break;
-		case DATA_TYPE_BOOL:		return object(CallHelper<bool>(dcCallBool, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_CHAR:		return object(CallHelper<char>(dcCallChar, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_UCHAR:		return object(CallHelper<unsigned char>(dcCallChar, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_SHORT:		return object(CallHelper<short>(dcCallShort, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_USHORT:		return object(CallHelper<unsigned short>(dcCallShort, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_INT:			return object(CallHelper<int>(dcCallInt, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_UINT:		return object(CallHelper<unsigned int>(dcCallInt, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_LONG:		return object(CallHelper<long>(dcCallLong, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_ULONG:		return object(CallHelper<unsigned long>(dcCallLong, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_LONG_LONG:	return object(CallHelper<long long>(dcCallLongLong, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_ULONG_LONG:	return object(CallHelper<unsigned long long>(dcCallLongLong, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_FLOAT:		return object(CallHelper<float>(dcCallFloat, g_pCallVM, m_ulAddr));
-		case DATA_TYPE_DOUBLE:		return object(CallHelper<double>(dcCallDouble, g_pCallVM, m_ulAddr));
+		case DATA_TYPE_VOID:		CallHelperVoid(pVM, m_ulAddr); break;
+		case DATA_TYPE_BOOL:		return object(CallHelper<bool>(dcCallBool, pVM, m_ulAddr));
+		case DATA_TYPE_CHAR:		return object(CallHelper<char>(dcCallChar, pVM, m_ulAddr));
+		case DATA_TYPE_UCHAR:		return object(CallHelper<unsigned char>(dcCallChar, pVM, m_ulAddr));
+		case DATA_TYPE_SHORT:		return object(CallHelper<short>(dcCallShort, pVM, m_ulAddr));
+		case DATA_TYPE_USHORT:		return object(CallHelper<unsigned short>(dcCallShort, pVM, m_ulAddr));
+		case DATA_TYPE_INT:			return object(CallHelper<int>(dcCallInt, pVM, m_ulAddr));
+		case DATA_TYPE_UINT:		return object(CallHelper<unsigned int>(dcCallInt, pVM, m_ulAddr));
+		case DATA_TYPE_LONG:		return object(CallHelper<long>(dcCallLong, pVM, m_ulAddr));
+		case DATA_TYPE_ULONG:		return object(CallHelper<unsigned long>(dcCallLong, pVM, m_ulAddr));
+		case DATA_TYPE_LONG_LONG:	return object(CallHelper<long long>(dcCallLongLong, pVM, m_ulAddr));
+		case DATA_TYPE_ULONG_LONG:	return object(CallHelper<unsigned long long>(dcCallLongLong, pVM, m_ulAddr));
+		case DATA_TYPE_FLOAT:		return object(CallHelper<float>(dcCallFloat, pVM, m_ulAddr));
+		case DATA_TYPE_DOUBLE:		return object(CallHelper<double>(dcCallDouble, pVM, m_ulAddr));
 		case DATA_TYPE_POINTER:
 		{
-			CPointer pPtr = CPointer(CallHelper<unsigned long>(dcCallPointer, g_pCallVM, m_ulAddr));
+			CPointer pPtr = CPointer(CallHelper<unsigned long>(dcCallPointer, pVM, m_ulAddr));
 			if (!m_oConverter.is_none())
 				return m_oConverter(pPtr);
 
 			return object(pPtr);
 		}
-		case DATA_TYPE_STRING:		return object(CallHelper<const char *>(dcCallPointer, g_pCallVM, m_ulAddr));
+		case DATA_TYPE_STRING:		return object(CallHelper<const char *>(dcCallPointer, pVM, m_ulAddr));
 		default:					BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown return type.")
 	}
 	return object();
 }
 
+object CFunction::Call(PyObject *args, PyObject *kw)
+{
+	if (!IsCallable())
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function is not callable.")
+
+	Validate();
+	if (PyTuple_GET_SIZE(args) - 1 != (Py_ssize_t) m_vecArgTypes.size())
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Number of passed arguments is not equal to the required number.")
+
+	// Reset VM and set the calling convention
+	dcReset(g_pCallVM);
+	dcMode(g_pCallVM, m_iCallingConvention);
+
+	// Skip the first item, it's the function itself
+	PushArguments(g_pCallVM, &PyTuple_GET_ITEM(args, 1));
+	return Invoke(g_pCallVM);
+}
+
+list CFunction::CallMany(object oArgs)
+{
+	if (!IsCallable())
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function is not callable.")
+
+	Validate();
+
+	// The calling convention never changes, so prepare the VM only once
+	if (!m_pCallVM)
+	{
+		m_pCallVM = dcNewCallVM(4096);
+		dcMode(m_pCallVM, m_iCallingConvention);
+	}
+
+	list results;
+	object iterator = object(handle<>(PyObject_GetIter(oArgs.ptr())));
+	PyObject* pItem;
+	while ((pItem = PyIter_Next(iterator.ptr())) != NULL)
+	{
+		object item = object(handle<>(pItem));
+		object args = object(handle<>(PySequence_Fast(item.ptr(), "Arguments must be a sequence.")));
+
+		if (PySequence_Fast_GET_SIZE(args.ptr()) != (Py_ssize_t) m_vecArgTypes.size())
+			BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Number of passed arguments is not equal to the required number.")
+
+		dcReset(m_pCallVM);
+		PushArguments(m_pCallVM, PySequence_Fast_ITEMS(args.ptr()));
+		results.append(Invoke(m_pCallVM));
+	}
+
+	if (PyErr_Occurred())
+		throw_error_already_set();
+
+	return results;
+}
+
 object CFunction::CallTrampoline(PyObject *args, PyObject *kw)
 {
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+	CHook* pHook = FindHook((void *) m_ulAddr);
 	if (!pHook)
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function was not hooked.")
 
@@ -348,7 +398,7 @@ object CFunction::CallTrampoline(PyObject *args, PyObject *kw)
 
 object CFunction::SkipHooks(PyObject *args, PyObject *kw)
 {
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+	CHook* pHook = FindHook((void *) m_ulAddr);
 	if (pHook)
 		return CFunction((unsigned long) pHook->m_pTrampoline, m_eCallingConvention,
 			m_iCallingConvention, m_tArgs, m_eReturnType, m_oConverter).Call(args, kw);
@@ -360,18 +410,26 @@ CHook* HookFunctionHelper(void* addr, ICallingConvention* pConv)
 {
 	CHook* result;
 	TRY_SEGV()
-		result = GetHookManager()->HookFunction(addr, pConv);
+		result = HookFunction(addr, pConv);
 	EXCEPT_SEGV()
 	return result;
 }
 
-void CFunction::AddHook(HookType_t eType, PyObject* pCallable)
+void CFunction::AddHook(HookType_t eType, PyObject* pCallable, object oFilter)
 {
 	if (!IsHookable())
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function is not hookable.")
 
 	Validate();
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+
+	if (!oFilter.is_none())
+	{
+		extract<IHookFilter*> extractFilter(oFilter);
+		if (extractFilter.check() && extractFilter()->RequiresThisPointer() && m_eCallingConvention != CONV_THISCALL)
+			BOOST_RAISE_EXCEPTION(PyExc_ValueError, "The filter can only be attached to thiscall functions.")
+	}
+
+	CHook* pHook = FindHook((void *) m_ulAddr);
 
 	// Prepare arguments for log message
 	str type = str(eType);
@@ -411,7 +469,7 @@ void CFunction::AddHook(HookType_t eType, PyObject* pCallable)
 
 	// Add the hook handler. If it's already added, it won't be added twice
 	pHook->AddCallback(eType, (HookHandlerFn *) (void *) &SP_HookHandler);
-	g_mapCallbacks[pHook][eType].push_back(object(handle<>(borrowed(pCallable))));
+	GetHookDispatcher(pHook)->AddCallback(eType, oCallback, oFilter);
 }
 
 bool CFunction::AddHook(HookType_t eType, HookHandlerFn* pFunc)
@@ -419,10 +477,10 @@ bool CFunction::AddHook(HookType_t eType, HookHandlerFn* pFunc)
 	if (!IsHookable())
 		return false;
 
-	CHook* pHook = GetHookManager()->FindHook((void*) m_ulAddr);
+	CHook* pHook = FindHook((void*) m_ulAddr);
 
 	if (!pHook) {
-		pHook = GetHookManager()->HookFunction((void*) m_ulAddr, m_pCallingConvention);
+		pHook = HookFunction((void*) m_ulAddr, m_pCallingConvention);
 
 		if (!pHook)
 			return false;
@@ -439,21 +497,23 @@ bool CFunction::AddHook(HookType_t eType, HookHandlerFn* pFunc)
 void CFunction::RemoveHook(HookType_t eType, PyObject* pCallable)
 {
 	Validate();
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+	CHook* pHook = FindHook((void *) m_ulAddr);
 	if (!pHook)
 		return;
 
-	g_mapCallbacks[pHook][eType].remove(object(handle<>(borrowed(pCallable))));
+	CHookDispatcher* pDispatcher = FindHookDispatcher(pHook);
+	if (!pDispatcher)
+		return;
+
+	pDispatcher->RemoveCallback(eType, object(handle<>(borrowed(pCallable))));
 }
 
 void CFunction::DeleteHook()
 {
-	CHook* pHook = GetHookManager()->FindHook((void *) m_ulAddr);
+	CHook* pHook = FindHook((void *) m_ulAddr);
 	if (!pHook)
 		return;
 
-	g_mapCallbacks.erase(pHook);
-
 	ICallingConventionWrapper *pConv = dynamic_cast<ICallingConventionWrapper *>(pHook->m_pCallingConvention);
 	if (pConv)
 	{
@@ -482,5 +542,5 @@ void CFunction::DeleteHook()
 
 	// Set the calling convention to NULL, because DynamicHooks will delete it otherwise.
 	pHook->m_pCallingConvention = NULL;
-	GetHookManager()->UnhookFunction((void *) m_ulAddr);
+	UnhookFunction((void *) m_ulAddr);
 }
\ No newline at end of file
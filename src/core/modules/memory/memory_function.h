@@ -36,6 +36,9 @@
 // DynamicHooks
 #include "manager.h"
 
+// DynCall
+#include "dyncall.h"
+
 
 // ============================================================================
 // >> Convention_t
@@ -62,6 +65,9 @@ public:
 
 	CFunction(const CFunction& obj);
 
+	// Copies never share m_pCallVM, so assignment would free it twice
+	CFunction& operator=(const CFunction& obj) = delete;
+
 	~CFunction();
 
 	bool IsCallable();
@@ -75,7 +81,9 @@ public:
 	object CallTrampoline(PyObject *args, PyObject *kw);
 	object SkipHooks(PyObject *args, PyObject *kw);
 
-	void AddHook(HookType_t eType, PyObject* pCallable);
+	list CallMany(object oArgs);
+
+	void AddHook(HookType_t eType, PyObject* pCallable, object oFilter=object());
 	void RemoveHook(HookType_t eType, PyObject* pCallable);
 
 	void AddPreHook(PyObject* pCallable)
@@ -94,9 +102,20 @@ public:
 
 	bool AddHook(HookType_t eType, HookHandlerFn* pFunc);
 
+protected:
+	void PushArguments(DCCallVM* pVM, PyObject** ppArgs);
+	object Invoke(DCCallVM* pVM);
+
 public:
 	boost::python::tuple	m_tArgs;
 	object					m_oConverter;
+
+	// Argument types of m_tArgs, resolved once
+	std::vector<DataType_t>	m_vecArgTypes;
+
+	// Prepared DynCall VM that is used for batch calls
+	DCCallVM*				m_pCallVM;
+
 	DataType_t				m_eReturnType;
 
 	// Shared built-in calling convention identifier
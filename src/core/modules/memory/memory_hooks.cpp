@@ -33,6 +33,9 @@
 #include "utilities/wrap_macros.h"
 #include "utilities/sp_util.h"
 
+// DynamicHooks
+#include "manager.h"
+
 #include "boost/python.hpp"
 using namespace boost::python;
 
@@ -40,8 +43,8 @@ using namespace boost::python;
 // ============================================================================
 // >> GLOBAL VARIABLES
 // ============================================================================
-// g_mapCallbacks[<CHook *>][<HookType_t>] -> [<object>, <object>, ...]
-std::map<CHook *, std::map<HookType_t, std::list<object> > > g_mapCallbacks;
+// g_HookIndex[<function address>] -> {<CHook *>, <CHookDispatcher *>}
+HookIndex_t g_HookIndex;
 
 bool g_HooksDisabled;
 
@@ -56,12 +59,31 @@ void SetReturnValue(CHook* pHook, object value)
 	pHook->SetReturnValue<T>(val);
 }
 
+void SetPointerReturnValue(CHook* pHook, object value)
+{
+	pHook->SetReturnValue<unsigned long>(ExtractAddress(value));
+}
+
+void SetVoidReturnValue(CHook* pHook, object value)
+{
+}
+
 template<class T>
 object GetReturnValue(CHook* pHook)
 {
 	return object(pHook->GetReturnValue<T>());
 }
 
+object GetPointerReturnValue(CHook* pHook)
+{
+	return object(CPointer(pHook->GetReturnValue<unsigned long>()));
+}
+
+object GetVoidReturnValue(CHook* pHook)
+{
+	return object();
+}
+
 template<class T>
 void SetArgument(CHook* pHook, int iIndex, object value)
 {
@@ -69,12 +91,80 @@ void SetArgument(CHook* pHook, int iIndex, object value)
 	pHook->SetArgument<T>(iIndex, val);
 }
 
+void SetPointerArgument(CHook* pHook, int iIndex, object value)
+{
+	pHook->SetArgument<unsigned long>(iIndex, ExtractAddress(value));
+}
+
+void SetUnknownArgument(CHook* pHook, int iIndex, object value)
+{
+	BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.")
+}
+
 template<class T>
 object GetArgument(CHook* pHook, int iIndex)
 {
 	return object(pHook->GetArgument<T>(iIndex));
 }
 
+object GetPointerArgument(CHook* pHook, int iIndex)
+{
+	return object(CPointer(pHook->GetArgument<unsigned long>(iIndex)));
+}
+
+object GetUnknownArgument(CHook* pHook, int iIndex)
+{
+	BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.")
+	return object();
+}
+
+void GetArgumentAccessors(DataType_t eType, ArgumentGetterFn& pGetter, ArgumentSetterFn& pSetter)
+{
+	switch(eType)
+	{
+		case DATA_TYPE_BOOL:		pGetter = &GetArgument<bool>; pSetter = &SetArgument<bool>; break;
+		case DATA_TYPE_CHAR:		pGetter = &GetArgument<char>; pSetter = &SetArgument<char>; break;
+		case DATA_TYPE_UCHAR:		pGetter = &GetArgument<unsigned char>; pSetter = &SetArgument<unsigned char>; break;
+		case DATA_TYPE_SHORT:		pGetter = &GetArgument<short>; pSetter = &SetArgument<short>; break;
+		case DATA_TYPE_USHORT:		pGetter = &GetArgument<unsigned short>; pSetter = &SetArgument<unsigned short>; break;
+		case DATA_TYPE_INT:			pGetter = &GetArgument<int>; pSetter = &SetArgument<int>; break;
+		case DATA_TYPE_UINT:		pGetter = &GetArgument<unsigned int>; pSetter = &SetArgument<unsigned int>; break;
+		case DATA_TYPE_LONG:		pGetter = &GetArgument<long>; pSetter = &SetArgument<long>; break;
+		case DATA_TYPE_ULONG:		pGetter = &GetArgument<unsigned long>; pSetter = &SetArgument<unsigned long>; break;
+		case DATA_TYPE_LONG_LONG:	pGetter = &GetArgument<long long>; pSetter = &SetArgument<long long>; break;
+		case DATA_TYPE_ULONG_LONG:	pGetter = &GetArgument<unsigned long long>; pSetter = &SetArgument<unsigned long long>; break;
+		case DATA_TYPE_FLOAT:		pGetter = &GetArgument<float>; pSetter = &SetArgument<float>; break;
+		case DATA_TYPE_DOUBLE:		pGetter = &GetArgument<double>; pSetter = &SetArgument<double>; break;
+		case DATA_TYPE_POINTER:		pGetter = &GetPointerArgument; pSetter = &SetPointerArgument; break;
+		case DATA_TYPE_STRING:		pGetter = &GetArgument<const char *>; pSetter = &SetArgument<const char *>; break;
+		default:					pGetter = &GetUnknownArgument; pSetter = &SetUnknownArgument; break;
+	}
+}
+
+void GetReturnValueAccessors(DataType_t eType, ReturnValueGetterFn& pGetter, ReturnValueSetterFn& pSetter)
+{
+	switch(eType)
+	{
+		case DATA_TYPE_VOID:		pGetter = &GetVoidReturnValue; pSetter = &SetVoidReturnValue; break;
+		case DATA_TYPE_BOOL:		pGetter = &GetReturnValue<bool>; pSetter = &SetReturnValue<bool>; break;
+		case DATA_TYPE_CHAR:		pGetter = &GetReturnValue<char>; pSetter = &SetReturnValue<char>; break;
+		case DATA_TYPE_UCHAR:		pGetter = &GetReturnValue<unsigned char>; pSetter = &SetReturnValue<unsigned char>; break;
+		case DATA_TYPE_SHORT:		pGetter = &GetReturnValue<short>; pSetter = &SetReturnValue<short>; break;
+		case DATA_TYPE_USHORT:		pGetter = &GetReturnValue<unsigned short>; pSetter = &SetReturnValue<unsigned short>; break;
+		case DATA_TYPE_INT:			pGetter = &GetReturnValue<int>; pSetter = &SetReturnValue<int>; break;
+		case DATA_TYPE_UINT:		pGetter = &GetReturnValue<unsigned int>; pSetter = &SetReturnValue<unsigned int>; break;
+		case DATA_TYPE_LONG:		pGetter = &GetReturnValue<long>; pSetter = &SetReturnValue<long>; break;
+		case DATA_TYPE_ULONG:		pGetter = &GetReturnValue<unsigned long>; pSetter = &SetReturnValue<unsigned long>; break;
+		case DATA_TYPE_LONG_LONG:	pGetter = &GetReturnValue<long long>; pSetter = &SetReturnValue<long long>; break;
+		case DATA_TYPE_ULONG_LONG:	pGetter = &GetReturnValue<unsigned long long>; pSetter = &SetReturnValue<unsigned long long>; break;
+		case DATA_TYPE_FLOAT:		pGetter = &GetReturnValue<float>; pSetter = &SetReturnValue<float>; break;
+		case DATA_TYPE_DOUBLE:		pGetter = &GetReturnValue<double>; pSetter = &SetReturnValue<double>; break;
+		case DATA_TYPE_POINTER:		pGetter = &GetPointerReturnValue; pSetter = &SetPointerReturnValue; break;
+		case DATA_TYPE_STRING:		pGetter = &GetReturnValue<const char *>; pSetter = &SetReturnValue<const char *>; break;
+		default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.")
+	}
+}
+
 
 // ============================================================================
 // >> SP_HookHandler
@@ -84,74 +174,56 @@ bool SP_HookHandler(HookType_t eHookType, CHook* pHook)
 	if (g_HooksDisabled)
 		return false;
 
-	std::list<object> callbacks = g_mapCallbacks[pHook][eHookType];
+	CHookDispatcher* pDispatcher = FindHookDispatcher(pHook);
+	if (!pDispatcher)
+		return false;
+
+	// Keep a reference to the current callbacks, so they stay alive even if
+	// a callback adds or removes hooks while we are iterating over them
+	CallbackSnapshot_t callbacks = pDispatcher->GetCallbacks(eHookType);
 
 	// No need to do all this stuff, if there is no callback registered
-	if (callbacks.empty())
+	if (!callbacks || callbacks->empty())
 		return false;
 
+	// The dispatcher might be deleted by a callback, so grab what we need now
+	ReturnValueSetterFn pReturnValueSetter = pDispatcher->m_pReturnValueSetter;
+
+	ReturnValueGetterFn pReturnValueGetter = pDispatcher->m_pReturnValueGetter;
+
+	// The stack data and return value are only created once a callback passed
+	// its filter. All callbacks share the same Python owned stack data and its
+	// argument cache, so callbacks can keep a reference to it.
+	object stackdata;
 	object retval;
-	if (eHookType == HOOKTYPE_POST)
+
+	bool bOverride = false;
+	for (CallbackList_t::const_iterator it=callbacks->begin(); it != callbacks->end(); ++it)
 	{
-		switch(pHook->m_pCallingConvention->m_returnType)
+		if (it->m_pFilter && !it->m_pFilter->ShouldCall(pHook))
+			continue;
+
+		if (stackdata.is_none())
 		{
-			case DATA_TYPE_VOID:		retval = object(); break;
-			case DATA_TYPE_BOOL:		retval = GetReturnValue<bool>(pHook); break;
-			case DATA_TYPE_CHAR:		retval = GetReturnValue<char>(pHook); break;
-			case DATA_TYPE_UCHAR:		retval = GetReturnValue<unsigned char>(pHook); break;
-			case DATA_TYPE_SHORT:		retval = GetReturnValue<short>(pHook); break;
-			case DATA_TYPE_USHORT:		retval = GetReturnValue<unsigned short>(pHook); break;
-			case DATA_TYPE_INT:			retval = GetReturnValue<int>(pHook); break;
-			case DATA_TYPE_UINT:		retval = GetReturnValue<unsigned int>(pHook); break;
-			case DATA_TYPE_LONG:		retval = GetReturnValue<long>(pHook); break;
-			case DATA_TYPE_ULONG:		retval = GetReturnValue<unsigned long>(pHook); break;
-			case DATA_TYPE_LONG_LONG:	retval = GetReturnValue<long long>(pHook); break;
-			case DATA_TYPE_ULONG_LONG:	retval = GetReturnValue<unsigned long long>(pHook); break;
-			case DATA_TYPE_FLOAT:		retval = GetReturnValue<float>(pHook); break;
-			case DATA_TYPE_DOUBLE:		retval = GetReturnValue<double>(pHook); break;
-			case DATA_TYPE_POINTER:		retval = object(CPointer(pHook->GetReturnValue<unsigned long>())); break;
-			case DATA_TYPE_STRING:		retval = GetReturnValue<const char *>(pHook); break;
-			default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.");
+			BEGIN_BOOST_PY()
+				if (eHookType == HOOKTYPE_POST)
+					retval = pReturnValueGetter(pHook);
+
+				stackdata = object(CStackData(pDispatcher));
+			END_BOOST_PY(false)
 		}
-	}
-	
-	CStackData stackdata = CStackData(pHook);
-	bool bOverride = false;
-	for (std::list<object>::iterator it=callbacks.begin(); it != callbacks.end(); ++it)
-	{
+
 		BEGIN_BOOST_PY()
 			object pyretval;
 			if (eHookType == HOOKTYPE_PRE)
-				pyretval = (*it)(stackdata);
+				pyretval = it->m_oCallback(stackdata);
 			else
-				pyretval = (*it)(stackdata, retval);
+				pyretval = it->m_oCallback(stackdata, retval);
 
 			if (!pyretval.is_none())
 			{
 				bOverride = true;
-				switch(pHook->m_pCallingConvention->m_returnType)
-				{
-					case DATA_TYPE_VOID:		break;
-					case DATA_TYPE_BOOL:		SetReturnValue<bool>(pHook, pyretval); break;
-					case DATA_TYPE_CHAR:		SetReturnValue<char>(pHook, pyretval); break;
-					case DATA_TYPE_UCHAR:		SetReturnValue<unsigned >(pHook, pyretval); break;
-					case DATA_TYPE_SHORT:		SetReturnValue<short>(pHook, pyretval); break;
-					case DATA_TYPE_USHORT:		SetReturnValue<unsigned short>(pHook, pyretval); break;
-					case DATA_TYPE_INT:			SetReturnValue<int>(pHook, pyretval); break;
-					case DATA_TYPE_UINT:		SetReturnValue<unsigned int>(pHook, pyretval); break;
-					case DATA_TYPE_LONG:		SetReturnValue<long>(pHook, pyretval); break;
-					case DATA_TYPE_ULONG:		SetReturnValue<unsigned long>(pHook, pyretval); break;
-					case DATA_TYPE_LONG_LONG:	SetReturnValue<long long>(pHook, pyretval); break;
-					case DATA_TYPE_ULONG_LONG:	SetReturnValue<unsigned long long>(pHook, pyretval); break;
-					case DATA_TYPE_FLOAT:		SetReturnValue<float>(pHook, pyretval); break;
-					case DATA_TYPE_DOUBLE:		SetReturnValue<double>(pHook, pyretval); break;
-					case DATA_TYPE_POINTER:
-					{
-						pHook->SetReturnValue<unsigned long>(ExtractAddress(pyretval));
-					} break;
-					case DATA_TYPE_STRING:		SetReturnValue<const char*>(pHook, pyretval); break;
-					default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.")
-				}
+				pReturnValueSetter(pHook, pyretval);
 			}
 		END_BOOST_PY_NORET()
 	}
@@ -159,75 +231,225 @@ bool SP_HookHandler(HookType_t eHookType, CHook* pHook)
 }
 
 
+// ============================================================================
+// >> CHookDispatcher
+// ============================================================================
+CHookDispatcher::CHookDispatcher(CHook* pHook)
+{
+	m_pHook = pHook;
+
+	ICallingConvention* pConv = pHook->m_pCallingConvention;
+	GetReturnValueAccessors(pConv->m_returnType, m_pReturnValueGetter, m_pReturnValueSetter);
+
+	unsigned int iArgCount = (unsigned int) pConv->m_vecArgTypes.size();
+	ArgumentAccessors_t* pArguments = new ArgumentAccessors_t;
+	pArguments->m_vecGetters.resize(iArgCount);
+	pArguments->m_vecSetters.resize(iArgCount);
+	pArguments->m_vecCacheable.resize(iArgCount);
+
+	for (unsigned int i=0; i < iArgCount; i++)
+	{
+		DataType_t eType = pConv->m_vecArgTypes[i];
+		GetArgumentAccessors(eType, pArguments->m_vecGetters[i], pArguments->m_vecSetters[i]);
+
+		// Pointers are mutable (e.g. ptr += 4), so they can't be shared between reads
+		pArguments->m_vecCacheable[i] = i < MAX_CACHED_ARGUMENTS && eType != DATA_TYPE_POINTER;
+	}
+
+	m_pArguments.reset(pArguments);
+}
+
+void CHookDispatcher::AddCallback(HookType_t eHookType, object oCallback, object oFilter)
+{
+	HookCallback_t callback;
+	callback.m_oCallback = oCallback;
+	callback.m_oFilter = oFilter;
+	callback.m_pFilter = NULL;
+
+	if (!oFilter.is_none())
+	{
+		extract<IHookFilter*> extractFilter(oFilter);
+		if (!extractFilter.check())
+			BOOST_RAISE_EXCEPTION(PyExc_TypeError, "The filter must be a HookFilter instance.")
+
+		callback.m_pFilter = extractFilter();
+	}
+
+	CallbackList_t* pCallbacks = m_pCallbacks[eHookType] ?
+		new CallbackList_t(*m_pCallbacks[eHookType]) : new CallbackList_t();
+
+	pCallbacks->push_back(callback);
+	m_pCallbacks[eHookType] = CallbackSnapshot_t(pCallbacks);
+}
+
+void CHookDispatcher::RemoveCallback(HookType_t eHookType, object oCallback)
+{
+	if (!m_pCallbacks[eHookType])
+		return;
+
+	CallbackList_t* pCallbacks = new CallbackList_t();
+	pCallbacks->reserve(m_pCallbacks[eHookType]->size());
+
+	for (CallbackList_t::const_iterator it=m_pCallbacks[eHookType]->begin(); it != m_pCallbacks[eHookType]->end(); ++it)
+	{
+		if (it->m_oCallback != oCallback)
+			pCallbacks->push_back(*it);
+	}
+
+	m_pCallbacks[eHookType] = CallbackSnapshot_t(pCallbacks);
+}
+
+
+// ============================================================================
+// >> Hook index
+// ============================================================================
+CHookDispatcher* FindHookDispatcher(CHook* pHook)
+{
+	HookIndex_t::const_iterator it = g_HookIndex.find(pHook->m_pFunc);
+	if (it == g_HookIndex.end())
+		return NULL;
+
+	return it->second.m_pDispatcher;
+}
+
+CHookDispatcher* GetHookDispatcher(CHook* pHook)
+{
+	HookIndex_t::iterator it = g_HookIndex.find(pHook->m_pFunc);
+	if (it == g_HookIndex.end())
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Function was not hooked.")
+
+	if (!it->second.m_pDispatcher)
+		it->second.m_pDispatcher = new CHookDispatcher(pHook);
+
+	return it->second.m_pDispatcher;
+}
+
+CHook* FindHook(void* pFunc)
+{
+	HookIndex_t::const_iterator it = g_HookIndex.find(pFunc);
+	if (it == g_HookIndex.end())
+		return NULL;
+
+	return it->second.m_pHook;
+}
+
+CHook* HookFunction(void* pFunc, ICallingConvention* pConvention)
+{
+	CHook* pHook = GetHookManager()->HookFunction(pFunc, pConvention);
+	if (!pHook)
+		return NULL;
+
+	HookEntry_t& entry = g_HookIndex[pFunc];
+	if (entry.m_pHook != pHook)
+	{
+		entry.m_pHook = pHook;
+		entry.m_pDispatcher = NULL;
+	}
+
+	return pHook;
+}
+
+void UnhookFunction(void* pFunc)
+{
+	HookIndex_t::iterator it = g_HookIndex.find(pFunc);
+	if (it != g_HookIndex.end())
+	{
+		delete it->second.m_pDispatcher;
+		g_HookIndex.erase(it);
+	}
+
+	GetHookManager()->UnhookFunction(pFunc);
+}
+
+void UnhookAllFunctions()
+{
+	for (HookIndex_t::iterator it=g_HookIndex.begin(); it != g_HookIndex.end(); ++it)
+		delete it->second.m_pDispatcher;
+
+	g_HookIndex.clear();
+	GetHookManager()->UnhookAllFunctions();
+}
+
+
 // ============================================================================
 // >> CStackData
 // ============================================================================
 CStackData::CStackData(CHook* pHook)
 {
 	m_pHook = pHook;
+	m_pArguments = GetHookDispatcher(pHook)->m_pArguments;
+	memset(m_pCache, 0, sizeof(m_pCache));
+}
+
+CStackData::CStackData(CHookDispatcher* pDispatcher)
+{
+	m_pHook = pDispatcher->m_pHook;
+	m_pArguments = pDispatcher->m_pArguments;
+	memset(m_pCache, 0, sizeof(m_pCache));
+}
+
+CStackData::CStackData(const CStackData& obj)
+{
+	m_pHook = obj.m_pHook;
+	m_pArguments = obj.m_pArguments;
+	for (int i=0; i < MAX_CACHED_ARGUMENTS; i++)
+	{
+		m_pCache[i] = obj.m_pCache[i];
+		Py_XINCREF(m_pCache[i]);
+	}
+}
+
+CStackData::~CStackData()
+{
+	ClearCache();
+}
+
+CStackData& CStackData::operator=(const CStackData& obj)
+{
+	if (this == &obj)
+		return *this;
+
+	ClearCache();
+	m_pHook = obj.m_pHook;
+	m_pArguments = obj.m_pArguments;
+	for (int i=0; i < MAX_CACHED_ARGUMENTS; i++)
+	{
+		m_pCache[i] = obj.m_pCache[i];
+		Py_XINCREF(m_pCache[i]);
+	}
+	return *this;
+}
+
+void CStackData::ClearCache()
+{
+	for (int i=0; i < MAX_CACHED_ARGUMENTS; i++)
+		Py_CLEAR(m_pCache[i]);
 }
 
 object CStackData::GetItem(unsigned int iIndex)
 {
-	if (iIndex >= (unsigned int) m_pHook->m_pCallingConvention->m_vecArgTypes.size())
+	if (iIndex >= (unsigned int) m_pArguments->m_vecGetters.size())
 		BOOST_RAISE_EXCEPTION(PyExc_IndexError, "Index out of range.")
 
 	// Argument already cached?
-	object retval;
-	//object retval = m_mapCache[iIndex];
-	//if (retval)
-	//	return retval;
+	if (iIndex < MAX_CACHED_ARGUMENTS && m_pCache[iIndex])
+		return object(handle<>(borrowed(m_pCache[iIndex])));
+
+	object retval = m_pArguments->m_vecGetters[iIndex](m_pHook, iIndex);
+	if (m_pArguments->m_vecCacheable[iIndex])
+		m_pCache[iIndex] = incref(retval.ptr());
 
-	switch(m_pHook->m_pCallingConvention->m_vecArgTypes[iIndex])
-	{
-		case DATA_TYPE_BOOL:		retval = GetArgument<bool>(m_pHook, iIndex); break;
-		case DATA_TYPE_CHAR:		retval = GetArgument<char>(m_pHook, iIndex); break;
-		case DATA_TYPE_UCHAR:		retval = GetArgument<unsigned char>(m_pHook, iIndex); break;
-		case DATA_TYPE_SHORT:		retval = GetArgument<short>(m_pHook, iIndex); break;
-		case DATA_TYPE_USHORT:		retval = GetArgument<unsigned short>(m_pHook, iIndex); break;
-		case DATA_TYPE_INT:			retval = GetArgument<int>(m_pHook, iIndex); break;
-		case DATA_TYPE_UINT:		retval = GetArgument<unsigned int>(m_pHook, iIndex); break;
-		case DATA_TYPE_LONG:		retval = GetArgument<long>(m_pHook, iIndex); break;
-		case DATA_TYPE_ULONG:		retval = GetArgument<unsigned long>(m_pHook, iIndex); break;
-		case DATA_TYPE_LONG_LONG:	retval = GetArgument<long long>(m_pHook, iIndex); break;
-		case DATA_TYPE_ULONG_LONG:	retval = GetArgument<unsigned long long>(m_pHook, iIndex); break;
-		case DATA_TYPE_FLOAT:		retval = GetArgument<float>(m_pHook, iIndex); break;
-		case DATA_TYPE_DOUBLE:		retval = GetArgument<double>(m_pHook, iIndex); break;
-		case DATA_TYPE_POINTER:		retval = object(CPointer(m_pHook->GetArgument<unsigned long>(iIndex))); break;
-		case DATA_TYPE_STRING:		retval = GetArgument<const char *>(m_pHook, iIndex); break;
-		default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.") break;
-	}
-	//m_mapCache[iIndex] = retval;
 	return retval;
 }
 
 void CStackData::SetItem(unsigned int iIndex, object value)
 {
-	if (iIndex >= (unsigned int) m_pHook->m_pCallingConvention->m_vecArgTypes.size())
+	if (iIndex >= (unsigned int) m_pArguments->m_vecSetters.size())
 		BOOST_RAISE_EXCEPTION(PyExc_IndexError, "Index out of range.")
 
-	// Update cache
-	//m_mapCache[iIndex] = value;
-	switch(m_pHook->m_pCallingConvention->m_vecArgTypes[iIndex])
-	{
-		case DATA_TYPE_BOOL:		SetArgument<bool>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_CHAR:		SetArgument<char>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_UCHAR:		SetArgument<unsigned char>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_SHORT:		SetArgument<short>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_USHORT:		SetArgument<unsigned short>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_INT:			SetArgument<int>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_UINT:		SetArgument<unsigned int>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_LONG:		SetArgument<long>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_ULONG:		SetArgument<unsigned long>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_LONG_LONG:	SetArgument<long long>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_ULONG_LONG:	SetArgument<unsigned long long>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_FLOAT:		SetArgument<float>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_DOUBLE:		SetArgument<double>(m_pHook, iIndex, value); break;
-		case DATA_TYPE_POINTER:
-		{
-			SetArgument<unsigned long>(m_pHook, iIndex, object(ExtractAddress(value)));
-		} break;
-		case DATA_TYPE_STRING:		SetArgument<const char *>(m_pHook, iIndex, value); break;
-		default: BOOST_RAISE_EXCEPTION(PyExc_TypeError, "Unknown type.")
-	}
+	// Invalidate the cache, the argument will be re-read on the next access
+	if (iIndex < MAX_CACHED_ARGUMENTS)
+		Py_CLEAR(m_pCache[iIndex]);
+
+	m_pArguments->m_vecSetters[iIndex](m_pHook, iIndex, value);
 }
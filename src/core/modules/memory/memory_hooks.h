@@ -32,20 +32,122 @@
 //---------------------------------------------------------------------------------
 #include <list>
 #include <map>
+#include <vector>
 
 #include "boost/python.hpp"
 using namespace boost::python;
 
+#include "boost/shared_ptr.hpp"
+#include "boost/unordered/unordered_flat_map.hpp"
+
 // DynamicHooks
 #include "hook.h"
 
+
+//---------------------------------------------------------------------------------
+// Typedefs
+//---------------------------------------------------------------------------------
+typedef object (*ArgumentGetterFn)(CHook* pHook, int iIndex);
+typedef void (*ArgumentSetterFn)(CHook* pHook, int iIndex, object value);
+typedef object (*ReturnValueGetterFn)(CHook* pHook);
+typedef void (*ReturnValueSetterFn)(CHook* pHook, object value);
+
+//---------------------------------------------------------------------------------
+// IHookFilter
+//---------------------------------------------------------------------------------
+// Native predicate that is tested before a callback is called, so callbacks can
+// be skipped for most invocations of a shared function without entering Python.
+class IHookFilter
+{
+public:
+	virtual ~IHookFilter() {}
+
+	virtual bool ShouldCall(CHook* pHook) = 0;
+
+	// Filters that read the this pointer can only be attached to thiscall functions.
+	virtual bool RequiresThisPointer() { return false; }
+};
+
+struct HookCallback_t
+{
+	object			m_oCallback;
+
+	// The filter is kept alive by its Python object. NULL if there is none.
+	object			m_oFilter;
+	IHookFilter*	m_pFilter;
+};
+
+// Callback lists are never modified once they have been published. Adding or
+// removing a callback creates a new list, so SP_HookHandler can safely iterate
+// over the list it has grabbed, even if a callback (un)registers other hooks.
+typedef std::vector<HookCallback_t> CallbackList_t;
+typedef boost::shared_ptr<const CallbackList_t> CallbackSnapshot_t;
+
+// Argument accessors, resolved once from the calling convention. They are
+// shared with CStackData, so stack data stays usable if the dispatcher is
+// deleted by a callback.
+struct ArgumentAccessors_t
+{
+	std::vector<ArgumentGetterFn>	m_vecGetters;
+	std::vector<ArgumentSetterFn>	m_vecSetters;
+	std::vector<bool>				m_vecCacheable;
+};
+
+typedef boost::shared_ptr<const ArgumentAccessors_t> ArgumentAccessorsPtr_t;
+
+
 //---------------------------------------------------------------------------------
 // Classes
 //---------------------------------------------------------------------------------
+class CHookDispatcher
+{
+public:
+	CHookDispatcher(CHook* pHook);
+
+	const CallbackSnapshot_t& GetCallbacks(HookType_t eHookType)
+	{ return m_pCallbacks[eHookType]; }
+
+	void AddCallback(HookType_t eHookType, object oCallback, object oFilter=object());
+	void RemoveCallback(HookType_t eHookType, object oCallback);
+
+public:
+	CHook*						m_pHook;
+
+	// Argument and return value accessors, resolved once from the calling convention
+	ArgumentAccessorsPtr_t		m_pArguments;
+	ReturnValueGetterFn			m_pReturnValueGetter;
+	ReturnValueSetterFn			m_pReturnValueSetter;
+
+private:
+	CallbackSnapshot_t			m_pCallbacks[HOOKTYPE_POST + 1];
+};
+
+
+//---------------------------------------------------------------------------------
+// HookEntry_t structure.
+//---------------------------------------------------------------------------------
+struct HookEntry_t
+{
+	CHook*				m_pHook;
+	CHookDispatcher*	m_pDispatcher;
+};
+
+// Maps the address of a hooked function to its entry
+typedef boost::unordered_flat_map<void *, HookEntry_t> HookIndex_t;
+
+
+// Arguments with a higher index are simply not cached
+#define MAX_CACHED_ARGUMENTS 32
+
 class CStackData
 {
 public:
 	CStackData(CHook* pHook);
+	CStackData(CHookDispatcher* pDispatcher);
+	CStackData(const CStackData& obj);
+	~CStackData();
+
+	CStackData& operator=(const CStackData& obj);
 
 	object		GetItem(unsigned int iIndex);
 	void		SetItem(unsigned int iIndex, object value);
@@ -72,12 +174,18 @@ public:
 
 	void SetUsePreRegisters(bool value)
 	{
+		// The arguments are read from a different set of registers now
+		ClearCache();
 		m_pHook->m_bUsePreRegisters = value;
 	}
 
+protected:
+	void ClearCache();
+
 protected:
 	CHook*                m_pHook;
-	std::map<int, object> m_mapCache;
+	ArgumentAccessorsPtr_t m_pArguments;
+	PyObject*             m_pCache[MAX_CACHED_ARGUMENTS];
 };
 
 
@@ -86,6 +194,16 @@ protected:
 //---------------------------------------------------------------------------------
 bool SP_HookHandler(HookType_t eHookType, CHook* pHook);
 
+CHookDispatcher* FindHookDispatcher(CHook* pHook);
+CHookDispatcher* GetHookDispatcher(CHook* pHook);
+
+// Address indexed counterparts of CHookManager's methods. Always use these
+// instead of calling the hook manager directly, so the index stays in sync.
+CHook* FindHook(void* pFunc);
+CHook* HookFunction(void* pFunc, ICallingConvention* pConvention);
+void UnhookFunction(void* pFunc);
+void UnhookAllFunctions();
+
 extern bool g_HooksDisabled;
 
 inline void SetHooksDisabled(bool value)
@@ -38,6 +38,13 @@
 	#define PAGE_ALIGN_UP(x) ((x + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
 #endif
 
+#ifdef _WIN32
+	#include <intrin.h>
+#endif
+#include <emmintrin.h>
+#include <sys/stat.h>
+#include <vector>
+
 #include "dynload.h"
 
 #include "memory_scanner.h"
@@ -46,11 +53,335 @@
 #include "sp_main.h"
 #include "eiface.h"
 
+// Boost
+#include "boost/filesystem.hpp"
+namespace bfs = boost::filesystem;
+
 
 //-----------------------------------------------------------------------------
 // Externals.
 //-----------------------------------------------------------------------------
 extern IVEngineServer* engine;
+extern const char *GetSourcePythonDir();
+
+
+//-----------------------------------------------------------------------------
+// Macros.
+//-----------------------------------------------------------------------------
+#define SIGNATURE_WILDCARD '\x2A'
+
+// The Linux build only passes -msse, so enable SSE2 for the scanner explicitly
+#ifdef _WIN32
+	#define SSE2_FUNCTION
+#else
+	#define SSE2_FUNCTION __attribute__((target("sse2")))
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Pattern matching helpers.
+//-----------------------------------------------------------------------------
+inline unsigned int CountTrailingZeros(unsigned int uiValue)
+{
+#ifdef _WIN32
+	unsigned long ulIndex;
+	_BitScanForward(&ulIndex, uiValue);
+	return ulIndex;
+#else
+	return __builtin_ctz(uiValue);
+#endif
+}
+
+inline bool MatchesPattern(const unsigned char* pAddr, const unsigned char* pPattern, int iLength)
+{
+	for(int i=0; i < iLength; i++)
+	{
+		if (pPattern[i] != SIGNATURE_WILDCARD && pPattern[i] != pAddr[i])
+			return false;
+	}
+	return true;
+}
+
+// Returns the index of the first byte that isn't a wildcard or iLength.
+inline int GetAnchorIndex(const unsigned char* pPattern, int iLength)
+{
+	int iAnchor = 0;
+	while (iAnchor < iLength && pPattern[iAnchor] == SIGNATURE_WILDCARD)
+		iAnchor++;
+
+	return iAnchor;
+}
+
+// Returns the first address in [pBase, pEnd) at which the pattern starts or
+// NULL. The anchor byte is compared against 16 positions at once, so only a
+// few candidates need to be compared against the full pattern.
+SSE2_FUNCTION
+unsigned char* FindPattern(unsigned char* pBase, unsigned char* pEnd, const unsigned char* pPattern, int iLength)
+{
+	if (pBase >= pEnd)
+		return NULL;
+
+	int iAnchor = GetAnchorIndex(pPattern, iLength);
+	if (iAnchor == iLength)
+		return pBase;
+
+	const __m128i xAnchor = _mm_set1_epi8((char) pPattern[iAnchor]);
+	unsigned char* pAddr = pBase;
+	for (; pEnd - pAddr >= 16; pAddr += 16)
+	{
+		__m128i xBlock = _mm_loadu_si128((const __m128i *) (pAddr + iAnchor));
+		unsigned int uiMask = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(xBlock, xAnchor));
+		while (uiMask)
+		{
+			unsigned char* pCandidate = pAddr + CountTrailingZeros(uiMask);
+			if (MatchesPattern(pCandidate, pPattern, iLength))
+				return pCandidate;
+
+			uiMask &= uiMask - 1;
+		}
+	}
+
+	for (; pAddr < pEnd; pAddr++)
+	{
+		if (MatchesPattern(pAddr, pPattern, iLength))
+			return pAddr;
+	}
+
+	return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// Persistent cache helpers.
+//-----------------------------------------------------------------------------
+#define CACHE_FILE_MAGIC "SPBC"
+#define CACHE_FILE_VERSION 1
+#define CACHE_FILE_DIR "/data/source-python/cache"
+
+#define CACHE_ENTRY_SIGNATURE 'S'
+#define CACHE_ENTRY_SYMBOL 'Y'
+
+inline unsigned int HashString(const std::string& str)
+{
+	// FNV-1a
+	unsigned int uiHash = 2166136261u;
+	for (unsigned int i=0; i < str.size(); i++)
+	{
+		uiHash ^= (unsigned char) str[i];
+		uiHash *= 16777619u;
+	}
+	return uiHash;
+}
+
+inline void WriteUInt(FILE* pFile, unsigned int uiValue)
+{
+	fwrite(&uiValue, sizeof(uiValue), 1, pFile);
+}
+
+inline bool ReadUInt(FILE* pFile, unsigned int& uiValue)
+{
+	return fread(&uiValue, sizeof(uiValue), 1, pFile) == 1;
+}
+
+inline void WriteString(FILE* pFile, const std::string& str)
+{
+	WriteUInt(pFile, str.size());
+	fwrite(str.data(), 1, str.size(), pFile);
+}
+
+inline bool ReadString(FILE* pFile, std::string& str)
+{
+	unsigned int uiLength;
+	if (!ReadUInt(pFile, uiLength) || uiLength > 0xFFFF)
+		return false;
+
+	str.resize(uiLength);
+	return uiLength == 0 || fread(&str[0], 1, uiLength, pFile) == uiLength;
+}
+
+// Returns the path of the binary on disk.
+std::string GetBinaryPath(unsigned long ulModule)
+{
+#ifdef _WIN32
+	char szPath[MAX_PATH];
+	if (!GetModuleFileNameA((HMODULE) ulModule, szPath, MAX_PATH))
+		return std::string();
+
+	return std::string(szPath);
+#else
+	return std::string(((struct link_map *) ulModule)->l_name);
+#endif
+}
+
+// Returns a string that changes whenever the binary is rebuilt. The ELF
+// build-id is used if available, otherwise the file's size and mtime.
+std::string GetBinaryBuildID(unsigned long ulBase, const std::string& szPath)
+{
+	char szBuffer[64];
+#ifdef _WIN32
+	IMAGE_DOS_HEADER* dos = (IMAGE_DOS_HEADER *) ulBase;
+	IMAGE_NT_HEADERS* nt  = (IMAGE_NT_HEADERS *) ((BYTE *) dos + dos->e_lfanew);
+	sprintf(szBuffer, "pe:%08lx:%08lx:%08lx",
+		(unsigned long) nt->FileHeader.TimeDateStamp,
+		(unsigned long) nt->OptionalHeader.SizeOfImage,
+		(unsigned long) nt->OptionalHeader.CheckSum);
+
+	return std::string(szBuffer);
+#else
+	Elf32_Ehdr* file = (Elf32_Ehdr *) ulBase;
+	Elf32_Phdr* phdr = (Elf32_Phdr *) (ulBase + file->e_phoff);
+
+	for (uint16_t i = 0; i < file->e_phnum; i++)
+	{
+		if (phdr[i].p_type != PT_NOTE)
+			continue;
+
+		unsigned char* pNote = (unsigned char *) (ulBase + phdr[i].p_vaddr);
+		unsigned char* pEnd = pNote + phdr[i].p_memsz;
+		while (pNote + sizeof(Elf32_Nhdr) <= pEnd)
+		{
+			Elf32_Nhdr* pHeader = (Elf32_Nhdr *) pNote;
+			const char* szName = (const char *) (pHeader + 1);
+			unsigned char* pDesc = (unsigned char *) szName + ((pHeader->n_namesz + 3) & ~3);
+
+			if (pHeader->n_type == NT_GNU_BUILD_ID && pHeader->n_namesz == 4 && memcmp(szName, "GNU", 4) == 0)
+			{
+				std::string result = "elf:";
+				for (unsigned int j=0; j < pHeader->n_descsz; j++)
+				{
+					sprintf(szBuffer, "%02x", pDesc[j]);
+					result += szBuffer;
+				}
+				return result;
+			}
+
+			pNote = pDesc + ((pHeader->n_descsz + 3) & ~3);
+		}
+	}
+
+	struct stat filestat;
+	if (stat(szPath.c_str(), &filestat) != 0)
+		return std::string();
+
+	sprintf(szBuffer, "stat:%lx:%lx", (unsigned long) filestat.st_size, (unsigned long) filestat.st_mtime);
+	return std::string(szBuffer);
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+// Batch scanning helpers.
+//-----------------------------------------------------------------------------
+enum SignatureVariant_t
+{
+	SIGNATURE_PLAIN,
+	SIGNATURE_RELATIVE_JUMP,
+	SIGNATURE_ABSOLUTE_JUMP,
+
+	SIGNATURE_VARIANT_COUNT
+};
+
+struct PatternScan_t
+{
+	std::string		m_Pattern;
+	int				m_iAnchor;
+	unsigned char*	m_pEnd;
+	unsigned char*	m_pFirst;
+	bool			m_bUnique;
+	bool			m_bDone;
+};
+
+// Stops searching a signature and its hooked variants, because a plain match
+// always wins. Returns the number of patterns that are done now.
+inline unsigned int FinishSignature(std::vector<PatternScan_t>& vecScans, unsigned int uiPlain)
+{
+	unsigned int uiDone = 0;
+	for (unsigned int i=uiPlain; i < uiPlain + SIGNATURE_VARIANT_COUNT; i++)
+	{
+		if (vecScans[i].m_bDone)
+			continue;
+
+		vecScans[i].m_bDone = true;
+		uiDone++;
+	}
+	return uiDone;
+}
+
+// Matches all patterns anchored at the given address. Returns the number of
+// patterns that are done now.
+inline unsigned int MatchBucket(unsigned char* pAddr, unsigned char* pBase,
+	std::vector<PatternScan_t>& vecScans, const std::vector<unsigned int>& bucket)
+{
+	unsigned int uiDone = 0;
+	for (unsigned int i=0; i < bucket.size(); i++)
+	{
+		PatternScan_t& scan = vecScans[bucket[i]];
+		if (scan.m_bDone)
+			continue;
+
+		unsigned char* pStart = pAddr - scan.m_iAnchor;
+		if (pStart < pBase || pStart >= scan.m_pEnd)
+			continue;
+
+		if (!MatchesPattern(pStart, (const unsigned char *) scan.m_Pattern.data(), scan.m_Pattern.size()))
+			continue;
+
+		if (!scan.m_pFirst)
+		{
+			scan.m_pFirst = pStart;
+
+			// Hooked variants need to be unique, so keep searching them
+			if (bucket[i] % SIGNATURE_VARIANT_COUNT == SIGNATURE_PLAIN)
+				uiDone += FinishSignature(vecScans, bucket[i]);
+		}
+		else if (pStart >= scan.m_pFirst + scan.m_Pattern.size())
+		{
+			scan.m_bUnique = false;
+			scan.m_bDone = true;
+			uiDone++;
+		}
+	}
+	return uiDone;
+}
+
+// Compares 16 bytes at once against every anchor byte and only dispatches the
+// positions that hit one of them. With too many distinct anchors the
+// comparisons cost more than they save, so fall back to a byte-wise pass.
+SSE2_FUNCTION
+void ScanPatterns(unsigned char* pBase, unsigned char* pEnd, std::vector<PatternScan_t>& vecScans,
+	std::vector<unsigned int> (&vecBuckets)[256], const std::vector<unsigned char>& vecAnchors,
+	unsigned int uiRemaining)
+{
+	unsigned char* pAddr = pBase;
+	if (vecAnchors.size() <= 16)
+	{
+		__m128i xAnchors[16];
+		for (unsigned int i=0; i < vecAnchors.size(); i++)
+			xAnchors[i] = _mm_set1_epi8((char) vecAnchors[i]);
+
+		for (; pEnd - pAddr >= 16 && uiRemaining; pAddr += 16)
+		{
+			__m128i xBlock = _mm_loadu_si128((const __m128i *) pAddr);
+			unsigned int uiMask = 0;
+			for (unsigned int i=0; i < vecAnchors.size(); i++)
+				uiMask |= (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(xBlock, xAnchors[i]));
+
+			while (uiMask && uiRemaining)
+			{
+				unsigned char* pCandidate = pAddr + CountTrailingZeros(uiMask);
+				uiRemaining -= MatchBucket(pCandidate, pBase, vecScans, vecBuckets[*pCandidate]);
+				uiMask &= uiMask - 1;
+			}
+		}
+	}
+
+	for (; pAddr < pEnd && uiRemaining; pAddr++)
+	{
+		std::vector<unsigned int>& bucket = vecBuckets[*pAddr];
+		if (!bucket.empty())
+			uiRemaining -= MatchBucket(pAddr, pBase, vecScans, bucket);
+	}
+}
 
 
 //-----------------------------------------------------------------------------
@@ -61,6 +392,13 @@ CBinaryFile::CBinaryFile(unsigned long ulModule, unsigned long ulBase, unsigned
 	m_ulModule = ulModule;
 	m_ulBase = ulBase;
 	m_ulSize = ulSize;
+
+	m_bSymbolTableLoaded = false;
+	m_szSymbolTableError = NULL;
+	m_bDynamicTableLoaded = false;
+	m_ulGnuHash = 0;
+	m_ulDynSym = 0;
+	m_ulDynStr = 0;
 }
 
 CPointer* CBinaryFile::FindSignatureRaw(object oSignature)
@@ -74,49 +412,165 @@ CPointer* CBinaryFile::FindSignatureRaw(object oSignature)
 	unsigned char* base = (unsigned char *) m_ulBase;
 	unsigned char* end  = (unsigned char *) (base + m_ulSize - iLength);
 
-	while(base < end)
+	return new CPointer((unsigned long) FindPattern(base, end, sigstr, iLength));
+}
+
+void CBinaryFile::AddSignatureToCache(unsigned char* sigstr, int iLength, unsigned long ulAddr)
+{
+	std::string signature((const char *) sigstr, iLength);
+	m_Signatures[signature] = ulAddr;
+	QueueCacheEntry(CACHE_ENTRY_SIGNATURE, signature, ulAddr);
+}
+
+void CBinaryFile::AddSymbolToCache(const char* szSymbol, unsigned long ulAddr)
+{
+	std::string symbol(szSymbol);
+	m_Symbols[symbol] = ulAddr;
+	QueueCacheEntry(CACHE_ENTRY_SYMBOL, symbol, ulAddr);
+}
+
+bool CBinaryFile::SearchSigInCache(unsigned char* sigstr, int iLength, CPointer*& result)
+{
+	PythonLog(4, "Searching for a cached signature...");
+	AddressCache_t::const_iterator it = m_Signatures.find(std::string((const char *) sigstr, iLength));
+	if (it == m_Signatures.end())
 	{
-		int i = 0;
-		for(; i < iLength; i++)
-		{
-			if (sigstr[i] == '\x2A')
-				continue;
+		PythonLog(4, "Could not find a cached signature.");
+		return false;
+	}
 
-			if (sigstr[i] != base[i])
-				break;
-		}
+	PythonLog(4, "Found a cached signature!");
+	result = new CPointer(it->second);
+	return true;
+}
+
+void CBinaryFile::QueueCacheEntry(char cType, const std::string& key, unsigned long ulAddr)
+{
+	if (m_szCacheFile.empty())
+		return;
+
+	// Plugins usually look up lots of addresses at once, so they are
+	// written in a single batch by FlushCacheFile()
+	CacheEntry_t entry = {cType, key, (unsigned int) (ulAddr - m_ulBase)};
+	m_vecPendingEntries.push_back(entry);
+}
 
-		if (i == iLength)
+void CBinaryFile::FlushCacheFile()
+{
+	if (m_vecPendingEntries.empty())
+		return;
+
+	FILE* pFile = fopen(m_szCacheFile.c_str(), "ab");
+	if (pFile)
+	{
+		for (std::vector<CacheEntry_t>::const_iterator it = m_vecPendingEntries.begin(); it != m_vecPendingEntries.end(); ++it)
 		{
-			return new CPointer((unsigned long) base);
+			fputc(it->m_cType, pFile);
+			WriteString(pFile, it->m_Key);
+			WriteUInt(pFile, it->m_uiRVA);
 		}
-		base++;
+
+		fclose(pFile);
 	}
-	return new CPointer();
-}
 
-void CBinaryFile::AddSignatureToCache(unsigned char* sigstr, int iLength, unsigned int ulAddr)
-{
-	Signature_t sig_t = {new unsigned char[iLength+1], ulAddr};
-	strcpy((char*) sig_t.m_szSignature, (char*) sigstr);
-	m_Signatures.push_back(sig_t);
+	m_vecPendingEntries.clear();
 }
 
-bool CBinaryFile::SearchSigInCache(unsigned char* sigstr, CPointer*& result)
+void CBinaryFile::LoadCacheFile()
 {
-	PythonLog(4, "Searching for a cached signature...");
-	for (std::list<Signature_t>::iterator iter=m_Signatures.begin(); iter != m_Signatures.end(); ++iter)
+	std::string szPath = GetBinaryPath(m_ulModule);
+	std::string szBuildID = GetBinaryBuildID(m_ulBase, szPath);
+	if (szPath.empty() || szBuildID.empty())
+		return;
+
+	std::string szIdentity = szPath + "|" + szBuildID;
+
+	char szFileName[32];
+	sprintf(szFileName, "%08x.bin", HashString(szPath));
+
+	bfs::path cacheDir = bfs::path(GetSourcePythonDir()) / CACHE_FILE_DIR;
+	try
+	{
+		bfs::create_directories(cacheDir);
+	}
+	catch (...)
 	{
-		Signature_t sig = *iter;
-		if (strcmp((const char *) sig.m_szSignature, (const char *) sigstr) == 0)
+		PythonLog(2, "Failed to create the binary cache directory.");
+		return;
+	}
+
+	m_szCacheFile = (bfs::path(cacheDir) / (bfs::path(szPath).filename().string() + "_" + szFileName)).string();
+
+	// Validate the header. If anything is off, the binary has been updated
+	// or the file is corrupted, so start with a new file.
+	bool bValid = false;
+	FILE* pFile = fopen(m_szCacheFile.c_str(), "rb");
+	if (pFile)
+	{
+		char szMagic[4];
+		unsigned int uiVersion;
+		std::string szFileIdentity;
+
+		bValid = fread(szMagic, 1, 4, pFile) == 4 && memcmp(szMagic, CACHE_FILE_MAGIC, 4) == 0
+			&& ReadUInt(pFile, uiVersion) && uiVersion == CACHE_FILE_VERSION
+			&& ReadString(pFile, szFileIdentity) && szFileIdentity == szIdentity;
+
+		unsigned int uiLoaded = 0;
+		int cType;
+		while (bValid && (cType = fgetc(pFile)) != EOF)
 		{
-			PythonLog(4, "Found a cached signature!");
-			result = new CPointer(sig.m_ulAddr);
-			return true;
+			std::string key;
+			unsigned int uiRVA;
+			if (!ReadString(pFile, key) || !ReadUInt(pFile, uiRVA))
+				break;
+
+			unsigned long ulAddr = m_ulBase + uiRVA;
+			if (cType == CACHE_ENTRY_SIGNATURE)
+			{
+				// Make sure the signature (or a hooked variant) is still there
+				if (uiRVA + key.size() > m_ulSize)
+					continue;
+
+				const unsigned char* pPattern = (const unsigned char *) key.data();
+				const unsigned char* pAddr = (const unsigned char *) ulAddr;
+				if (!MatchesPattern(pAddr, pPattern, key.size())
+					&& !(key.size() > 6 && pAddr[0] == 0xE9 && MatchesPattern(pAddr + 5, pPattern + 5, key.size() - 5))
+					&& !(key.size() > 7 && pAddr[0] == 0xFF && pAddr[1] == 0x25 && MatchesPattern(pAddr + 6, pPattern + 6, key.size() - 6)))
+					continue;
+
+				m_Signatures[key] = ulAddr;
+			}
+			else if (cType == CACHE_ENTRY_SYMBOL)
+			{
+				m_Symbols[key] = ulAddr;
+			}
+			else
+			{
+				break;
+			}
+
+			uiLoaded++;
 		}
+
+		fclose(pFile);
+		if (bValid)
+			PythonLog(4, "Loaded %u cached addresses from %s.", uiLoaded, m_szCacheFile.c_str());
 	}
-	PythonLog(4, "Could not find a cached signature.");
-	return false;
+
+	if (bValid)
+		return;
+
+	pFile = fopen(m_szCacheFile.c_str(), "wb");
+	if (!pFile)
+	{
+		m_szCacheFile.clear();
+		return;
+	}
+
+	fwrite(CACHE_FILE_MAGIC, 1, 4, pFile);
+	WriteUInt(pFile, CACHE_FILE_VERSION);
+	WriteString(pFile, szIdentity);
+	fclose(pFile);
 }
 
 bool CBinaryFile::SearchSigInBinary(object oSignature, int iLength, unsigned char* sigstr, CPointer*& result)
@@ -149,14 +603,13 @@ bool CBinaryFile::SearchSigHooked(object oSignature, int iLength, unsigned char*
 	PythonLog(4, "Checking if it's unique...");
 
 	// Add iLength, so we start searching after the match
-	CPointer new_ptr = CPointer(pPtr->m_ulAddr + len(oSignature));
+	int iHookedLength = len(oSignature);
+	unsigned char* pHookedSig = (unsigned char *) PyBytes_AsString(oSignature.ptr());
+	unsigned char* pStart = (unsigned char *) (pPtr->m_ulAddr + iHookedLength);
+	unsigned char* pEnd = (unsigned char *) (m_ulBase + m_ulSize - (iHookedLength - 1));
 
 	// Got another match after the first one?
-	CPointer* pNext = new_ptr.SearchBytes(oSignature, (m_ulBase + m_ulSize) - new_ptr.m_ulAddr);
-	bool bIsValid = pNext->IsValid();
-	delete pNext;
-
-	if (bIsValid)
+	if (FindPattern(pStart, pEnd, pHookedSig, iHookedLength))
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Found more than one hooked signatures. Please pass more bytes.");
 
 	PythonLog(4, "Signature is unique!");
@@ -171,11 +624,11 @@ CPointer* CBinaryFile::FindSignature(object oSignature)
 	if (!sigstr)
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to read the given signature.");
 	
+	int iLength = len(oSignature);
 	CPointer* result = NULL;
-	if (SearchSigInCache(sigstr, result))
+	if (SearchSigInCache(sigstr, iLength, result))
 		return result;
 	
-	int iLength = len(oSignature);
 	if (SearchSigInBinary(oSignature, iLength, sigstr, result))
 		return result;
 
@@ -203,20 +656,355 @@ CPointer* CBinaryFile::FindSignature(object oSignature)
 	return new CPointer(); // To fix a warning. This will never get called.
 }
 
+list CBinaryFile::FindSignatures(object oSignatures)
+{
+	list result;
+	std::vector<object> vecSignatures;
+	std::vector<bool> vecCached;
+	std::vector<PatternScan_t> vecScans;
+
+	unsigned char* pBase = (unsigned char *) m_ulBase;
+	unsigned char* pModuleEnd = pBase + m_ulSize;
+
+	// Step 1: Resolve cached signatures and prepare the others
+	object iterator = object(handle<>(PyObject_GetIter(oSignatures.ptr())));
+	PyObject* pItem;
+	while ((pItem = PyIter_Next(iterator.ptr())) != NULL)
+	{
+		object oSignature = object(handle<>(pItem));
+		unsigned char* sigstr = (unsigned char *) PyBytes_AsString(oSignature.ptr());
+		if (!sigstr)
+			BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to read the given signature.");
+
+		vecSignatures.push_back(oSignature);
+
+		CPointer* pCached = NULL;
+		vecCached.push_back(SearchSigInCache(sigstr, len(oSignature), pCached));
+		if (pCached)
+		{
+			result.append(object(*pCached));
+			delete pCached;
+			continue;
+		}
+
+		result.append(object());
+
+		int iLength = len(oSignature);
+		std::string pattern((const char *) sigstr, iLength);
+		for (int iVariant=SIGNATURE_PLAIN; iVariant < SIGNATURE_VARIANT_COUNT; iVariant++)
+		{
+			PatternScan_t scan;
+			scan.m_pFirst = NULL;
+			scan.m_bUnique = true;
+			scan.m_bDone = false;
+
+			switch (iVariant)
+			{
+				case SIGNATURE_PLAIN:
+					scan.m_Pattern = pattern;
+					scan.m_pEnd = pModuleEnd - iLength;
+					break;
+				case SIGNATURE_RELATIVE_JUMP:
+					scan.m_pEnd = pModuleEnd - (iLength - 1);
+					if (iLength <= 6)
+					{
+						// Too short to search for a hooked signature, keep the slot though
+						scan.m_Pattern = pattern;
+						scan.m_bDone = true;
+					}
+					else
+						scan.m_Pattern = std::string("\xE9\x2A\x2A\x2A\x2A", 5) + pattern.substr(5);
+					break;
+				case SIGNATURE_ABSOLUTE_JUMP:
+					scan.m_pEnd = pModuleEnd - (iLength - 1);
+					if (iLength <= 7)
+					{
+						scan.m_Pattern = pattern;
+						scan.m_bDone = true;
+					}
+					else
+						scan.m_Pattern = std::string("\xFF\x25\x2A\x2A\x2A\x2A", 6) + pattern.substr(6);
+					break;
+			}
+
+			scan.m_iAnchor = iLength;
+			vecScans.push_back(scan);
+		}
+	}
+
+	if (PyErr_Occurred())
+		throw_error_already_set();
+
+	if (vecScans.empty())
+		return result;
+
+	// Step 2: Pick an anchor byte for every pattern. The fewer distinct anchor
+	// bytes there are, the cheaper the SIMD pass gets, so greedily pick the
+	// bytes shared by most of the remaining patterns.
+	std::vector<unsigned int> vecBuckets[256];
+	std::vector<unsigned char> vecAnchors;
+	std::vector<unsigned int> vecUnanchored;
+	std::vector<unsigned int> vecPending;
+	for (unsigned int i=0; i < vecScans.size(); i++)
+	{
+		PatternScan_t& scan = vecScans[i];
+		if (scan.m_bDone)
+			continue;
+
+		if (GetAnchorIndex((const unsigned char *) scan.m_Pattern.data(), scan.m_Pattern.size()) == (int) scan.m_Pattern.size())
+			vecUnanchored.push_back(i);
+		else
+			vecPending.push_back(i);
+	}
+
+	while (!vecPending.empty())
+	{
+		unsigned int uiCounts[256] = {0};
+		for (unsigned int i=0; i < vecPending.size(); i++)
+		{
+			const std::string& pattern = vecScans[vecPending[i]].m_Pattern;
+			bool bSeen[256] = {false};
+			for (unsigned int j=0; j < pattern.size(); j++)
+			{
+				unsigned char ucByte = (unsigned char) pattern[j];
+				if (ucByte == (unsigned char) SIGNATURE_WILDCARD || bSeen[ucByte])
+					continue;
+
+				bSeen[ucByte] = true;
+				uiCounts[ucByte]++;
+			}
+		}
+
+		unsigned char ucAnchor = 0;
+		for (unsigned int j=1; j < 256; j++)
+		{
+			if (uiCounts[j] > uiCounts[ucAnchor])
+				ucAnchor = (unsigned char) j;
+		}
+
+		vecAnchors.push_back(ucAnchor);
+		std::vector<unsigned int> vecLeft;
+		for (unsigned int i=0; i < vecPending.size(); i++)
+		{
+			PatternScan_t& scan = vecScans[vecPending[i]];
+			std::string::size_type uiAnchor = scan.m_Pattern.find((char) ucAnchor);
+			if (uiAnchor == std::string::npos)
+			{
+				vecLeft.push_back(vecPending[i]);
+				continue;
+			}
+
+			scan.m_iAnchor = (int) uiAnchor;
+			vecBuckets[ucAnchor].push_back(vecPending[i]);
+		}
+
+		vecPending.swap(vecLeft);
+	}
+
+	// Patterns that consist only of wildcards match at the very beginning.
+	// Hooked variants always have an anchor, so these are plain patterns.
+	for (unsigned int i=0; i < vecUnanchored.size(); i++)
+	{
+		PatternScan_t& scan = vecScans[vecUnanchored[i]];
+		if (pBase < scan.m_pEnd)
+		{
+			scan.m_pFirst = pBase;
+			FinishSignature(vecScans, vecUnanchored[i]);
+		}
+		else
+			scan.m_bDone = true;
+	}
+
+	unsigned int uiRemaining = 0;
+	for (unsigned int i=0; i < vecScans.size(); i++)
+	{
+		if (!vecScans[i].m_bDone)
+			uiRemaining++;
+	}
+
+	// Step 3: Search all patterns and their hooked variants in a single pass
+	PythonLog(4, "Searching for %u signatures in the binary...", (unsigned int) (vecScans.size() / SIGNATURE_VARIANT_COUNT));
+	ScanPatterns(pBase, pModuleEnd, vecScans, vecBuckets, vecAnchors, uiRemaining);
+
+	// Step 4: Pick the results in the same order FindSignature() would
+	unsigned int uiScan = 0;
+	for (unsigned int i=0; i < vecSignatures.size(); i++)
+	{
+		if (vecCached[i])
+			continue;
+
+		CPointer* pFound = NULL;
+		for (int iVariant=SIGNATURE_PLAIN; iVariant < SIGNATURE_VARIANT_COUNT; iVariant++)
+		{
+			PatternScan_t& scan = vecScans[uiScan + iVariant];
+			if (!scan.m_pFirst || !scan.m_bUnique)
+				continue;
+
+			unsigned char* sigstr = (unsigned char *) PyBytes_AsString(vecSignatures[i].ptr());
+			AddSignatureToCache(sigstr, len(vecSignatures[i]), (unsigned long) scan.m_pFirst);
+			pFound = new CPointer((unsigned long) scan.m_pFirst);
+			break;
+		}
+
+		uiScan += SIGNATURE_VARIANT_COUNT;
+		if (!pFound)
+		{
+			result[i] = CPointer();
+			continue;
+		}
+
+		result[i] = object(*pFound);
+		delete pFound;
+	}
+
+	return result;
+}
+
 CPointer* CBinaryFile::FindSymbol(char* szSymbol)
 {
-#ifdef _WIN32
-	void* pAddr = GetProcAddress((HMODULE) m_ulModule, szSymbol);
-	if (!pAddr)
+	unsigned long ulAddr = ResolveSymbol(szSymbol);
+	if (!ulAddr)
 		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Could not find symbol: %s", szSymbol)
 
-	return new CPointer((unsigned long) pAddr);
+	return new CPointer(ulAddr);
+}
+
+list CBinaryFile::FindSymbols(object oSymbols)
+{
+	list result;
+	object iterator = object(handle<>(PyObject_GetIter(oSymbols.ptr())));
+	PyObject* pItem;
+	while ((pItem = PyIter_Next(iterator.ptr())) != NULL)
+	{
+		object oSymbol = object(handle<>(pItem));
+		result.append(CPointer(ResolveSymbol(extract<char*>(oSymbol))));
+	}
+
+	if (PyErr_Occurred())
+		throw_error_already_set();
+
+	return result;
+}
+
+unsigned long CBinaryFile::ResolveSymbol(const char* szSymbol)
+{
+#ifdef _WIN32
+	return (unsigned long) GetProcAddress((HMODULE) m_ulModule, szSymbol);
 
 #elif defined(__linux__)
+	AddressCache_t::const_iterator it = m_Symbols.find(szSymbol);
+	if (it != m_Symbols.end())
+		return it->second;
+
+	// Exported symbols can be looked up using the loaded .gnu.hash section
+	unsigned long ulAddr = FindDynamicSymbol(szSymbol);
+	if (ulAddr)
+		return ulAddr;
+
+	// Fall back to dlsym() to also search the dependencies
 	dlerror();
 	void* pResult = dlsym((void*) m_ulModule, szSymbol);
 	if (!dlerror())
-		return new CPointer((unsigned long) pResult);
+		return (unsigned long) pResult;
+
+	// Private symbols are only listed in the .symtab section
+	if (!LoadSymbolTable())
+		return 0;
+
+	it = m_SymbolTable.find(szSymbol);
+	if (it == m_SymbolTable.end())
+		return 0;
+
+	AddSymbolToCache(szSymbol, it->second);
+	return it->second;
+#else
+#error "BinaryFile::ResolveSymbol() is not implemented on this OS"
+#endif
+}
+
+#ifdef __linux__
+unsigned long CBinaryFile::FindDynamicSymbol(const char* szSymbol)
+{
+	struct link_map* dlmap = (struct link_map *) m_ulModule;
+	if (!m_bDynamicTableLoaded)
+	{
+		m_bDynamicTableLoaded = true;
+		for (Elf32_Dyn* dyn = (Elf32_Dyn *) dlmap->l_ld; dyn->d_tag != DT_NULL; dyn++)
+		{
+			// The dynamic linker usually relocates these already
+			unsigned long ulPtr = dyn->d_un.d_ptr;
+			if (ulPtr < dlmap->l_addr)
+				ulPtr += dlmap->l_addr;
+
+			switch (dyn->d_tag)
+			{
+				case DT_GNU_HASH: m_ulGnuHash = ulPtr; break;
+				case DT_SYMTAB:   m_ulDynSym = ulPtr; break;
+				case DT_STRTAB:   m_ulDynStr = ulPtr; break;
+			}
+		}
+	}
+
+	if (!m_ulGnuHash || !m_ulDynSym || !m_ulDynStr)
+		return 0;
+
+	uint32_t uiHash = 5381;
+	for (const unsigned char* c = (const unsigned char *) szSymbol; *c; c++)
+		uiHash = (uiHash << 5) + uiHash + *c;
+
+	uint32_t* table = (uint32_t *) m_ulGnuHash;
+	uint32_t nbuckets = table[0];
+	uint32_t symoffset = table[1];
+	uint32_t bloom_size = table[2];
+	uint32_t bloom_shift = table[3];
+	uint32_t* bloom = table + 4;
+	uint32_t* buckets = bloom + bloom_size;
+	uint32_t* chain = buckets + nbuckets;
+
+	if (!nbuckets || !bloom_size)
+		return 0;
+
+	// Check the bloom filter first to reject most misses immediately
+	uint32_t word = bloom[(uiHash / 32) % bloom_size];
+	uint32_t mask = (1u << (uiHash % 32)) | (1u << ((uiHash >> bloom_shift) % 32));
+	if ((word & mask) != mask)
+		return 0;
+
+	uint32_t symix = buckets[uiHash % nbuckets];
+	if (symix < symoffset)
+		return 0;
+
+	Elf32_Sym* symtab = (Elf32_Sym *) m_ulDynSym;
+	const char* strtab = (const char *) m_ulDynStr;
+	while (true)
+	{
+		Elf32_Sym& sym = symtab[symix];
+		uint32_t uiChainHash = chain[symix - symoffset];
+		if ((uiHash | 1) == (uiChainHash | 1) && sym.st_shndx != SHN_UNDEF
+			&& strcmp(szSymbol, strtab + sym.st_name) == 0)
+		{
+			unsigned char sym_type = ELF32_ST_TYPE(sym.st_info);
+			if (sym_type == STT_FUNC || sym_type == STT_OBJECT)
+				return dlmap->l_addr + sym.st_value;
+		}
+
+		// The last entry of a chain has the lowest bit set
+		if (uiChainHash & 1)
+			break;
+
+		symix++;
+	}
+
+	return 0;
+}
+
+bool CBinaryFile::LoadSymbolTable()
+{
+	if (m_bSymbolTableLoaded)
+		return m_szSymbolTableError == NULL;
+
+	// Also remember failures, so stripped binaries aren't reopened on every lookup
+	m_bSymbolTableLoaded = true;
 
 	// -----------------------------------------
 	// We need to use mmap now that VALVe has
@@ -245,7 +1033,8 @@ CPointer* CBinaryFile::FindSymbol(char* szSymbol)
 	if (dlfile == -1 || fstat(dlfile, &dlstat) == -1)
 	{
 		close(dlfile);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to open file. Symbol: %s", szSymbol)
+		m_szSymbolTableError = "Failed to open file.";
+		return false;
 	}
 
 	/* Map library file into memory */
@@ -253,12 +1042,16 @@ CPointer* CBinaryFile::FindSymbol(char* szSymbol)
 	map_base = (uintptr_t)file_hdr;
 	close(dlfile);
 	if (file_hdr == MAP_FAILED)
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to map file. Symbol: %s", szSymbol)
+	{
+		m_szSymbolTableError = "Failed to map file.";
+		return false;
+	}
 
 	if (file_hdr->e_shoff == 0 || file_hdr->e_shstrndx == SHN_UNDEF)
 	{
 		munmap(file_hdr, dlstat.st_size);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "No section header string table has been found. Symbol: %s", szSymbol)
+		m_szSymbolTableError = "No section header string table has been found.";
+		return false;
 	}
 
 	sections = (Elf32_Shdr *)(map_base + file_hdr->e_shoff);
@@ -284,41 +1077,38 @@ CPointer* CBinaryFile::FindSymbol(char* szSymbol)
 	if (symtab_hdr == NULL || strtab_hdr == NULL)
 	{
 		munmap(file_hdr, dlstat.st_size);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "No symbol table or string table found. Symbol: %s", szSymbol)
+		m_szSymbolTableError = "No symbol table or string table found.";
+		return false;
 	}
 
 	symtab = (Elf32_Sym *)(map_base + symtab_hdr->sh_offset);
 	strtab = (const char *)(map_base + strtab_hdr->sh_offset);
 	symbol_count = symtab_hdr->sh_size / symtab_hdr->sh_entsize;
 
-	/* Iterate symbol table starting from the position we were at last time */
+	/* Copy all functions and objects into the index */
+	m_SymbolTable.reserve(symbol_count);
 	for (uint32_t i = 0; i < symbol_count; i++)
 	{
 		Elf32_Sym &sym = symtab[i];
 		unsigned char sym_type = ELF32_ST_TYPE(sym.st_info);
-		const char *sym_name = strtab + sym.st_name;
 
 		/* Skip symbols that are undefined or do not refer to functions or objects */
 		if (sym.st_shndx == SHN_UNDEF || (sym_type != STT_FUNC && sym_type != STT_OBJECT))
 			continue;
 
-		if (strcmp(szSymbol, sym_name) == 0)
-		{
-			pResult = (void *)(dlmap->l_addr + sym.st_value);
-			break;
-		}
+		// find_symbol() always used the first definition of a name, while
+		// get_symbols() returned the last one
+		unsigned long ulAddr = dlmap->l_addr + sym.st_value;
+		std::pair<AddressCache_t::iterator, bool> result = m_SymbolTable.emplace(strtab + sym.st_name, ulAddr);
+		if (!result.second)
+			m_DuplicateSymbols[result.first->first] = ulAddr;
 	}
 
-	// Unmap the file now.
+	// Unmap the file now. The index holds copies of the names.
 	munmap(file_hdr, dlstat.st_size);
-	if (!pResult)
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Could not find symbol: %s", szSymbol)
-
-	return new CPointer((unsigned long) pResult);
-#else
-#error "BinaryFile::FindSymbol() is not implemented on this OS"
-#endif
+	return true;
 }
+#endif
 
 CPointer* CBinaryFile::FindPointer(object oIdentifier, int iOffset, unsigned int iLevel)
 {
@@ -374,89 +1164,14 @@ dict CBinaryFile::GetSymbols()
 		result[name] = CPointer((unsigned long) GetProcAddress((HMODULE) m_ulModule, name));
 	}
 #elif __linux__
-	// TODO: Remove duplicated code. See also: FindSymbol()
-	
-	struct link_map *dlmap;
-	struct stat dlstat;
-	int dlfile;
-	uintptr_t map_base;
-	Elf32_Ehdr *file_hdr;
-	Elf32_Shdr *sections, *shstrtab_hdr, *symtab_hdr, *strtab_hdr;
-	Elf32_Sym *symtab;
-	const char *shstrtab, *strtab;
-	uint16_t section_count;
-	uint32_t symbol_count;
-
-	dlmap = (struct link_map *) m_ulModule;
-	symtab_hdr = NULL;
-	strtab_hdr = NULL;
-
-	dlfile = open(dlmap->l_name, O_RDONLY);
-	if (dlfile == -1 || fstat(dlfile, &dlstat) == -1)
-	{
-		close(dlfile);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to open file.")
-	}
-
-	/* Map library file into memory */
-	file_hdr = (Elf32_Ehdr *)mmap(NULL, dlstat.st_size, PROT_READ, MAP_PRIVATE, dlfile, 0);
-	map_base = (uintptr_t)file_hdr;
-	close(dlfile);
-	if (file_hdr == MAP_FAILED)
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Failed to map file.")
-
-	if (file_hdr->e_shoff == 0 || file_hdr->e_shstrndx == SHN_UNDEF)
-	{
-		munmap(file_hdr, dlstat.st_size);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "No section header string table has been found.")
-	}
-
-	sections = (Elf32_Shdr *)(map_base + file_hdr->e_shoff);
-	section_count = file_hdr->e_shnum;
-	/* Get ELF section header string table */
-	shstrtab_hdr = &sections[file_hdr->e_shstrndx];
-	shstrtab = (const char *)(map_base + shstrtab_hdr->sh_offset);
-
-	/* Iterate sections while looking for ELF symbol table and string table */
-	for (uint16_t i = 0; i < section_count; i++)
-	{
-		Elf32_Shdr &hdr = sections[i];
-		const char *section_name = shstrtab + hdr.sh_name;
-
-		if (strcmp(section_name, ".symtab") == 0)
-			symtab_hdr = &hdr;
-
-		else if (strcmp(section_name, ".strtab") == 0)
-			strtab_hdr = &hdr;
-	}
-
-	/* Uh oh, we don't have a symbol table or a string table */
-	if (symtab_hdr == NULL || strtab_hdr == NULL)
-	{
-		munmap(file_hdr, dlstat.st_size);
-		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "No symbol table or string table found.")
-	}
-
-	symtab = (Elf32_Sym *)(map_base + symtab_hdr->sh_offset);
-	strtab = (const char *)(map_base + strtab_hdr->sh_offset);
-	symbol_count = symtab_hdr->sh_size / symtab_hdr->sh_entsize;
-
-	/* Iterate symbol table starting from the position we were at last time */
-	for (uint32_t i = 0; i < symbol_count; i++)
-	{
-		Elf32_Sym &sym = symtab[i];
-		unsigned char sym_type = ELF32_ST_TYPE(sym.st_info);
-		const char *sym_name = strtab + sym.st_name;
-
-		/* Skip symbols that are undefined or do not refer to functions or objects */
-		if (sym.st_shndx == SHN_UNDEF || (sym_type != STT_FUNC && sym_type != STT_OBJECT))
-			continue;
+	if (!LoadSymbolTable())
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "%s", m_szSymbolTableError)
 
-		result[sym_name] = CPointer((unsigned long)(dlmap->l_addr + sym.st_value));
-	}
+	for (AddressCache_t::const_iterator it = m_SymbolTable.begin(); it != m_SymbolTable.end(); ++it)
+		result[it->first] = CPointer(it->second);
 
-	// Unmap the file now.
-	munmap(file_hdr, dlstat.st_size);
+	for (AddressCache_t::const_iterator it = m_DuplicateSymbols.begin(); it != m_DuplicateSymbols.end(); ++it)
+		result[it->first] = CPointer(it->second);
 #else
 	#error Unsupported platform.
 #endif
@@ -600,10 +1315,17 @@ CBinaryFile* CBinaryManager::FindBinary(char* szPath, bool bSrvCheck /* = true *
 
 	// Create a new Binary object and add it to the list
 	CBinaryFile* binary = new CBinaryFile(ulModule, ulBase, ulSize);
+	binary->LoadCacheFile();
 	m_Binaries.push_front(binary);
 	return binary;
 }
 
+void CBinaryManager::FlushCacheFiles()
+{
+	for (std::list<CBinaryFile *>::iterator iter=m_Binaries.begin(); iter != m_Binaries.end(); ++iter)
+		(*iter)->FlushCacheFile();
+}
+
 //-----------------------------------------------------------------------------
 // Functions
 //-----------------------------------------------------------------------------
@@ -611,3 +1333,8 @@ CBinaryFile* FindBinary(char* szPath, bool bSrvCheck /* = true */, bool bCheckEx
 {
 	return s_pBinaryManager->FindBinary(szPath, bSrvCheck, bCheckExtension);
 }
+
+void FlushBinaryCaches()
+{
+	s_pBinaryManager->FlushCacheFiles();
+}
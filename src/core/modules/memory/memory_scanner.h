@@ -31,13 +31,27 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <list>
+#include <string>
+#include <vector>
 #include "export_main.h"
 #include "memory_pointer.h"
 
-struct Signature_t
+// Boost
+#include "boost/unordered_map.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+// Maps a signature (raw bytes) or symbol name to its address
+typedef boost::unordered_map<std::string, unsigned long> AddressCache_t;
+
+// An address that has not been written to the cache file yet
+struct CacheEntry_t
 {
-	unsigned char* m_szSignature;
-	unsigned long  m_ulAddr;
+	char m_cType;
+	std::string m_Key;
+	unsigned int m_uiRVA;
 };
 
 
@@ -49,24 +63,61 @@ public:
 	CPointer* FindSignatureRaw(object oSignature);
 
 	CPointer* FindSignature(object oSignature);
+	list FindSignatures(object oSignatures);
 	CPointer* FindSymbol(char* szSymbol);
+	list FindSymbols(object oSymbols);
 	CPointer* FindPointer(object oIdentifier, int iOffset, unsigned int iLevel);
 	CPointer* FindAddress(object oIdentifier);
 
 	dict GetSymbols();
 
+	void LoadCacheFile();
+
+	// Appends all pending entries to the cache file at once
+	void FlushCacheFile();
+
 private:
-	void AddSignatureToCache(unsigned char* sigstr, int iLength, unsigned int ulAddr);
+	void AddSignatureToCache(unsigned char* sigstr, int iLength, unsigned long ulAddr);
+	void AddSymbolToCache(const char* szSymbol, unsigned long ulAddr);
+	void QueueCacheEntry(char cType, const std::string& key, unsigned long ulAddr);
 
-	bool SearchSigInCache(unsigned char* sigstr, CPointer*& result);
+	bool SearchSigInCache(unsigned char* sigstr, int iLength, CPointer*& result);
 	bool SearchSigInBinary(object oSignature, int iLength, unsigned char* sigstr, CPointer*& result);
 	bool SearchSigHooked(object oSignature, int iLength, unsigned char* sigstr, CPointer*& result);
 
+	// Returns the address of the symbol or 0 if it wasn't found
+	unsigned long ResolveSymbol(const char* szSymbol);
+
+#ifdef __linux__
+	unsigned long FindDynamicSymbol(const char* szSymbol);
+	// Returns false if the binary has no usable .symtab section
+	bool LoadSymbolTable();
+#endif
+
 public:
 	unsigned long			m_ulModule;
 	unsigned long			m_ulBase;
 	unsigned long			m_ulSize;
-	std::list<Signature_t>	m_Signatures;
+	AddressCache_t			m_Signatures;
+	AddressCache_t			m_Symbols;
+
+	// Path of the persistent cache file or empty if it's disabled
+	std::string				m_szCacheFile;
+	std::vector<CacheEntry_t>	m_vecPendingEntries;
+
+	// Functions and objects of the .symtab section (Linux only)
+	AddressCache_t			m_SymbolTable;
+
+	// Last definition of names that are defined more than once
+	AddressCache_t			m_DuplicateSymbols;
+	bool					m_bSymbolTableLoaded;
+	const char*				m_szSymbolTableError;
+
+	// Loaded .gnu.hash, .dynsym and .dynstr sections (Linux only)
+	bool					m_bDynamicTableLoaded;
+	unsigned long			m_ulGnuHash;
+	unsigned long			m_ulDynSym;
+	unsigned long			m_ulDynStr;
 };
 
 
@@ -74,6 +125,7 @@ class CBinaryManager
 {
 public:
 	CBinaryFile* FindBinary(char* szPath, bool bSrvCheck = true, bool bCheckExtension = true);
+	void FlushCacheFiles();
 
 private:
 	std::list<CBinaryFile*> m_Binaries;
@@ -82,5 +134,6 @@ private:
 static CBinaryManager* s_pBinaryManager = new CBinaryManager();
 
 CBinaryFile* FindBinary(char* szPath, bool bSrvCheck = true, bool bCheckExtension = true);
+void FlushBinaryCaches();
 
 #endif // _MEMORY_SCANNER_H
@@ -37,6 +37,7 @@
 #include "memory_utilities.h"
 #include "memory_wrap.h"
 #include "memory_rtti.h"
+#include "memory_field.h"
 
 // DynamicHooks
 #include "registers.h"
@@ -53,6 +54,7 @@ void export_function(scope);
 void export_data_type_t(scope);
 void export_convention_t(scope);
 void export_hook_type_t(scope);
+void export_hook_filter(scope);
 void export_stack_data(scope);
 void export_register_t(scope);
 void export_register(scope);
@@ -61,6 +63,7 @@ void export_calling_convention(scope);
 void export_functions(scope);
 void export_global_variables(scope);
 void export_protection(scope);
+void export_field_descriptor(scope);
 
 
 // ============================================================================
@@ -79,6 +82,7 @@ DECLARE_SP_MODULE(_memory)
 	export_data_type_t(_memory);
 	export_convention_t(_memory);
 	export_hook_type_t(_memory);
+	export_hook_filter(_memory);
 	export_stack_data(_memory);
 	export_register_t(_memory);
 	export_register(_memory);
@@ -87,6 +91,7 @@ DECLARE_SP_MODULE(_memory)
 	export_functions(_memory);
 	export_global_variables(_memory);
 	export_protection(_memory);
+	export_field_descriptor(_memory);
 }
 
 
@@ -129,6 +134,20 @@ void export_binary_file(scope _memory)
 			manage_new_object_policy()
 		)
 
+		.def("find_signatures",
+			&CBinaryFile::FindSignatures,
+			"Searches for all given signatures in a single pass and returns a list of their addresses. "\
+			"Signatures that could not be found result in a NULL pointer.",
+			args("signatures")
+		)
+
+		.def("find_symbols",
+			&CBinaryFile::FindSymbols,
+			"Resolves all given symbols and returns a list of their addresses. "\
+			"Symbols that could not be found result in a NULL pointer.",
+			args("symbols")
+		)
+
 		// Special methods
 		.def("__getitem__",
 			&CBinaryFile::FindAddress,
@@ -461,6 +480,12 @@ void export_function(scope _memory)
 			"Calls the function dynamically."
 		)
 
+		.def("call_many",
+			&CFunction::CallMany,
+			"Calls the function once for each argument sequence of the given iterable and returns a list of the results.",
+			args("arguments")
+		)
+
 		.def("is_callable",
 			&CFunction::IsCallable,
 			"Return True if the function is callable."
@@ -487,9 +512,17 @@ void export_function(scope _memory)
 		)
 
 		.def("add_hook",
-			GET_METHOD(void, CFunction, AddHook, HookType_t eType, PyObject*),
-			"Adds a hook callback.",
-			args("hook_type", "callback")
+			GET_METHOD(void, CFunction, AddHook, HookType_t eType, PyObject*, object),
+			"Adds a hook callback.\n"
+			"\n"
+			":param HookType hook_type:\n"
+			"	The type of the hook.\n"
+			":param callable callback:\n"
+			"	The callback to add.\n"
+			":param HookFilter filter:\n"
+			"	An optional native filter. The callback is only called if the\n"
+			"	filter accepts the current call.",
+			(arg("hook_type"), arg("callback"), arg("filter")=object())
 		)
 
 		.def("remove_hook",
@@ -606,6 +639,19 @@ void export_hook_type_t(scope _memory)
 }
 
 
+// ============================================================================
+// >> IHookFilter
+// ============================================================================
+void export_hook_filter(scope _memory)
+{
+	class_<IHookFilter, boost::noncopyable>(
+		"HookFilter",
+		"Base class of native hook filters. See :meth:`Function.add_hook`.",
+		no_init
+	);
+}
+
+
 // ============================================================================
 // >> CStackData
 // ============================================================================
@@ -1068,3 +1114,69 @@ void export_protection(scope _memory)
 	Protection.value("EXECUTE_READ", PROTECTION_EXECUTE_READ);
 	Protection.value("EXECUTE_READ_WRITE", PROTECTION_EXECUTE_READ_WRITE);
 }
+
+
+// ============================================================================
+// >> CFieldDescriptor
+// ============================================================================
+void export_field_descriptor(scope _memory)
+{
+	class_<CFieldDescriptor, boost::noncopyable> FieldDescriptor(
+		"FieldDescriptor",
+		"Descriptor that loads and stores a field of a Pointer instance.",
+		init<int, optional<object, object, object, bool> >(
+			(arg("offset"), arg("data_type")=object(), arg("converter")=object(),
+				arg("setter")=object(), arg("indirect")=false),
+			"Initialize the descriptor.\n\n"
+			":param int offset:\n"
+			"    The offset of the field.\n"
+			":param DataType data_type:\n"
+			"    The type of the field. If given, the value is loaded and stored\n"
+			"    directly.\n"
+			":param converter:\n"
+			"    Called with a Pointer to the field if no data type was given.\n"
+			":param setter:\n"
+			"    Called with the instance and the new value if the field can't be\n"
+			"    stored directly.\n"
+			":param bool indirect:\n"
+			"    Whether or not the field stores a pointer to the value."
+		)
+	);
+
+	FieldDescriptor.def(
+		"__get__",
+		&CFieldDescriptor::__get__,
+		"Return the value of the field."
+	);
+
+	FieldDescriptor.def(
+		"__set__",
+		&CFieldDescriptor::__set__,
+		"Set the value of the field."
+	);
+
+	FieldDescriptor.def_readonly(
+		"offset",
+		&CFieldDescriptor::m_iOffset
+	);
+
+	FieldDescriptor.def_readonly(
+		"indirect",
+		&CFieldDescriptor::m_bIndirect
+	);
+
+	FieldDescriptor.def_readonly(
+		"data_type",
+		&CFieldDescriptor::m_oDataType
+	);
+
+	FieldDescriptor.def_readonly(
+		"converter",
+		&CFieldDescriptor::m_oConverter
+	);
+
+	FieldDescriptor.def_readonly(
+		"setter",
+		&CFieldDescriptor::m_oSetter
+	);
+}
@@ -32,6 +32,11 @@
 #include "eiface.h"
 #include "sp_main.h"
 
+#ifdef USE_PROTOBUF
+	#include "utilities/string_map.h"
+	#include "boost/unordered/unordered_flat_map.hpp"
+#endif
+
 
 //-----------------------------------------------------------------------------
 // Externals.
@@ -41,6 +46,159 @@ extern CSourcePython g_SourcePythonPlugin;
 extern IServerGameDLL *servergamedll;
 
 
+//-----------------------------------------------------------------------------
+// CProtobufMessageExt.
+//-----------------------------------------------------------------------------
+#ifdef USE_PROTOBUF
+typedef StringMap_t<const google::protobuf::FieldDescriptor*> FieldDescriptorMap_t;
+typedef boost::unordered_flat_map<const google::protobuf::Descriptor*, FieldDescriptorMap_t> MessageFieldsMap_t;
+
+const google::protobuf::FieldDescriptor* CProtobufMessageExt::FindFieldDescriptor(const google::protobuf::Descriptor* descriptor, const char* field_name)
+{
+	static MessageFieldsMap_t s_mapMessageFields;
+
+	MessageFieldsMap_t::iterator message_it = s_mapMessageFields.find(descriptor);
+	if (message_it == s_mapMessageFields.end())
+	{
+		// For some reasons, FindFieldByName is causing a crash if the message has been initialized
+		//	by the server so let's look it up ourself...
+		FieldDescriptorMap_t fields;
+		for (int iCurrentIndex=0; iCurrentIndex < descriptor->field_count(); iCurrentIndex++)
+		{
+			const google::protobuf::FieldDescriptor *field_descriptor = descriptor->field(iCurrentIndex);
+			if (field_descriptor)
+				fields.emplace(field_descriptor->name(), field_descriptor);
+		}
+
+		message_it = s_mapMessageFields.emplace(descriptor, fields).first;
+	}
+
+	FieldDescriptorMap_t::iterator field_it = message_it->second.find(field_name);
+	if (field_it == message_it->second.end())
+		return NULL;
+
+	return field_it->second;
+}
+
+static const google::protobuf::EnumValueDescriptor* GetEnumValue(const google::protobuf::FieldDescriptor* field, int value)
+{
+	const google::protobuf::EnumValueDescriptor* enum_value = field->enum_type()->FindValueByNumber(value);
+	if (!enum_value) {
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Unable to find enum value '%i'.", value);
+	}
+	return enum_value;
+}
+
+void CProtobufMessageExt::Update(google::protobuf::Message* pMessage, object values)
+{
+	// Field names to values
+	if (PyDict_Check(values.ptr()))
+	{
+		PyObject *key, *value;
+		Py_ssize_t pos = 0;
+		while (PyDict_Next(values.ptr(), &pos, &key, &value))
+		{
+			const char* field_name = extract<const char*>(key);
+			SetValue(pMessage, GetFieldDescriptor(pMessage, field_name), object(handle<>(borrowed(value))));
+		}
+		return;
+	}
+
+	// Values in the order the fields are declared
+	const google::protobuf::Descriptor* descriptor = pMessage->GetDescriptor();
+	int iCount = len(values);
+	if (iCount > descriptor->field_count()) {
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Got %i values, but '%s' has only %i fields.",
+			iCount, descriptor->name().c_str(), descriptor->field_count());
+	}
+
+	for (int i=0; i < iCount; i++)
+	{
+		object value = values[i];
+		if (!value.is_none())
+			SetValue(pMessage, descriptor->field(i), value);
+	}
+}
+
+void CProtobufMessageExt::SetValue(google::protobuf::Message* pMessage, const google::protobuf::FieldDescriptor* field, object value)
+{
+	const google::protobuf::Reflection* reflection = pMessage->GetReflection();
+
+	// Repeated fields are replaced by the given sequence
+	if (field->is_repeated())
+	{
+		reflection->ClearField(pMessage, field);
+
+		handle<> iterator(PyObject_GetIter(value.ptr()));
+		while (PyObject* item = PyIter_Next(iterator.get()))
+			AddValue(pMessage, field, object(handle<>(item)));
+
+		if (PyErr_Occurred())
+			throw_error_already_set();
+
+		return;
+	}
+
+	switch (field->cpp_type())
+	{
+		case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+			reflection->SetInt32(pMessage, field, extract<int32>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+			reflection->SetInt64(pMessage, field, extract<int64>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+			reflection->SetUInt32(pMessage, field, extract<uint32>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+			reflection->SetUInt64(pMessage, field, extract<uint64>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+			reflection->SetFloat(pMessage, field, extract<float>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+			reflection->SetDouble(pMessage, field, extract<double>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+			reflection->SetBool(pMessage, field, extract<bool>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+			reflection->SetString(pMessage, field, std::string(extract<const char*>(value)())); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+			reflection->SetEnum(pMessage, field, GetEnumValue(field, extract<int>(value))); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+			Update(reflection->MutableMessage(pMessage, field), value); break;
+		default:
+			BOOST_RAISE_EXCEPTION(PyExc_NotImplementedError, "Unsupported type of field '%s'.", field->name().c_str());
+	}
+}
+
+void CProtobufMessageExt::AddValue(google::protobuf::Message* pMessage, const google::protobuf::FieldDescriptor* field, object value)
+{
+	const google::protobuf::Reflection* reflection = pMessage->GetReflection();
+
+	switch (field->cpp_type())
+	{
+		case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+			reflection->AddInt32(pMessage, field, extract<int32>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+			reflection->AddInt64(pMessage, field, extract<int64>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+			reflection->AddUInt32(pMessage, field, extract<uint32>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+			reflection->AddUInt64(pMessage, field, extract<uint64>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+			reflection->AddFloat(pMessage, field, extract<float>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+			reflection->AddDouble(pMessage, field, extract<double>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+			reflection->AddBool(pMessage, field, extract<bool>(value)); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+			reflection->AddString(pMessage, field, std::string(extract<const char*>(value)())); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+			reflection->AddEnum(pMessage, field, GetEnumValue(field, extract<int>(value))); break;
+		case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+			Update(reflection->AddMessage(pMessage, field), value); break;
+		default:
+			BOOST_RAISE_EXCEPTION(PyExc_NotImplementedError, "Unsupported type of field '%s'.", field->name().c_str());
+	}
+}
+#endif
+
+
 //-----------------------------------------------------------------------------
 // CUserMessage.
 //-----------------------------------------------------------------------------
@@ -105,20 +105,15 @@
 
 		static const google::protobuf::FieldDescriptor* GetFieldDescriptor(google::protobuf::Message* pMessage, const char* field_name)
 		{
-			const google::protobuf::Descriptor* descriptor = pMessage->GetDescriptor();
-
-			// For some reasons, FindFieldByName is causing a crash if the message has been initialized
-			//	by the server so let's look it up ourself...
-			for (int iCurrentIndex=0; iCurrentIndex < descriptor->field_count(); iCurrentIndex++)
-			{
-				const google::protobuf::FieldDescriptor *field_descriptor = descriptor->field(iCurrentIndex);
-				if (field_descriptor && strcmp(field_descriptor->name().c_str(), field_name) == 0)
-					return field_descriptor;
+			const google::protobuf::FieldDescriptor* field_descriptor = FindFieldDescriptor(pMessage->GetDescriptor(), field_name);
+			if (!field_descriptor) {
+				BOOST_RAISE_EXCEPTION(PyExc_NameError, "Unable to find field '%s'.", field_name);
 			}
-
-			BOOST_RAISE_EXCEPTION(PyExc_NameError, "Unable to find field '%s'.", field_name);
-			return NULL;
+			return field_descriptor;
 		}
+
+		// Fields are resolved once per message type and cached afterwards.
+		static const google::protobuf::FieldDescriptor* FindFieldDescriptor(const google::protobuf::Descriptor* descriptor, const char* field_name);
 	
 		static const google::protobuf::EnumValueDescriptor* GetEnumValueDescriptor(google::protobuf::Message* pMessage, const char* field_name, int value)
 		{
@@ -197,7 +192,7 @@
 				BOOST_RAISE_EXCEPTION(PyExc_IndexError, "Index (%d) out of range.", index)
 			}
 
-			return (*pMessage->GetReflection().*get_repeated_field_delegate)(*pMessage, GetFieldDescriptor(pMessage, field_name), index);
+			return (*pMessage->GetReflection().*get_repeated_field_delegate)(*pMessage, descriptor, index);
 		}
 
 		static int32 GetRepeatedInt32(google::protobuf::Message* pMessage, const char* field_name, int index)
@@ -368,6 +363,18 @@
 
 		static google::protobuf::Message* AddMessage(google::protobuf::Message* pMessage, const char* field_name)
 		{ return pMessage->GetReflection()->AddMessage(pMessage, GetFieldDescriptor(pMessage, field_name)); }
+
+
+		// ====================================================================
+		// >> Bulk access
+		// ====================================================================
+		// Sets all given fields in one call. Accepts a dict that maps field
+		// names to values or a sequence of values in the order the fields
+		// are declared (None skips a field).
+		static void Update(google::protobuf::Message* pMessage, object values);
+
+		static void SetValue(google::protobuf::Message* pMessage, const google::protobuf::FieldDescriptor* field, object value);
+		static void AddValue(google::protobuf::Message* pMessage, const google::protobuf::FieldDescriptor* field, object value);
 	};
 #endif
 
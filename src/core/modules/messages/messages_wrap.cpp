@@ -206,6 +206,17 @@ void export_protobuf_message(scope _messages)
 		&google::protobuf::Message::Clear,
 		"Clear the message.");
 
+	ProtobufMessage.def(
+		"update",
+		&CProtobufMessageExt::Update,
+		"Set multiple fields at once.\n\n"
+		":param values:\n"
+		"	Either a dict that maps field names to values or a sequence of values in the "
+		"order the fields are declared. ``None`` skips a field in a sequence. Repeated "
+		"fields are replaced by the given sequence and nested messages are updated with "
+		"the given dict or sequence.",
+		args("self", "values"));
+
 	ProtobufMessage.add_property("name", &google::protobuf::Message::GetTypeName);
 	ProtobufMessage.add_property("debug_string", &google::protobuf::Message::DebugString);
 	ProtobufMessage.add_property("byte_size", &google::protobuf::Message::ByteSize);
@@ -32,6 +32,92 @@
 #include "edict.h"
 #include "boost/python/iterator.hpp"
 #include "utilities/conversions.h"
+#include "players_entity.h"
+#include "public/game/server/iplayerinfo.h"
+
+
+//-----------------------------------------------------------------------------
+// External variables.
+//-----------------------------------------------------------------------------
+extern IPlayerInfoManager* playerinfomanager;
+
+
+//-----------------------------------------------------------------------------
+// CPlayerFilter Constructor.
+//-----------------------------------------------------------------------------
+CPlayerFilter::CPlayerFilter(unsigned int uiIsFlags, unsigned int uiNotFlags,
+		unsigned int uiIsTeams, unsigned int uiNotTeams):
+	m_uiIsFlags(uiIsFlags),
+	m_uiNotFlags(uiNotFlags),
+	m_uiIsTeams(uiIsTeams),
+	m_uiNotTeams(uiNotTeams)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// Returns whether the given player passes the filters.
+//-----------------------------------------------------------------------------
+bool CPlayerFilter::IsMatch(edict_t* pEdict) const
+{
+	unsigned int uiFlags = PLAYER_FILTER_ALL;
+	unsigned int uiUsed = m_uiIsFlags | m_uiNotFlags;
+
+	// Only look up what the filters actually ask for
+	IPlayerInfo* pPlayerInfo = NULL;
+	if ((uiUsed & (PLAYER_FILTER_BOT | PLAYER_FILTER_HUMAN)) || m_uiIsTeams || m_uiNotTeams)
+	{
+		pPlayerInfo = playerinfomanager->GetPlayerInfo(pEdict);
+		if (!pPlayerInfo)
+			return false;
+
+		if (pPlayerInfo->IsFakeClient() || strcmp(pPlayerInfo->GetNetworkIDString(), "BOT") == 0)
+			uiFlags |= PLAYER_FILTER_BOT;
+		else
+			uiFlags |= PLAYER_FILTER_HUMAN;
+	}
+
+	if (uiUsed & (PLAYER_FILTER_ALIVE | PLAYER_FILTER_DEAD))
+	{
+		CBaseEntity* pEntity;
+		if (!BaseEntityFromEdict(pEdict, pEntity))
+			return false;
+
+		if (((PlayerMixin *) pEntity)->GetDead())
+			uiFlags |= PLAYER_FILTER_DEAD;
+		else
+			uiFlags |= PLAYER_FILTER_ALIVE;
+	}
+
+	if ((m_uiIsFlags & ~uiFlags) || (m_uiNotFlags & uiFlags))
+		return false;
+
+	if (pPlayerInfo)
+	{
+		int iTeam = pPlayerInfo->GetTeamIndex();
+		unsigned int uiTeam = (iTeam >= 0 && iTeam < 32) ? (1u << iTeam) : 0;
+		if ((m_uiIsTeams & ~uiTeam) || (m_uiNotTeams & uiTeam))
+			return false;
+	}
+
+	return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Returns the number of players passing the filters.
+//-----------------------------------------------------------------------------
+unsigned int CPlayerFilter::Count() const
+{
+	unsigned int uiCount = 0;
+	for (int iEntityIndex=1; iEntityIndex <= gpGlobals->maxClients; iEntityIndex++)
+	{
+		edict_t* pEdict;
+		if (EdictFromIndex(iEntityIndex, pEdict) && IsMatch(pEdict))
+			uiCount++;
+	}
+	return uiCount;
+}
 
 
 //-----------------------------------------------------------------------------
@@ -49,7 +135,19 @@ CPlayerGenerator::CPlayerGenerator( PyObject* self ):
 //-----------------------------------------------------------------------------
 CPlayerGenerator::CPlayerGenerator( PyObject* self, const CPlayerGenerator& rhs ):
 	IPythonGenerator<edict_t>(self),
-	m_iEntityIndex(rhs.m_iEntityIndex)
+	m_iEntityIndex(rhs.m_iEntityIndex),
+	m_Filter(rhs.m_Filter)
+{
+}
+
+
+//-----------------------------------------------------------------------------
+// CPlayerGenerator Constructor that only yields players passing the filters.
+//-----------------------------------------------------------------------------
+CPlayerGenerator::CPlayerGenerator( PyObject* self, const CPlayerFilter& filter ):
+	IPythonGenerator<edict_t>(self),
+	m_iEntityIndex(0),
+	m_Filter(filter)
 {
 }
 
@@ -67,12 +165,12 @@ CPlayerGenerator::~CPlayerGenerator()
 //-----------------------------------------------------------------------------
 edict_t *CPlayerGenerator::getNext()
 {
-	edict_t* pEdict = NULL;
+	edict_t* pEdict;
 	while(m_iEntityIndex < gpGlobals->maxClients)
 	{
 		m_iEntityIndex++;
-		if (EdictFromIndex(m_iEntityIndex, pEdict))
-			break;
+		if (EdictFromIndex(m_iEntityIndex, pEdict) && m_Filter.IsMatch(pEdict))
+			return pEdict;
 	}
-	return pEdict;
+	return NULL;
 }
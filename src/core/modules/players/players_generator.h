@@ -35,6 +35,42 @@
 #include "edict.h"
 
 
+//-----------------------------------------------------------------------------
+// Built-in player filters.
+//-----------------------------------------------------------------------------
+enum EPlayerFilter
+{
+	PLAYER_FILTER_ALL = (1 << 0),
+	PLAYER_FILTER_BOT = (1 << 1),
+	PLAYER_FILTER_HUMAN = (1 << 2),
+	PLAYER_FILTER_ALIVE = (1 << 3),
+	PLAYER_FILTER_DEAD = (1 << 4)
+};
+
+
+//-----------------------------------------------------------------------------
+// Combines the built-in filters into bitmasks that are tested in one pass.
+// A player matches if it passes all "is" filters and none of the "not" ones.
+//-----------------------------------------------------------------------------
+class CPlayerFilter
+{
+public:
+	CPlayerFilter(unsigned int uiIsFlags=0, unsigned int uiNotFlags=0,
+		unsigned int uiIsTeams=0, unsigned int uiNotTeams=0);
+
+	bool IsMatch(edict_t* pEdict) const;
+	unsigned int Count() const;
+
+public:
+	unsigned int m_uiIsFlags;
+	unsigned int m_uiNotFlags;
+
+	// One bit per team number
+	unsigned int m_uiIsTeams;
+	unsigned int m_uiNotTeams;
+};
+
+
 //-----------------------------------------------------------------------------
 // Declare the generator class.
 //-----------------------------------------------------------------------------
@@ -43,6 +79,7 @@ class CPlayerGenerator: public IPythonGenerator<edict_t>
 public:
 	CPlayerGenerator(PyObject* self);
 	CPlayerGenerator(PyObject* self, const CPlayerGenerator& rhs);
+	CPlayerGenerator(PyObject* self, const CPlayerFilter& filter);
 	virtual ~CPlayerGenerator();
 
 protected:
@@ -50,6 +87,7 @@ protected:
 
 private:
 	int m_iEntityIndex;
+	CPlayerFilter m_Filter;
 };
 
 BOOST_SPECIALIZE_HAS_BACK_REFERENCE(CPlayerGenerator)
@@ -30,18 +30,300 @@
 #include "ivoiceserver.h"
 #include "export_main.h"
 #include "modules/memory/memory_utilities.h"
+#include "modules/memory/memory_function_info.h"
+#include "players_voice.h"
 
 
 //-----------------------------------------------------------------------------
 // Externals
 //-----------------------------------------------------------------------------
 extern IVoiceServer* voiceserver;
+extern CGlobalVars* gpGlobals;
+
+
+//-----------------------------------------------------------------------------
+// Helper functions.
+//-----------------------------------------------------------------------------
+inline void OrMask(VoiceMask_t &vecMask, const VoiceMask_t &vecOther)
+{
+	uint32 *pDest = vecMask.Base();
+	const uint32 *pOther = vecOther.Base();
+	for (int i=0; i < vecMask.GetNumDWords(); i++) {
+		pDest[i] |= pOther[i];
+	}
+}
+
+inline void AndNotMask(VoiceMask_t &vecMask, const VoiceMask_t &vecOther)
+{
+	uint32 *pDest = vecMask.Base();
+	const uint32 *pOther = vecOther.Base();
+	for (int i=0; i < vecMask.GetNumDWords(); i++) {
+		pDest[i] &= ~pOther[i];
+	}
+}
+
+// Returns whether all bits of the other mask are set in the given mask.
+inline bool ContainsMask(const VoiceMask_t &vecMask, const VoiceMask_t &vecOther)
+{
+	const uint32 *pMask = vecMask.Base();
+	const uint32 *pOther = vecOther.Base();
+	for (int i=0; i < vecMask.GetNumDWords(); i++) {
+		if (pOther[i] & ~pMask[i])
+			return false;
+	}
+
+	return true;
+}
+
+static void AddPlayer(VoiceMask_t &vecPlayers, object oIndex)
+{
+	unsigned int uiIndex = extract<unsigned int>(oIndex);
+	if (!uiIndex || uiIndex > (unsigned int) gpGlobals->maxClients || uiIndex > ABSOLUTE_PLAYER_LIMIT)
+		BOOST_RAISE_EXCEPTION(PyExc_ValueError, "Invalid player index: %u", uiIndex)
+
+	vecPlayers.Set((int) uiIndex);
+}
+
+// Converts None (all players), a player index or an iterable of player
+// indexes into a mask.
+static void ExtractPlayers(object oIndexes, VoiceMask_t &vecPlayers)
+{
+	vecPlayers.ClearAll();
+
+	if (oIndexes.is_none())
+	{
+		for (int i=1; i <= gpGlobals->maxClients && i <= ABSOLUTE_PLAYER_LIMIT; i++)
+			vecPlayers.Set(i);
+
+		return;
+	}
+
+	if (extract<unsigned int>(oIndexes).check())
+	{
+		AddPlayer(vecPlayers, oIndexes);
+		return;
+	}
+
+	object oIterator = object(handle<>(PyObject_GetIter(oIndexes.ptr())));
+	while (PyObject *pItem = PyIter_Next(oIterator.ptr()))
+	{
+		AddPlayer(vecPlayers, object(handle<>(pItem)));
+	}
+
+	if (PyErr_Occurred())
+		throw_error_already_set();
+}
+
+
+//-----------------------------------------------------------------------------
+// CVoiceRouter class.
+//-----------------------------------------------------------------------------
+CVoiceRouter::CVoiceRouter():
+	m_bInitialized(false),
+	m_pHook(NULL)
+{
+	m_pListeningHooks = new CListenerManager();
+}
+
+CVoiceRouter::~CVoiceRouter()
+{
+	delete m_pListeningHooks;
+}
+
+void CVoiceRouter::Initialize()
+{
+	if (m_bInitialized)
+		return;
+
+	CFunctionInfo *pInfo = GetFunctionInfo(&IVoiceServer::SetClientListening);
+	if (!pInfo)
+		BOOST_RAISE_EXCEPTION(
+			PyExc_ValueError,
+			"Failed to retrieve SetClientListening's info."
+		)
+
+	CFunction *pFunc = CPointer((unsigned long)((void *)voiceserver)).MakeVirtualFunction(*pInfo);
+	delete pInfo;
+
+	if (!pFunc || !pFunc->IsHookable())
+		BOOST_RAISE_EXCEPTION(
+			PyExc_ValueError,
+			"SetClientListening is invalid or not hookable."
+		)
+
+	void *pAddr = (void *)pFunc->m_ulAddr;
+	m_pHook = FindHook(pAddr);
+	if (!m_pHook)
+	{
+		m_pHook = HookFunction(pAddr, pFunc->m_pCallingConvention);
+		if (!m_pHook) {
+			delete pFunc;
+			BOOST_RAISE_EXCEPTION(
+				PyExc_ValueError,
+				"Failed to hook SetClientListening."
+			)
+		}
+	}
+
+	delete pFunc;
+	m_pHook->AddCallback(
+		HOOKTYPE_PRE,
+		(HookHandlerFn *)&CVoiceRouter::SetClientListening
+	);
+
+	m_bInitialized = true;
+}
+
+void CVoiceRouter::SetRoutes(VoiceMask_t *pMatrix, object oSenders, object oReceivers, bool bState)
+{
+	VoiceMask_t vecSenders;
+	ExtractPlayers(oSenders, vecSenders);
+
+	VoiceMask_t vecReceivers;
+	ExtractPlayers(oReceivers, vecReceivers);
+
+	// Routes are only consulted once the hook is installed
+	if (bState)
+		Initialize();
+
+	for (int i=1; i <= ABSOLUTE_PLAYER_LIMIT; i++)
+	{
+		if (!vecReceivers.IsBitSet(i))
+			continue;
+
+		if (bState)
+			OrMask(pMatrix[i], vecSenders);
+		else
+			AndNotMask(pMatrix[i], vecSenders);
+	}
+}
+
+bool CVoiceRouter::TestRoutes(VoiceMask_t *pMatrix, object oSenders, object oReceivers)
+{
+	VoiceMask_t vecSenders;
+	ExtractPlayers(oSenders, vecSenders);
+
+	VoiceMask_t vecReceivers;
+	ExtractPlayers(oReceivers, vecReceivers);
+
+	for (int i=1; i <= ABSOLUTE_PLAYER_LIMIT; i++)
+	{
+		if (vecReceivers.IsBitSet(i) && !ContainsMask(pMatrix[i], vecSenders))
+			return false;
+	}
+
+	return true;
+}
+
+void CVoiceRouter::Mute(object oSenders, object oReceivers)
+{
+	SetRoutes(m_vecMuted, oSenders, oReceivers, true);
+}
+
+void CVoiceRouter::Unmute(object oSenders, object oReceivers)
+{
+	SetRoutes(m_vecMuted, oSenders, oReceivers, false);
+}
+
+bool CVoiceRouter::IsMuted(object oSenders, object oReceivers)
+{
+	return TestRoutes(m_vecMuted, oSenders, oReceivers);
+}
+
+void CVoiceRouter::Forward(object oSenders, object oReceivers)
+{
+	SetRoutes(m_vecForwarded, oSenders, oReceivers, true);
+}
+
+void CVoiceRouter::Unforward(object oSenders, object oReceivers)
+{
+	SetRoutes(m_vecForwarded, oSenders, oReceivers, false);
+}
+
+bool CVoiceRouter::IsForwarded(object oSenders, object oReceivers)
+{
+	return TestRoutes(m_vecForwarded, oSenders, oReceivers);
+}
+
+void CVoiceRouter::Clear()
+{
+	for (int i=0; i <= ABSOLUTE_PLAYER_LIMIT; i++)
+	{
+		m_vecMuted[i].ClearAll();
+		m_vecForwarded[i].ClearAll();
+	}
+}
+
+void CVoiceRouter::RegisterHook(object oCallback)
+{
+	Initialize();
+	m_pListeningHooks->RegisterListener(oCallback.ptr());
+}
+
+void CVoiceRouter::UnregisterHook(object oCallback)
+{
+	m_pListeningHooks->UnregisterListener(oCallback.ptr());
+}
+
+void CVoiceRouter::OnClientDisconnect(unsigned int uiIndex)
+{
+	if (!uiIndex || uiIndex > ABSOLUTE_PLAYER_LIMIT)
+		return;
+
+	// Stop routing the player as a sender, so the next player who gets this
+	// index won't be muted. Routes of the player as a receiver are kept, since
+	// they might have been set for all future players.
+	for (int i=0; i <= ABSOLUTE_PLAYER_LIMIT; i++)
+	{
+		m_vecMuted[i].Clear((int) uiIndex);
+		m_vecForwarded[i].Clear((int) uiIndex);
+	}
+}
+
+bool CVoiceRouter::SetClientListening(HookType_t eHookType, CHook *pHook)
+{
+	static CVoiceRouter *pRouter = GetVoiceRouter();
+
+	int iReceiver = pHook->GetArgument<int>(1);
+	int iSender = pHook->GetArgument<int>(2);
+	if (iReceiver <= 0 || iReceiver > ABSOLUTE_PLAYER_LIMIT ||
+			iSender <= 0 || iSender > ABSOLUTE_PLAYER_LIMIT) {
+		return false;
+	}
+
+	if (pRouter->m_vecMuted[iReceiver].IsBitSet(iSender)) {
+		pHook->SetArgument<bool>(3, false);
+		return false;
+	}
+
+	// Only forwarded pairs are passed to Python
+	if (!pRouter->m_vecForwarded[iReceiver].IsBitSet(iSender) || !pRouter->m_pListeningHooks->GetCount()) {
+		return false;
+	}
+
+	bool bListen = pHook->GetArgument<bool>(3);
+
+	CListenerManager* mngr = pRouter->m_pListeningHooks;
+	FOREACH_CALLBACK_WITH_MNGR(
+		mngr,
+		object returnValue,
+		if (!returnValue.is_none())
+		{
+			bListen = extract<bool>(returnValue);
+		},
+		iReceiver, iSender, bListen
+	)
+
+	pHook->SetArgument<bool>(3, bListen);
+	return false;
+}
 
 
 //-----------------------------------------------------------------------------
 // Forward declarations.
 //-----------------------------------------------------------------------------
 void export_voice_server(scope);
+void export_voice_router(scope);
 
 
 //-----------------------------------------------------------------------------
@@ -50,6 +332,7 @@ void export_voice_server(scope);
 DECLARE_SP_SUBMODULE(_players, _voice)
 {
 	export_voice_server(_voice);
+	export_voice_router(_voice);
 }
 
 
@@ -73,4 +356,99 @@ void export_voice_server(scope _voice)
 		FUNCTION_INFO(SetClientListening)
 		FUNCTION_INFO(SetClientProximity)
 	END_CLASS_INFO()
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------------------
+// Exports CVoiceRouter.
+//-----------------------------------------------------------------------------
+void export_voice_router(scope _voice)
+{
+	class_<CVoiceRouter, boost::noncopyable> VoiceRouter("VoiceRouter", no_init);
+
+	VoiceRouter.def(
+		"mute",
+		&CVoiceRouter::Mute,
+		"Mute the given senders for the given receivers.\n"
+		"\n"
+		":param senders:\n"
+		"	A player index, an iterable of player indexes or ``None`` for all players.\n"
+		":param receivers:\n"
+		"	A player index, an iterable of player indexes or ``None`` for all players.\n"
+		":raises ValueError:\n"
+		"	If an invalid player index was given.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"unmute",
+		&CVoiceRouter::Unmute,
+		"Unmute the given senders for the given receivers.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"is_muted",
+		&CVoiceRouter::IsMuted,
+		"Return whether all given senders are muted for all given receivers.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"forward",
+		&CVoiceRouter::Forward,
+		"Pass the routing of the given senders to the given receivers to the\n"
+		"listening hooks.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"unforward",
+		&CVoiceRouter::Unforward,
+		"Stop passing the routing of the given senders to the given receivers\n"
+		"to the listening hooks.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"is_forwarded",
+		&CVoiceRouter::IsForwarded,
+		"Return whether all given senders are forwarded for all given receivers.",
+		(arg("self"), arg("senders")=object(), arg("receivers")=object())
+	);
+
+	VoiceRouter.def(
+		"clear",
+		&CVoiceRouter::Clear,
+		"Remove all mutes and forwards."
+	);
+
+	VoiceRouter.def(
+		"register_hook",
+		&CVoiceRouter::RegisterHook,
+		"Registers a listening hook. It is called with the receiver, the\n"
+		"sender and whether the receiver will hear the sender for each\n"
+		"forwarded pair, and may return a new value for the latter.\n"
+		"\n"
+		":param function callback:\n"
+		"	Function to register as a listening hook callback.\n"
+		"\n"
+		":raises ValueError:\n"
+		"	If the given callback is already registered.",
+		args("self", "callback")
+	);
+
+	VoiceRouter.def(
+		"unregister_hook",
+		&CVoiceRouter::UnregisterHook,
+		"Unregisters a listening hook.\n"
+		"\n"
+		":param function callback:\n"
+		"	Function to unregister as a listening hook callback.\n"
+		"\n"
+		":raises ValueError:\n"
+		"	If the given callback was not registered.",
+		args("self", "callback")
+	);
+
+	_voice.attr("voice_router") = object(ptr(GetVoiceRouter()));
+}
@@ -0,0 +1,103 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _PLAYERS_VOICE_H
+#define _PLAYERS_VOICE_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+// Source.Python
+#include "modules/memory/memory_hooks.h"
+#include "modules/listeners/listeners_manager.h"
+
+// SDK
+#include "bitvec.h"
+#include "const.h"
+
+
+//-----------------------------------------------------------------------------
+// Typedefs.
+//-----------------------------------------------------------------------------
+typedef CBitVec<ABSOLUTE_PLAYER_LIMIT + 1> VoiceMask_t;
+
+
+//-----------------------------------------------------------------------------
+// CVoiceRouter class.
+//-----------------------------------------------------------------------------
+class CVoiceRouter
+{
+public:
+	friend CVoiceRouter *GetVoiceRouter();
+
+private:
+	CVoiceRouter();
+	~CVoiceRouter();
+
+public:
+	void Mute(object oSenders, object oReceivers);
+	void Unmute(object oSenders, object oReceivers);
+	bool IsMuted(object oSenders, object oReceivers);
+
+	void Forward(object oSenders, object oReceivers);
+	void Unforward(object oSenders, object oReceivers);
+	bool IsForwarded(object oSenders, object oReceivers);
+
+	void Clear();
+
+	void RegisterHook(object oCallback);
+	void UnregisterHook(object oCallback);
+
+	void OnClientDisconnect(unsigned int uiIndex);
+
+private:
+	void Initialize();
+
+	void SetRoutes(VoiceMask_t *pMatrix, object oSenders, object oReceivers, bool bState);
+	bool TestRoutes(VoiceMask_t *pMatrix, object oSenders, object oReceivers);
+
+	static bool SetClientListening(HookType_t eHookType, CHook *pHook);
+
+private:
+	bool m_bInitialized;
+	CHook *m_pHook;
+
+	// Indexed by receiver, with one bit per sender
+	VoiceMask_t m_vecMuted[ABSOLUTE_PLAYER_LIMIT + 1];
+	VoiceMask_t m_vecForwarded[ABSOLUTE_PLAYER_LIMIT + 1];
+
+	CListenerManager *m_pListeningHooks;
+};
+
+// Singleton accessor.
+inline CVoiceRouter *GetVoiceRouter()
+{
+	static CVoiceRouter *s_pVoiceRouter = new CVoiceRouter;
+	return s_pVoiceRouter;
+}
+
+
+#endif // _PLAYERS_VOICE_H
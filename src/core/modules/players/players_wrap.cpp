@@ -200,6 +200,8 @@ void export_playerinfo(scope _players)
 void export_player_generator(scope _players)
 {
 	class_<CPlayerGenerator>("PlayerGenerator")
+		.def(init<const CPlayerFilter&>())
+
 		.def("__iter__",
 			&CPlayerGenerator::iter,
 			"Returns the iterable object."
@@ -211,6 +213,38 @@ void export_player_generator(scope _players)
 			reference_existing_object_policy()
 		)
 	;
+
+	enum_<EPlayerFilter> _PlayerFilterFlags("PlayerFilterFlags");
+
+	_PlayerFilterFlags.value("ALL", PLAYER_FILTER_ALL);
+	_PlayerFilterFlags.value("BOT", PLAYER_FILTER_BOT);
+	_PlayerFilterFlags.value("HUMAN", PLAYER_FILTER_HUMAN);
+	_PlayerFilterFlags.value("ALIVE", PLAYER_FILTER_ALIVE);
+	_PlayerFilterFlags.value("DEAD", PLAYER_FILTER_DEAD);
+
+	class_<CPlayerFilter>("PlayerFilter",
+		init< optional<unsigned int, unsigned int, unsigned int, unsigned int> >(
+			args("self", "is_flags", "not_flags", "is_teams", "not_teams"),
+			"Filters combining PlayerFilterFlags and team bits (1 << team). "
+			"A player matches if it passes all \"is\" filters and none of the \"not\" filters."
+		)
+	)
+		.def_readwrite("is_flags", &CPlayerFilter::m_uiIsFlags)
+		.def_readwrite("not_flags", &CPlayerFilter::m_uiNotFlags)
+		.def_readwrite("is_teams", &CPlayerFilter::m_uiIsTeams)
+		.def_readwrite("not_teams", &CPlayerFilter::m_uiNotTeams)
+
+		.def("is_match",
+			&CPlayerFilter::IsMatch,
+			"Return whether the given player passes the filters.",
+			args("self", "edict")
+		)
+
+		.def("__len__",
+			&CPlayerFilter::Count,
+			"Return the number of players passing the filters."
+		)
+	;
 }
 
 
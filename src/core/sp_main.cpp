@@ -56,13 +56,20 @@
 #include "tier0/threadtools.h"
 
 #include "manager.h"
+#include "modules/memory/memory_hooks.h"
 
 #include "modules/listeners/listeners_manager.h"
+#include "modules/listeners/listeners_tick.h"
+#include "modules/listeners/listeners_output.h"
+#include "modules/events/events_hooks.h"
 #include "utilities/conversions.h"
+#include "utilities/player_index.h"
 #include "modules/entities/entities.h"
 #include "modules/entities/entities_entity.h"
 #include "modules/entities/entities_collisions.h"
 #include "modules/entities/entities_transmit.h"
+#include "modules/entities/entities_classnames.h"
+#include "modules/players/players_voice.h"
 #include "modules/core/core.h"
 
 #ifdef _WIN32
@@ -118,6 +125,8 @@ extern void ClearAllCommands();
 extern PLUGIN_RESULT DispatchClientCommand(edict_t *pEntity, const CCommand &command);
 extern CConVarChangedListenerManager* GetOnConVarChangedListenerManager();
 extern CServerOutputListenerManager* GetOnServerOutputListenerManager();
+extern COutputBatchListenerManager* GetOnServerOutputBatchListenerManager();
+extern void FlushBinaryCaches();
 
 //-----------------------------------------------------------------------------
 // The plugin is a static singleton that is exported as an interface
@@ -297,14 +306,33 @@ void CSourcePython::Unload( void )
 	DevMsg(1, MSG_PREFIX "Shutting down python...\n");
 	g_PythonManager.Shutdown();
 
+	DevMsg(1, MSG_PREFIX "Flushing binary caches...\n");
+	FlushBinaryCaches();
+
 	DevMsg(1, MSG_PREFIX "Clearing convar changed listener...\n");
 	GetOnConVarChangedListenerManager()->clear();
 
 	DevMsg(1, MSG_PREFIX "Clearing server output listeners...\n");
 	GetOnServerOutputListenerManager()->clear();
 
+	DevMsg(1, MSG_PREFIX "Closing server output capture...\n");
+	GetOnServerOutputBatchListenerManager()->clear();
+	GetServerOutputCapture()->CloseLog();
+
+	DevMsg(1, MSG_PREFIX "Cancelling all scheduled callbacks...\n");
+	GetTickScheduler()->CancelAll();
+
+	DevMsg(1, MSG_PREFIX "Clearing pre-event subscriptions...\n");
+	GetPreEventRouter()->Clear();
+
+	DevMsg(1, MSG_PREFIX "Clearing the classname index...\n");
+	GetEntityClassIndex()->Clear();
+
+	DevMsg(1, MSG_PREFIX "Clearing the player index...\n");
+	GetPlayerIndex()->Clear();
+
 	DevMsg(1, MSG_PREFIX "Unhooking all functions...\n");
-	GetHookManager()->UnhookAllFunctions();
+	UnhookAllFunctions();
 
 	DevMsg(1, MSG_PREFIX "Clearing all commands...\n");
 	ClearAllCommands();
@@ -381,6 +409,17 @@ void CSourcePython::ServerActivate( edict_t *pEdictList, int edictCount, int cli
 void CSourcePython::GameFrame( bool simulating )
 {
 	CALL_LISTENERS(OnTick);
+
+	// Run all delays and repeats that are due.
+	static CTickScheduler *pTickScheduler = GetTickScheduler();
+	pTickScheduler->OnTick();
+
+	// Deliver the server output captured since the last frame.
+	static CServerOutputCapture *pServerOutputCapture = GetServerOutputCapture();
+	pServerOutputCapture->Drain();
+
+	// Write the addresses that have been found since the last frame.
+	FlushBinaryCaches();
 }
 
 //-----------------------------------------------------------------------------
@@ -408,6 +447,9 @@ void CSourcePython::ClientActive( edict_t *pEntity )
 	if (!IndexFromEdict(pEntity, iEntityIndex))
 		return;
 
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Update(pEntity);
+
 	CALL_LISTENERS(OnClientActive, iEntityIndex);
 }
 
@@ -421,6 +463,14 @@ void CSourcePython::ClientDisconnect( edict_t *pEntity )
 		return;
 
 	CALL_LISTENERS(OnClientDisconnect, iEntityIndex);
+
+	// Remove the player from the identity index once all callbacks have been called.
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Remove(iEntityIndex);
+
+	// Unmute the player, so the next player who gets this index won't be muted.
+	static CVoiceRouter *pVoiceRouter = GetVoiceRouter();
+	pVoiceRouter->OnClientDisconnect(iEntityIndex);
 }
 
 //-----------------------------------------------------------------------------
@@ -428,6 +478,9 @@ void CSourcePython::ClientDisconnect( edict_t *pEntity )
 //-----------------------------------------------------------------------------
 void CSourcePython::ClientPutInServer( edict_t *pEntity, char const *playername )
 {
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Update(pEntity, playername);
+
 	CALL_LISTENERS(OnClientPutInServer, ptr(pEntity), playername);
 }
 
@@ -448,6 +501,10 @@ void CSourcePython::ClientSettingsChanged( edict_t *pEdict )
 	if (!IndexFromEdict(pEdict, iEntityIndex))
 		return;
 
+	// Names are changed through the client settings
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Update(pEdict);
+
 	CALL_LISTENERS(OnClientSettingsChanged, iEntityIndex);
 }
 
@@ -458,7 +515,16 @@ PLUGIN_RESULT CSourcePython::ClientConnect( bool *bAllowConnect, edict_t *pEntit
 {
 	CPointer allowConnect = CPointer((unsigned long) bAllowConnect);
 	CPointer rejectMessage = CPointer((unsigned long) reject);
+
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Update(pEntity, pszName);
+
 	CALL_LISTENERS(OnClientConnect, allowConnect, ptr(pEntity), pszName, pszAddress, rejectMessage, maxrejectlen);
+
+	// Rejected clients won't disconnect
+	unsigned int iEntityIndex;
+	if (!*bAllowConnect && IndexFromEdict(pEntity, iEntityIndex))
+		pPlayerIndex->Remove(iEntityIndex);
 	return PLUGIN_OVERRIDE;
 }
 
@@ -467,6 +533,9 @@ PLUGIN_RESULT CSourcePython::ClientConnect( bool *bAllowConnect, edict_t *pEntit
 //-----------------------------------------------------------------------------
 PLUGIN_RESULT CSourcePython::NetworkIDValidated( const char *pszUserName, const char *pszNetworkID )
 {
+	static CPlayerIndex *pPlayerIndex = GetPlayerIndex();
+	pPlayerIndex->Validate(pszUserName);
+
 	CALL_LISTENERS(OnNetworkidValidated, pszUserName, pszNetworkID);
 	return PLUGIN_CONTINUE;
 }
@@ -552,6 +621,9 @@ void CSourcePython::OnEntityCreated( CBaseEntity *pEntity )
 
 	InitHooks(pEntity);
 
+	static CEntityClassIndex *pEntityClassIndex = GetEntityClassIndex();
+	pEntityClassIndex->OnEntityCreated(pEntity);
+
 	CALL_LISTENERS(OnEntityCreated, ptr((CBaseEntityWrapper*) pEntity));
 
 	unsigned int uiIndex;
@@ -572,6 +644,10 @@ void CSourcePython::OnEntityCreated( CBaseEntity *pEntity )
 
 void CSourcePython::OnEntitySpawned( CBaseEntity *pEntity )
 {
+	// The classname is final at this point
+	static CEntityClassIndex *pEntityClassIndex = GetEntityClassIndex();
+	pEntityClassIndex->OnEntitySpawned(pEntity);
+
 	CALL_LISTENERS(OnEntitySpawned, ptr((CBaseEntityWrapper*) pEntity));
 
 	GET_LISTENER_MANAGER(OnNetworkedEntitySpawned, on_networked_entity_spawned_manager);
@@ -588,6 +664,8 @@ void CSourcePython::OnEntitySpawned( CBaseEntity *pEntity )
 
 void CSourcePython::OnEntityDeleted( CBaseEntity *pEntity )
 {
+	static CEntityClassIndex *pEntityClassIndex = GetEntityClassIndex();
+
 	// #455 - Temporarily rebind ourself to our edict if needed.
 	bool bRebound = false;
 	edict_t *pEdict;
@@ -599,8 +677,10 @@ void CSourcePython::OnEntityDeleted( CBaseEntity *pEntity )
 	CALL_LISTENERS(OnEntityDeleted, ptr((CBaseEntityWrapper*) pEntity));
 
 	unsigned int uiIndex;
-	if (!IndexFromBaseEntity(pEntity, uiIndex))
+	if (!IndexFromBaseEntity(pEntity, uiIndex)) {
+		pEntityClassIndex->OnEntityDeleted(pEntity);
 		return;
+	}
 
 	GET_LISTENER_MANAGER(OnNetworkedEntityDeleted, on_networked_entity_deleted_manager);
 	if (on_networked_entity_deleted_manager->GetCount())
@@ -609,10 +689,15 @@ void CSourcePython::OnEntityDeleted( CBaseEntity *pEntity )
 		CALL_LISTENERS_WITH_MNGR(on_networked_entity_deleted_manager, Entity(uiIndex));
 	}
 
-	// Invalidate the internal entity cache once all callbacks have been called.
+	// Cancel the entity's delays and repeats once all callbacks have been called.
 	static object _on_networked_entity_deleted = import("entities").attr("_base").attr("_on_networked_entity_deleted");
 	_on_networked_entity_deleted(uiIndex);
 
+	// Invalidate the internal entity caches. The listeners above can still
+	// find the dying entity, but nothing after them will.
+	CEntityCache::Invalidate(uiIndex);
+	pEntityClassIndex->OnEntityDeleted(pEntity);
+
 	// Cleanup active collision rules.
 	static CCollisionManager *pCollisionManager = GetCollisionManager();
 	pCollisionManager->OnNetworkedEntityDeleted((CBaseEntityWrapper *)pEntity);
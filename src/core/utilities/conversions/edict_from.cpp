@@ -28,6 +28,7 @@
 // Includes.
 //-----------------------------------------------------------------------------
 #include "../conversions.h"
+#include "../player_index.h"
 
 
 //-----------------------------------------------------------------------------
@@ -57,18 +58,19 @@ bool EdictFromIndex( unsigned int iEntityIndex, edict_t*& output )
 //-----------------------------------------------------------------------------
 bool EdictFromUserid( unsigned int iUserID, edict_t*& output )
 {
-	for (int iCurrentIndex = 1; iCurrentIndex <= gpGlobals->maxClients; iCurrentIndex++)
-	{
-		edict_t* pEdict;
-		if (!EdictFromIndex(iCurrentIndex, pEdict))
-			continue;
-
-		if (engine->GetPlayerUserId(pEdict) == iUserID) {
-			output = pEdict;
-			return true;
-		}
-	}
-	return false;
+	unsigned int iEntityIndex;
+	if (!GetPlayerIndex()->FindUserid(iUserID, iEntityIndex))
+		return false;
+
+	edict_t* pEdict;
+	if (!EdictFromIndex(iEntityIndex, pEdict))
+		return false;
+
+	if (engine->GetPlayerUserId(pEdict) != iUserID)
+		return false;
+
+	output = pEdict;
+	return true;
 }
 
 
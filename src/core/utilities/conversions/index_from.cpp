@@ -28,6 +28,7 @@
 // Includes.
 //-----------------------------------------------------------------------------
 #include "../conversions.h"
+#include "../player_index.h"
 
 
 //-----------------------------------------------------------------------------
@@ -58,25 +59,7 @@ bool IndexFromEdict( edict_t *pEdict, unsigned int& output )
 //-----------------------------------------------------------------------------
 bool IndexFromName(const char* szName, unsigned int& output )
 {
-	if (!szName || szName[0] == '\0')
-		return false;
-
-	int iEntityIndex = 0;
-	IPlayerInfo* pInfo = NULL;
-	while(iEntityIndex < gpGlobals->maxClients)
-	{
-		iEntityIndex++;
-		if (!PlayerInfoFromIndex(iEntityIndex, pInfo))
-			continue;
-
-		if (V_strcmp(pInfo->GetName(), szName) == 0)
-		{
-			output = iEntityIndex;
-			return true;
-		}
-	}
-
-	return false;
+	return GetPlayerIndex()->FindName(szName, output);
 }
 
 
@@ -189,46 +172,14 @@ bool IndexFromPlayerInfo( IPlayerInfo *pPlayerInfo, unsigned int& output )
 //-----------------------------------------------------------------------------
 bool IndexFromSteamID( const char* szSteamID, unsigned int& output )
 {
-	IPlayerInfo* pInfo = NULL;
-
-	for (unsigned int i=1; i <= (unsigned int) gpGlobals->maxClients; ++i)
-	{
-		if (!PlayerInfoFromIndex(i, pInfo))
-			continue;
-
-		if (V_strcmp(pInfo->GetNetworkIDString(), szSteamID) == 0)
-		{
-			output = i;
-			return true;
-		}
-	}
-
-	return false;
+	return GetPlayerIndex()->FindSteamID(szSteamID, output);
 }
 
 
 //-----------------------------------------------------------------------------
-// Returns an index instance from the given SteamID.
+// Returns an index instance from the given unique ID.
 //-----------------------------------------------------------------------------
 bool IndexFromUniqueID( const char* szUniqueID, unsigned int& output )
 {
-	for (unsigned int i=1; i <= (unsigned int) gpGlobals->maxClients; ++i)
-	{
-		IPlayerInfo* pInfo = NULL;
-		if (!PlayerInfoFromIndex(i, pInfo))
-			continue;
-		
-		char szTempUniqueID[UNIQUE_ID_SIZE] = "";
-		char* pTempUniqueID = (char*) szTempUniqueID;
-		if (!UniqueIDFromPlayerInfo2(pInfo, pTempUniqueID))
-			continue;
-
-		if (V_strcmp(szUniqueID, pTempUniqueID) == 0)
-		{
-			output = i;
-			return true;
-		}
-	}
-
-	return false;
-}
\ No newline at end of file
+	return GetPlayerIndex()->FindUniqueID(szUniqueID, output);
+}
@@ -0,0 +1,427 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "player_index.h"
+#include "conversions.h"
+
+
+//-----------------------------------------------------------------------------
+// Returns the edict of a player slot. Unlike EdictFromIndex, this also
+// returns the edict of players that are still connecting.
+//-----------------------------------------------------------------------------
+static edict_t* PlayerEdictFromIndex(unsigned int uiIndex)
+{
+	edict_t* pEdict;
+#if defined(ENGINE_ORANGEBOX) || defined(ENGINE_BMS) || defined(ENGINE_GMOD)
+	pEdict = engine->PEntityOfEntIndex(uiIndex);
+#else
+	pEdict = (edict_t *)(gpGlobals->pEdicts + uiIndex);
+#endif
+	if (!pEdict || pEdict->IsFree())
+		return NULL;
+
+	return pEdict;
+}
+
+
+//-----------------------------------------------------------------------------
+// CPlayerIndex.
+//-----------------------------------------------------------------------------
+CPlayerIndex::CPlayerIndex():
+	m_bInitialized(false),
+	m_bDirty(false)
+{
+}
+
+void CPlayerIndex::Update(edict_t* pEdict, const char* szName)
+{
+	// Index the other players first, so the lookups below can't rebuild
+	// the index while this player is being updated
+	EnsureInitialized();
+
+	unsigned int uiIndex;
+	if (!IndexFromEdict(pEdict, uiIndex))
+		return;
+
+	if (uiIndex == WORLD_ENTITY_INDEX || uiIndex > (unsigned int) gpGlobals->maxClients || uiIndex > ABSOLUTE_PLAYER_LIMIT)
+		return;
+
+	// Keep the previous name if there is no better source yet
+	PlayerIdentity_t& player = m_Players[uiIndex];
+	std::string strName = player.m_bConnected ? player.m_strName : std::string();
+
+	Remove(uiIndex);
+
+	int iUserID = engine->GetPlayerUserId(pEdict);
+	if (iUserID == -1)
+		return;
+
+	player.m_bConnected = true;
+	player.m_uiUserID = (unsigned int) iUserID;
+	m_UserIDs[player.m_uiUserID] = uiIndex;
+
+	const char* szSteamID = engine->GetPlayerNetworkIDString(pEdict);
+	if (szSteamID)
+	{
+		player.m_strSteamID = szSteamID;
+		Link(m_SteamIDs, player.m_strSteamID, uiIndex);
+
+		if (ParseAccountID(szSteamID, player.m_uiAccountID))
+			m_AccountIDs[player.m_uiAccountID] = uiIndex;
+	}
+
+	IPlayerInfo* pInfo;
+	if (PlayerInfoFromIndex(uiIndex, pInfo))
+	{
+		player.m_strName = pInfo->GetName();
+
+		// The LAN unique ID resolves the address through the userid, which
+		// has been linked above
+		char szUniqueID[UNIQUE_ID_SIZE] = "";
+		char* pUniqueID = (char*) szUniqueID;
+		if (UniqueIDFromPlayerInfo2(pInfo, pUniqueID))
+			player.m_strUniqueID = szUniqueID;
+	}
+	else if (szName)
+	{
+		player.m_strName = szName;
+	}
+	else
+	{
+		player.m_strName = strName;
+	}
+
+	Link(m_Names, player.m_strName, uiIndex);
+	Link(m_UniqueIDs, player.m_strUniqueID, uiIndex);
+}
+
+void CPlayerIndex::Validate(const char* szName)
+{
+	if (!szName || szName[0] == '\0')
+		return;
+
+	EnsureInitialized();
+
+	// Names aren't unique ("unnamed", "Player"), so refresh every candidate
+	bool bFound = false;
+	unsigned int uiMaxClients = (unsigned int) gpGlobals->maxClients;
+	for (unsigned int i = 1; i <= uiMaxClients && i <= ABSOLUTE_PLAYER_LIMIT; ++i)
+	{
+		IPlayerInfo* pInfo;
+		bool bMatch = m_Players[i].m_bConnected && m_Players[i].m_strName == szName;
+		if (!bMatch && PlayerInfoFromIndex(i, pInfo))
+			bMatch = V_strcmp(pInfo->GetName(), szName) == 0;
+
+		if (!bMatch)
+			continue;
+
+		edict_t* pEdict = PlayerEdictFromIndex(i);
+		if (!pEdict)
+			continue;
+
+		Update(pEdict);
+		bFound = true;
+	}
+
+	// The validated player is unknown, so the next miss has to rescan
+	if (!bFound)
+		m_bDirty = true;
+}
+
+void CPlayerIndex::Remove(unsigned int uiIndex)
+{
+	if (uiIndex > ABSOLUTE_PLAYER_LIMIT)
+		return;
+
+	PlayerIdentity_t& player = m_Players[uiIndex];
+	if (!player.m_bConnected)
+		return;
+
+	boost::unordered_flat_map<unsigned int, unsigned int>::iterator it = m_UserIDs.find(player.m_uiUserID);
+	if (it != m_UserIDs.end() && it->second == uiIndex)
+		m_UserIDs.erase(it);
+
+	it = m_AccountIDs.find(player.m_uiAccountID);
+	if (player.m_uiAccountID && it != m_AccountIDs.end() && it->second == uiIndex)
+		m_AccountIDs.erase(it);
+
+	Unlink(m_SteamIDs, &PlayerIdentity_t::m_strSteamID, uiIndex);
+	Unlink(m_UniqueIDs, &PlayerIdentity_t::m_strUniqueID, uiIndex);
+	Unlink(m_Names, &PlayerIdentity_t::m_strName, uiIndex);
+
+	player = PlayerIdentity_t();
+}
+
+void CPlayerIndex::Clear()
+{
+	for (unsigned int i = 0; i <= ABSOLUTE_PLAYER_LIMIT; ++i)
+		m_Players[i] = PlayerIdentity_t();
+
+	m_UserIDs.clear();
+	m_AccountIDs.clear();
+	m_SteamIDs.clear();
+	m_UniqueIDs.clear();
+	m_Names.clear();
+	m_bInitialized = false;
+	m_bDirty = false;
+}
+
+void CPlayerIndex::EnsureInitialized()
+{
+	if (m_bInitialized)
+		return;
+
+	// Set it first, since resolving unique IDs looks up userids
+	m_bInitialized = true;
+
+	for (unsigned int i = 1; i <= (unsigned int) gpGlobals->maxClients; ++i)
+	{
+		edict_t* pEdict = PlayerEdictFromIndex(i);
+		if (pEdict)
+			Update(pEdict);
+	}
+}
+
+bool CPlayerIndex::Rebuild()
+{
+	if (!m_bDirty)
+		return false;
+
+	m_bDirty = false;
+
+	unsigned int uiMaxClients = (unsigned int) gpGlobals->maxClients;
+	for (unsigned int i = 1; i <= uiMaxClients && i <= ABSOLUTE_PLAYER_LIMIT; ++i)
+	{
+		edict_t* pEdict = PlayerEdictFromIndex(i);
+		if (pEdict)
+			Update(pEdict);
+		else
+			Remove(i);
+	}
+
+	return true;
+}
+
+void CPlayerIndex::Link(StringIndexMap_t& map, const std::string& key, unsigned int uiIndex)
+{
+	if (key.empty())
+		return;
+
+	// Keys shared by multiple players (e.g. "BOT") resolve to the lowest index
+	std::pair<StringIndexMap_t::iterator, bool> result = map.emplace(key, uiIndex);
+	if (!result.second && uiIndex < result.first->second)
+		result.first->second = uiIndex;
+}
+
+void CPlayerIndex::Unlink(StringIndexMap_t& map, StringMember_t pMember, unsigned int uiIndex)
+{
+	const std::string& key = m_Players[uiIndex].*pMember;
+	if (key.empty())
+		return;
+
+	StringIndexMap_t::iterator it = map.find(key);
+	if (it == map.end() || it->second != uiIndex)
+		return;
+
+	// Hand the key over to the next player sharing it
+	unsigned int uiMaxClients = (unsigned int) gpGlobals->maxClients;
+	for (unsigned int i = 1; i <= uiMaxClients && i <= ABSOLUTE_PLAYER_LIMIT; ++i)
+	{
+		if (i != uiIndex && m_Players[i].m_bConnected && m_Players[i].*pMember == key)
+		{
+			it->second = i;
+			return;
+		}
+	}
+
+	map.erase(it);
+}
+
+bool CPlayerIndex::FindUserid(unsigned int uiUserID, unsigned int& output)
+{
+	EnsureInitialized();
+
+	boost::unordered_flat_map<unsigned int, unsigned int>::iterator it = m_UserIDs.find(uiUserID);
+	if (it == m_UserIDs.end())
+		return false;
+
+	output = it->second;
+	return true;
+}
+
+bool CPlayerIndex::FindAccountID(unsigned int uiAccountID, unsigned int& output)
+{
+	return Find(m_AccountIDs, uiAccountID, &HasAccountID, output);
+}
+
+bool CPlayerIndex::FindSteamID(const char* szSteamID, unsigned int& output)
+{
+	if (!szSteamID || szSteamID[0] == '\0')
+		return false;
+
+	if (Find(m_SteamIDs, szSteamID, &HasSteamID, output))
+		return true;
+
+	// Accept any other SteamID representation of the same account
+	unsigned int uiAccountID;
+	if (!ParseAccountID(szSteamID, uiAccountID))
+		return false;
+
+	return FindAccountID(uiAccountID, output);
+}
+
+bool CPlayerIndex::FindUniqueID(const char* szUniqueID, unsigned int& output)
+{
+	if (!szUniqueID || szUniqueID[0] == '\0')
+		return false;
+
+	return Find(m_UniqueIDs, szUniqueID, &HasUniqueID, output);
+}
+
+bool CPlayerIndex::FindName(const char* szName, unsigned int& output)
+{
+	if (!szName || szName[0] == '\0')
+		return false;
+
+	return Find(m_Names, szName, &HasName, output);
+}
+
+template<class Map, class Key>
+bool CPlayerIndex::Find(Map& map, Key key, bool (*IsCurrent)(unsigned int, Key), unsigned int& output)
+{
+	EnsureInitialized();
+
+	// Look up twice at most: once more after refreshing a stale slot or
+	// rebuilding a dirty index
+	for (int iAttempt = 0; iAttempt < 2; ++iAttempt)
+	{
+		typename Map::iterator it = map.find(key);
+		if (it == map.end())
+		{
+			if (!Rebuild())
+				return false;
+
+			continue;
+		}
+
+		unsigned int uiIndex = it->second;
+		if (IsCurrent(uiIndex, key))
+		{
+			output = uiIndex;
+			return true;
+		}
+
+		Refresh(uiIndex);
+	}
+
+	return false;
+}
+
+void CPlayerIndex::Refresh(unsigned int uiIndex)
+{
+	edict_t* pEdict = PlayerEdictFromIndex(uiIndex);
+	if (pEdict)
+		Update(pEdict);
+	else
+		Remove(uiIndex);
+}
+
+bool CPlayerIndex::HasAccountID(unsigned int uiIndex, unsigned int uiAccountID)
+{
+	IPlayerInfo* pInfo;
+	unsigned int uiCurrent;
+	return PlayerInfoFromIndex(uiIndex, pInfo) &&
+		ParseAccountID(pInfo->GetNetworkIDString(), uiCurrent) && uiCurrent == uiAccountID;
+}
+
+bool CPlayerIndex::HasSteamID(unsigned int uiIndex, const char* szSteamID)
+{
+	IPlayerInfo* pInfo;
+	return PlayerInfoFromIndex(uiIndex, pInfo) && V_strcmp(pInfo->GetNetworkIDString(), szSteamID) == 0;
+}
+
+bool CPlayerIndex::HasUniqueID(unsigned int uiIndex, const char* szUniqueID)
+{
+	IPlayerInfo* pInfo;
+	if (!PlayerInfoFromIndex(uiIndex, pInfo))
+		return false;
+
+	char szCurrent[UNIQUE_ID_SIZE] = "";
+	char* pCurrent = (char*) szCurrent;
+	if (!UniqueIDFromPlayerInfo2(pInfo, pCurrent))
+		return false;
+
+	return V_strcmp(szCurrent, szUniqueID) == 0;
+}
+
+bool CPlayerIndex::HasName(unsigned int uiIndex, const char* szName)
+{
+	IPlayerInfo* pInfo;
+	return PlayerInfoFromIndex(uiIndex, pInfo) && V_strcmp(pInfo->GetName(), szName) == 0;
+}
+
+bool CPlayerIndex::ParseAccountID(const char* szSteamID, unsigned int& output)
+{
+	if (!szSteamID)
+		return false;
+
+	unsigned int uiUniverse;
+	unsigned int uiAuthServer;
+	unsigned int uiAccountID;
+
+	// SteamID2
+	if (sscanf(szSteamID, "STEAM_%u:%u:%u", &uiUniverse, &uiAuthServer, &uiAccountID) == 3)
+	{
+		output = uiAccountID << 1 | uiAuthServer;
+		return output != 0;
+	}
+
+	// SteamID3 of an individual account
+	char cAccountType;
+	if (sscanf(szSteamID, "[%c:%u:%u", &cAccountType, &uiUniverse, &uiAccountID) == 3)
+	{
+		if (cAccountType != 'U')
+			return false;
+
+		output = uiAccountID;
+		return output != 0;
+	}
+
+	// SteamID64, which always has the universe and account type bits set
+	char* szEnd;
+	unsigned long long ullSteamID64 = strtoull(szSteamID, &szEnd, 10);
+	if (szEnd == szSteamID || *szEnd != '\0' || ullSteamID64 <= 0xFFFFFFFFULL)
+		return false;
+
+	output = (unsigned int) (ullSteamID64 & 0xFFFFFFFFULL);
+	return output != 0;
+}
@@ -0,0 +1,135 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _PLAYER_INDEX_H
+#define _PLAYER_INDEX_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include <string>
+
+#include "boost/unordered/unordered_flat_map.hpp"
+#include "utilities/string_map.h"
+#include "const.h"
+#include "edict.h"
+
+
+//-----------------------------------------------------------------------------
+// Identity of a connected player.
+//-----------------------------------------------------------------------------
+struct PlayerIdentity_t
+{
+	PlayerIdentity_t():
+		m_bConnected(false),
+		m_uiUserID(0),
+		m_uiAccountID(0)
+	{
+	}
+
+	bool m_bConnected;
+	unsigned int m_uiUserID;
+
+	// 0 if the network ID is not a Steam account (bots, LAN, pending)
+	unsigned int m_uiAccountID;
+
+	std::string m_strSteamID;
+	std::string m_strUniqueID;
+	std::string m_strName;
+};
+
+
+//-----------------------------------------------------------------------------
+// Hashed lookups of player indexes by userid, SteamID, unique ID and name.
+// Updated on connect, validation, settings changes and disconnect, so the
+// IndexFrom* conversions don't have to walk all player slots. Every hit is
+// checked against the live player info and refreshed if it is stale. A miss
+// is trusted, unless a validation could not be matched to a player.
+//-----------------------------------------------------------------------------
+class CPlayerIndex
+{
+public:
+	CPlayerIndex();
+
+	// Refreshes the identity of the given player. The name is used if the
+	// player info is not available yet (e.g. while connecting).
+	void Update(edict_t* pEdict, const char* szName = NULL);
+
+	// Refreshes the players with the given name once a network ID has been
+	// validated.
+	void Validate(const char* szName);
+	void Remove(unsigned int uiIndex);
+	void Clear();
+
+	bool FindUserid(unsigned int uiUserID, unsigned int& output);
+	bool FindAccountID(unsigned int uiAccountID, unsigned int& output);
+	bool FindSteamID(const char* szSteamID, unsigned int& output);
+	bool FindUniqueID(const char* szUniqueID, unsigned int& output);
+	bool FindName(const char* szName, unsigned int& output);
+
+	static bool ParseAccountID(const char* szSteamID, unsigned int& output);
+
+private:
+	typedef StringMap_t<unsigned int> StringIndexMap_t;
+	typedef std::string PlayerIdentity_t::*StringMember_t;
+
+	void EnsureInitialized();
+	bool Rebuild();
+	void Refresh(unsigned int uiIndex);
+
+	template<class Map, class Key>
+	bool Find(Map& map, Key key, bool (*IsCurrent)(unsigned int, Key), unsigned int& output);
+
+	static bool HasAccountID(unsigned int uiIndex, unsigned int uiAccountID);
+	static bool HasSteamID(unsigned int uiIndex, const char* szSteamID);
+	static bool HasUniqueID(unsigned int uiIndex, const char* szUniqueID);
+	static bool HasName(unsigned int uiIndex, const char* szName);
+	void Link(StringIndexMap_t& map, const std::string& key, unsigned int uiIndex);
+	void Unlink(StringIndexMap_t& map, StringMember_t pMember, unsigned int uiIndex);
+
+private:
+	bool m_bInitialized;
+
+	// Set if a player may have changed without the index being updated
+	bool m_bDirty;
+	PlayerIdentity_t m_Players[ABSOLUTE_PLAYER_LIMIT + 1];
+
+	boost::unordered_flat_map<unsigned int, unsigned int> m_UserIDs;
+	boost::unordered_flat_map<unsigned int, unsigned int> m_AccountIDs;
+	StringIndexMap_t m_SteamIDs;
+	StringIndexMap_t m_UniqueIDs;
+	StringIndexMap_t m_Names;
+};
+
+// Singleton accessor.
+inline CPlayerIndex *GetPlayerIndex()
+{
+	static CPlayerIndex *s_pPlayerIndex = new CPlayerIndex;
+	return s_pPlayerIndex;
+}
+
+
+#endif // _PLAYER_INDEX_H
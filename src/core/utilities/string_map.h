@@ -0,0 +1,145 @@
+/**
+* =============================================================================
+* Source Python
+* Copyright (C) 2012-2021 Source Python Development Team.  All rights reserved.
+* =============================================================================
+*
+* This program is free software; you can redistribute it and/or modify it under
+* the terms of the GNU General Public License, version 3.0, as published by the
+* Free Software Foundation.
+*
+* This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+* FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+* details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+* As a special exception, the Source Python Team gives you permission
+* to link the code of this program (as well as its derivative works) to
+* "Half-Life 2," the "Source Engine," and any Game MODs that run on software
+* by the Valve Corporation.  You must obey the GNU General Public License in
+* all respects for all other code used.  Additionally, the Source.Python
+* Development Team grants this exception to all derivative works.
+*/
+
+#ifndef _STRING_MAP_H
+#define _STRING_MAP_H
+
+//-----------------------------------------------------------------------------
+// Includes.
+//-----------------------------------------------------------------------------
+#include <string>
+#include <string.h>
+
+#include "boost/container_hash/hash.hpp"
+#include "boost/unordered/unordered_flat_map.hpp"
+
+
+//-----------------------------------------------------------------------------
+// Hash and equality functors that accept both std::string and const char*,
+// so maps keyed by std::string can be searched without allocating a key.
+//-----------------------------------------------------------------------------
+struct StringMapHash
+{
+	typedef void is_transparent;
+
+	size_t operator()(const char* szKey) const
+	{
+		return boost::hash_range(szKey, szKey + strlen(szKey));
+	}
+
+	size_t operator()(const std::string& key) const
+	{
+		return boost::hash_range(key.data(), key.data() + key.size());
+	}
+};
+
+struct StringMapEqual
+{
+	typedef void is_transparent;
+
+	bool operator()(const std::string& a, const std::string& b) const
+	{
+		return a == b;
+	}
+
+	bool operator()(const std::string& a, const char* b) const
+	{
+		return strcmp(a.c_str(), b) == 0;
+	}
+
+	bool operator()(const char* a, const std::string& b) const
+	{
+		return strcmp(a, b.c_str()) == 0;
+	}
+};
+
+
+//-----------------------------------------------------------------------------
+// Flat hash map that owns its keys and can be searched with a const char*.
+//-----------------------------------------------------------------------------
+template<class T>
+using StringMap_t = boost::unordered_flat_map<std::string, T, StringMapHash, StringMapEqual>;
+
+
+//-----------------------------------------------------------------------------
+// ASCII case-insensitive variants of the functors above. Like V_stricmp,
+// multi-byte characters are compared as they are.
+//-----------------------------------------------------------------------------
+inline unsigned char StringMapFold(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? (unsigned char) (c + ('a' - 'A')) : (unsigned char) c;
+}
+
+struct StringMapCaseHash
+{
+	typedef void is_transparent;
+
+	size_t operator()(const char* szKey) const
+	{
+		size_t seed = 0;
+		for (; *szKey; ++szKey)
+			boost::hash_combine(seed, StringMapFold(*szKey));
+
+		return seed;
+	}
+
+	size_t operator()(const std::string& key) const
+	{
+		return (*this)(key.c_str());
+	}
+};
+
+struct StringMapCaseEqual
+{
+	typedef void is_transparent;
+
+	static bool Compare(const char* a, const char* b)
+	{
+		for (; *a && StringMapFold(*a) == StringMapFold(*b); ++a, ++b);
+		return StringMapFold(*a) == StringMapFold(*b);
+	}
+
+	bool operator()(const std::string& a, const std::string& b) const
+	{
+		return Compare(a.c_str(), b.c_str());
+	}
+
+	bool operator()(const std::string& a, const char* b) const
+	{
+		return Compare(a.c_str(), b);
+	}
+
+	bool operator()(const char* a, const std::string& b) const
+	{
+		return Compare(a, b.c_str());
+	}
+};
+
+template<class T>
+using CaseStringMap_t = boost::unordered_flat_map<std::string, T, StringMapCaseHash, StringMapCaseEqual>;
+
+
+#endif // _STRING_MAP_H